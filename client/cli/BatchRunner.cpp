@@ -0,0 +1,482 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 无界面批量压测工具，从文件或标准输入读取查询，按指定并发执行
+ *              意图解析 -> 搜索 -> 分析 的完整流程，并输出各阶段延迟分布与吞吐量
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+
+#include <nlohmann/json.hpp>
+
+#include "log/Logger.h"
+#include "config/ConfigManager.h"
+#include "core/engine/IntentParser.h"
+#include "core/engine/SearchEngine.h"
+#include "core/api/CircuitBreaker.h"
+#include "core/api/RateLimiter.h"
+
+using namespace IntelliSearch;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 单条查询的执行记录（耗时单位：毫秒）
+struct QueryRecord {
+    std::string query;
+    double intentMs = 0.0;
+    double searchMs = 0.0;
+    double analysisMs = 0.0;
+    double totalMs = 0.0;
+    bool success = false;
+    bool speculativeHit = false;
+    bool cacheHit = false;
+    std::string error;
+};
+
+// 某一阶段的延迟统计
+struct StageStats {
+    size_t count = 0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+double elapsedMs(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/*
+ * Summary: 计算一组耗时样本的统计值
+ * Parameters:
+ *   std::vector<double> samples - 耗时样本（毫秒）
+ * Return: StageStats - 统计结果，样本为空时各字段为 0
+ */
+StageStats computeStats(std::vector<double> samples) {
+    StageStats stats;
+    if (samples.empty()) {
+        return stats;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) {
+        size_t index = static_cast<size_t>(p * static_cast<double>(samples.size() - 1) + 0.5);
+        return samples[std::min(index, samples.size() - 1)];
+    };
+
+    double sum = 0.0;
+    for (double value : samples) {
+        sum += value;
+    }
+
+    stats.count = samples.size();
+    stats.mean = sum / static_cast<double>(samples.size());
+    stats.p50 = percentile(0.50);
+    stats.p90 = percentile(0.90);
+    stats.p99 = percentile(0.99);
+    stats.max = samples.back();
+    return stats;
+}
+
+/*
+ * Summary: 读取查询列表，忽略空行和以 # 开头的注释行
+ * Parameters:
+ *   std::istream& input - 输入流（文件或标准输入）
+ * Return: std::vector<std::string> - 查询列表
+ */
+std::vector<std::string> readQueries(std::istream& input) {
+    std::vector<std::string> queries;
+    std::string line;
+    while (std::getline(input, line)) {
+        // 去除首尾空白（兼容 Windows 换行）
+        size_t begin = line.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos) {
+            continue;
+        }
+        size_t end = line.find_last_not_of(" \t\r\n");
+        line = line.substr(begin, end - begin + 1);
+        if (line[0] == '#') {
+            continue;
+        }
+        queries.push_back(line);
+    }
+    return queries;
+}
+
+/*
+ * Summary: 对单条查询执行完整流程并记录各阶段耗时
+ * Parameters:
+ *   IntentParser& intentParser - 当前工作线程的意图解析器
+ *   const std::string& query - 用户查询
+ *   bool skipAnalysis - 是否跳过 AI 分析阶段
+ * Return: QueryRecord - 执行记录
+ * Description: 与界面走同一条 parseAndSearch 流程（推测搜索、结果缓存、取消均一致），
+ *              各阶段耗时由 SearchTrace 记录
+ */
+QueryRecord runQuery(IntentParser& intentParser, const std::string& query, bool skipAnalysis) {
+    QueryRecord record;
+    record.query = query;
+    auto start = Clock::now();
+
+    try {
+        SearchTrace trace;
+        trace.skipAnalysis = skipAnalysis;
+        auto result = intentParser.parseAndSearch(query, nullptr, nullptr, &trace);
+
+        record.intentMs = trace.intentMs;
+        record.searchMs = trace.searchMs;
+        record.analysisMs = trace.analysisMs;
+        record.speculativeHit = trace.speculativeHit;
+        record.cacheHit = trace.cacheHit;
+
+        const auto& answer = result["search_result"];
+        if (answer.is_null() || (answer.is_object() && answer.contains("error"))) {
+            throw std::runtime_error("Search failed: " + answer.dump());
+        }
+
+        record.success = true;
+    } catch (const std::exception& e) {
+        record.error = e.what();
+        ERRORLOG("Batch query failed: {} - {}", query, e.what());
+    }
+
+    record.totalMs = elapsedMs(start, Clock::now());
+    return record;
+}
+
+void printStatsRow(const std::string& name, const StageStats& stats) {
+    std::cout << std::left << std::setw(10) << name << std::right
+              << std::setw(8) << stats.count
+              << std::setw(11) << stats.mean
+              << std::setw(11) << stats.p50
+              << std::setw(11) << stats.p90
+              << std::setw(11) << stats.p99
+              << std::setw(11) << stats.max << "\n";
+}
+
+nlohmann::json statsToJson(const StageStats& stats) {
+    return {
+        {"count", stats.count},
+        {"mean_ms", stats.mean},
+        {"p50_ms", stats.p50},
+        {"p90_ms", stats.p90},
+        {"p99_ms", stats.p99},
+        {"max_ms", stats.max}
+    };
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("intellisearch_batch");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("IntelliSearch 无界面批量压测工具：意图解析 -> 搜索 -> 分析");
+    parser.addHelpOption();
+    QCommandLineOption inputOption({"i", "input"}, "查询文件路径，每行一条查询；缺省或为 - 时读取标准输入", "file", "-");
+    QCommandLineOption concurrencyOption({"c", "concurrency"}, "并发工作线程数", "n", "1");
+    QCommandLineOption repeatOption({"r", "repeat"}, "整个查询列表重复执行的次数", "n", "1");
+    QCommandLineOption configOption("config", "配置文件路径", "file", "config/config.json");
+    QCommandLineOption logLevelOption("log-level", "覆盖配置文件中的日志级别（trace/debug/info/warn/error）", "level");
+    QCommandLineOption skipAnalysisOption("skip-analysis", "只执行意图解析和搜索，跳过 AI 分析阶段");
+    QCommandLineOption jsonOption("json", "以 JSON 格式输出统计结果");
+    parser.addOptions({inputOption, concurrencyOption, repeatOption, configOption,
+                       logLevelOption, skipAnalysisOption, jsonOption});
+    parser.process(app);
+
+    // 初始化配置管理器和日志
+    try {
+        ConfigManager::getInstance()->init(parser.value(configOption).toStdString());
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to load config: " << e.what() << std::endl;
+        return 1;
+    }
+    INITLOG(ConfigManager::getInstance()->getLogConfig());
+    if (parser.isSet(logLevelOption)) {
+        SETLOGLEVEL(parser.value(logLevelOption).toStdString());
+    }
+    INFOLOG("Batch runner started");
+
+    // 读取查询
+    std::vector<std::string> queries;
+    const std::string inputPath = parser.value(inputOption).toStdString();
+    if (inputPath == "-") {
+        queries = readQueries(std::cin);
+    } else {
+        std::ifstream inputFile(inputPath);
+        if (!inputFile.is_open()) {
+            std::cerr << "Failed to open input file: " << inputPath << std::endl;
+            return 1;
+        }
+        queries = readQueries(inputFile);
+    }
+
+    if (queries.empty()) {
+        std::cerr << "No queries to run" << std::endl;
+        return 1;
+    }
+
+    int concurrency = std::max(1, parser.value(concurrencyOption).toInt());
+    int repeat = std::max(1, parser.value(repeatOption).toInt());
+    bool skipAnalysis = parser.isSet(skipAnalysisOption);
+    size_t totalQueries = queries.size() * static_cast<size_t>(repeat);
+
+    // 预先创建单例，避免计时包含初始化开销
+    try {
+        SearchEngine::getInstance();
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to initialize search engine: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::vector<QueryRecord> records(totalQueries);
+    std::atomic<size_t> nextIndex{0};
+    std::atomic<size_t> finished{0};
+    std::mutex outputMutex;
+
+    auto worker = [&]() {
+        IntentParser intentParser;
+        while (true) {
+            size_t index = nextIndex.fetch_add(1);
+            if (index >= totalQueries) {
+                break;
+            }
+            records[index] = runQuery(intentParser, queries[index % queries.size()], skipAnalysis);
+
+            size_t done = finished.fetch_add(1) + 1;
+            std::lock_guard<std::mutex> lock(outputMutex);
+            std::cerr << "\r[" << done << "/" << totalQueries << "]" << std::flush;
+        }
+    };
+
+    auto wallStart = Clock::now();
+    std::vector<std::thread> workers;
+    workers.reserve(static_cast<size_t>(concurrency));
+    for (int i = 0; i < concurrency; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    double wallMs = elapsedMs(wallStart, Clock::now());
+    std::cerr << std::endl;
+
+    // 汇总统计（只统计成功的查询）
+    std::vector<double> intentSamples, searchSamples, analysisSamples, totalSamples;
+    std::vector<const QueryRecord*> failures;
+    size_t speculativeHits = 0;
+    size_t cacheHits = 0;
+    for (const auto& record : records) {
+        if (record.speculativeHit) {
+            ++speculativeHits;
+        }
+        if (!record.success) {
+            failures.push_back(&record);
+            continue;
+        }
+        intentSamples.push_back(record.intentMs);
+        totalSamples.push_back(record.totalMs);
+        if (record.cacheHit) {
+            // 缓存命中的查询没有搜索与分析阶段
+            ++cacheHits;
+            continue;
+        }
+        searchSamples.push_back(record.searchMs);
+        if (!skipAnalysis) {
+            analysisSamples.push_back(record.analysisMs);
+        }
+    }
+    SearchCacheStats cacheStats = SearchEngine::getInstance()->getCacheStats();
+    IntentCacheStats intentCacheStats = AIServiceManager::getInstance()->getIntentCacheStats();
+    HedgingStats hedgingStats = AIServiceManager::getInstance()->getHedgingStats();
+    auto providerStats = AIServiceManager::getInstance()->getProviderStats();
+    auto rateLimiterStats = RateLimiterRegistry::getInstance()->getAllStats();
+    auto circuitStats = CircuitBreakerRegistry::getInstance()->getAllStats();
+
+    StageStats intentStats = computeStats(intentSamples);
+    StageStats searchStats = computeStats(searchSamples);
+    StageStats analysisStats = computeStats(analysisSamples);
+    StageStats totalStats = computeStats(totalSamples);
+    double wallSeconds = wallMs / 1000.0;
+    double qps = wallSeconds > 0.0 ? static_cast<double>(totalQueries) / wallSeconds : 0.0;
+    double successQps = wallSeconds > 0.0 ? static_cast<double>(totalSamples.size()) / wallSeconds : 0.0;
+
+    if (parser.isSet(jsonOption)) {
+        nlohmann::json summary = {
+            {"queries", totalQueries},
+            {"succeeded", totalSamples.size()},
+            {"failed", failures.size()},
+            {"concurrency", concurrency},
+            {"speculative_hits", speculativeHits},
+            {"cache_hits", cacheHits},
+            {"result_cache", {
+                {"hits", cacheStats.hits},
+                {"stale_hits", cacheStats.staleHits},
+                {"misses", cacheStats.misses},
+                {"evictions", cacheStats.evictions},
+                {"refreshes", cacheStats.refreshes},
+                {"size", cacheStats.size}
+            }},
+            {"intent_cache", {
+                {"lookups", intentCacheStats.lookups},
+                {"exact_hits", intentCacheStats.exactHits},
+                {"near_hits", intentCacheStats.nearHits},
+                {"misses", intentCacheStats.misses},
+                {"collisions", intentCacheStats.collisions},
+                {"saved_latency_ms", intentCacheStats.savedLatencyMs},
+                {"size", intentCacheStats.size}
+            }},
+            {"hedging", {
+                {"calls", hedgingStats.calls},
+                {"hedged", hedgingStats.hedged},
+                {"hedge_rate", hedgingStats.calls > 0 ? static_cast<double>(hedgingStats.hedged) / hedgingStats.calls : 0.0},
+                {"primary_wins", hedgingStats.primaryWins},
+                {"hedge_wins", hedgingStats.hedgeWins},
+                {"cancelled", hedgingStats.cancelled},
+                {"failures", hedgingStats.failures}
+            }},
+            {"providers", [&providerStats]() {
+                nlohmann::json providers = nlohmann::json::object();
+                for (const auto& [name, stats] : providerStats) {
+                    providers[name] = {
+                        {"requests", stats.requests},
+                        {"failures", stats.failures},
+                        {"ewma_latency_ms", stats.latencyMs},
+                        {"error_rate", stats.errorRate}
+                    };
+                }
+                return providers;
+            }()},
+            {"circuit_breakers", [&circuitStats]() {
+                nlohmann::json breakers = nlohmann::json::object();
+                for (const auto& [name, stats] : circuitStats) {
+                    breakers[name] = {
+                        {"state", CircuitBreakerRegistry::stateName(stats.state)},
+                        {"failures", stats.failures},
+                        {"timeouts", stats.timeouts},
+                        {"opened", stats.opened},
+                        {"rejected", stats.rejected},
+                        {"probes", stats.probes},
+                        {"probe_failures", stats.probeFailures}
+                    };
+                }
+                return breakers;
+            }()},
+            {"rate_limiters", [&rateLimiterStats]() {
+                nlohmann::json limiters = nlohmann::json::object();
+                for (const auto& [provider, stats] : rateLimiterStats) {
+                    limiters[provider] = {
+                        {"granted", stats.granted},
+                        {"delayed", stats.delayed},
+                        {"rejected", stats.rejected},
+                        {"timed_out", stats.timedOut},
+                        {"cancelled", stats.cancelled},
+                        {"mean_queue_ms", stats.granted > 0 ? stats.totalQueueMs / stats.granted : 0.0},
+                        {"max_queue_ms", stats.maxQueueMs}
+                    };
+                }
+                return limiters;
+            }()},
+            {"wall_time_ms", wallMs},
+            {"queries_per_second", qps},
+            {"successful_queries_per_second", successQps},
+            {"stages", {
+                {"intent", statsToJson(intentStats)},
+                {"search", statsToJson(searchStats)},
+                {"analysis", statsToJson(analysisStats)},
+                {"total", statsToJson(totalStats)}
+            }}
+        };
+        std::cout << summary.dump(2) << std::endl;
+    } else {
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "Queries: " << totalQueries << "  succeeded: " << totalSamples.size()
+                  << "  failed: " << failures.size() << "  concurrency: " << concurrency
+                  << "  speculative hits: " << speculativeHits << "  cache hits: " << cacheHits << "\n";
+        if (SearchEngine::getInstance()->isCacheEnabled()) {
+            std::cout << "Result cache: hits " << cacheStats.hits << "  stale " << cacheStats.staleHits
+                      << "  misses " << cacheStats.misses << "  evictions " << cacheStats.evictions
+                      << "  size " << cacheStats.size << "\n";
+        }
+        if (intentCacheStats.lookups > 0) {
+            std::cout << "Intent cache: exact " << intentCacheStats.exactHits << "  near "
+                      << intentCacheStats.nearHits << "  misses " << intentCacheStats.misses
+                      << "  collisions " << intentCacheStats.collisions
+                      << "  saved " << intentCacheStats.savedLatencyMs << " ms\n";
+        }
+        if (hedgingStats.calls > 0) {
+            std::cout << "Hedging: " << hedgingStats.hedged << "/" << hedgingStats.calls << " hedged  wins primary "
+                      << hedgingStats.primaryWins << " / hedge " << hedgingStats.hedgeWins
+                      << "  cancelled " << hedgingStats.cancelled << "  failures " << hedgingStats.failures << "\n";
+        }
+        for (const auto& [name, stats] : providerStats) {
+            if (stats.requests == 0) {
+                continue;
+            }
+            std::cout << "Provider " << name << ": requests " << stats.requests << "  failures " << stats.failures
+                      << "  latency " << stats.latencyMs << " ms  error rate " << stats.errorRate << "\n";
+        }
+        for (const auto& [name, stats] : circuitStats) {
+            if (stats.failures == 0 && stats.rejected == 0) {
+                continue;
+            }
+            std::cout << "Circuit " << name << ": " << CircuitBreakerRegistry::stateName(stats.state)
+                      << "  failures " << stats.failures << " (timeouts " << stats.timeouts << ")"
+                      << "  opened " << stats.opened << "  rejected " << stats.rejected
+                      << "  probes " << stats.probes << "\n";
+        }
+        for (const auto& [provider, stats] : rateLimiterStats) {
+            if (stats.granted + stats.rejected + stats.timedOut == 0) {
+                continue;
+            }
+            std::cout << "Rate limiter " << provider << ": granted " << stats.granted
+                      << "  delayed " << stats.delayed << "  rejected " << stats.rejected
+                      << "  timed out " << stats.timedOut
+                      << "  queue mean " << (stats.granted > 0 ? stats.totalQueueMs / stats.granted : 0.0)
+                      << " ms  max " << stats.maxQueueMs << " ms\n";
+        }
+        std::cout << "Wall time: " << wallMs << " ms  throughput: " << std::setprecision(2) << qps
+                  << " queries/s (" << successQps << " successful/s)\n\n" << std::setprecision(1);
+        std::cout << std::left << std::setw(10) << "stage" << std::right
+                  << std::setw(8) << "count"
+                  << std::setw(11) << "mean(ms)"
+                  << std::setw(11) << "p50(ms)"
+                  << std::setw(11) << "p90(ms)"
+                  << std::setw(11) << "p99(ms)"
+                  << std::setw(11) << "max(ms)" << "\n";
+        printStatsRow("intent", intentStats);
+        printStatsRow("search", searchStats);
+        if (!skipAnalysis) {
+            printStatsRow("analysis", analysisStats);
+        }
+        printStatsRow("total", totalStats);
+
+        if (!failures.empty()) {
+            std::cout << "\nFailures:\n";
+            for (const auto* record : failures) {
+                std::cout << "  " << record->query << ": " << record->error << "\n";
+            }
+        }
+    }
+
+    INFOLOG("Batch runner finished: {} queries in {:.1f} ms", totalQueries, wallMs);
+    return failures.empty() ? 0 : 2;
+}
@@ -0,0 +1,171 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: LLM 请求并发基准。多个线程共用同一个 AIService 实例，按不同并发度发出相同的意图解析请求，
+ *              输出吞吐量与重叠度（各请求耗时之和 / 墙钟时间）。请求真正并行时重叠度接近并发度，
+ *              串行化时接近 1。直接调用服务，不经过意图缓存与多服务商路由；配置的 rate_limits 仍然生效
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+
+#include "log/Logger.h"
+#include "config/ConfigManager.h"
+#include "core/api/AIServiceManager.h"
+
+using namespace IntelliSearch;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct LevelResult {
+    int concurrency = 0;
+    size_t succeeded = 0;
+    size_t failed = 0;
+    double wallMs = 0.0;
+    double meanMs = 0.0;
+    double p95Ms = 0.0;
+    double overlap = 0.0;    // 各请求耗时之和 / 墙钟时间
+};
+
+/*
+ * Summary: 以指定并发度发出 requests 个请求
+ * Parameters:
+ *   AIService* service - 被测服务，所有线程共用
+ *   const std::string& query - 请求内容
+ *   size_t requests - 请求总数
+ *   int concurrency - 工作线程数
+ * Return: LevelResult - 该并发度下的统计
+ */
+LevelResult runLevel(AIService* service, const std::string& query, size_t requests, int concurrency) {
+    std::vector<double> latencies;
+    std::mutex latenciesMutex;
+    std::atomic<size_t> nextIndex{0};
+    std::atomic<size_t> failed{0};
+
+    auto start = Clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 0; i < concurrency; ++i) {
+        workers.emplace_back([&]() {
+            while (nextIndex.fetch_add(1) < requests) {
+                auto requestStart = Clock::now();
+                try {
+                    service->parseIntent(query);
+                } catch (const std::exception& e) {
+                    ++failed;
+                    WARNLOG("Benchmark request failed: {}", e.what());
+                    continue;
+                }
+                double ms = std::chrono::duration<double, std::milli>(Clock::now() - requestStart).count();
+                std::lock_guard<std::mutex> lock(latenciesMutex);
+                latencies.push_back(ms);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    LevelResult result;
+    result.concurrency = concurrency;
+    result.wallMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    result.succeeded = latencies.size();
+    result.failed = failed.load();
+    if (!latencies.empty()) {
+        double total = 0.0;
+        for (double ms : latencies) {
+            total += ms;
+        }
+        std::sort(latencies.begin(), latencies.end());
+        result.meanMs = total / latencies.size();
+        result.p95Ms = latencies[std::min(latencies.size() - 1, latencies.size() * 95 / 100)];
+        result.overlap = result.wallMs > 0.0 ? total / result.wallMs : 0.0;
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("intellisearch_llm_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("IntelliSearch LLM 请求并发基准：共用一个服务实例，对比不同并发度下的吞吐量");
+    parser.addHelpOption();
+    QCommandLineOption providerOption({"p", "provider"}, "服务名（如 Kimi、DeepSeek），缺省时使用当前首选服务", "name");
+    QCommandLineOption requestsOption({"n", "requests"}, "每个并发度发出的请求数", "n", "32");
+    QCommandLineOption levelsOption({"c", "concurrency"}, "逗号分隔的并发度列表", "list", "1,2,4,8");
+    QCommandLineOption queryOption({"q", "query"}, "请求内容", "text", "最近有哪些关于检索增强生成的新进展");
+    QCommandLineOption configOption("config", "配置文件路径", "file", "config/config.json");
+    QCommandLineOption logLevelOption("log-level", "覆盖配置文件中的日志级别（trace/debug/info/warn/error）", "level", "warn");
+    parser.addOptions({providerOption, requestsOption, levelsOption, queryOption, configOption, logLevelOption});
+    parser.process(app);
+
+    try {
+        ConfigManager::getInstance()->init(parser.value(configOption).toStdString());
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to load config: " << e.what() << std::endl;
+        return 1;
+    }
+    INITLOG(ConfigManager::getInstance()->getLogConfig());
+    SETLOGLEVEL(parser.value(logLevelOption).toStdString());
+
+    AIService* service = nullptr;
+    try {
+        auto* manager = AIServiceManager::getInstance();
+        service = parser.isSet(providerOption) ? manager->getService(parser.value(providerOption).toStdString())
+                                               : manager->getPreferredService(LlmCallKind::Intent);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to initialize AI services: " << e.what() << std::endl;
+        return 1;
+    }
+    if (!service) {
+        std::cerr << "AI service not found" << std::endl;
+        return 1;
+    }
+
+    std::vector<int> levels;
+    for (const QString& level : parser.value(levelsOption).split(',', Qt::SkipEmptyParts)) {
+        levels.push_back(std::max(1, level.trimmed().toInt()));
+    }
+    size_t requests = std::max(1, parser.value(requestsOption).toInt());
+    std::string query = parser.value(queryOption).toStdString();
+
+    std::cout << "Provider " << service->getServiceName() << ", " << requests << " requests per level\n\n";
+    std::cout << std::left << std::setw(12) << "concurrency" << std::right
+              << std::setw(8) << "ok" << std::setw(8) << "failed"
+              << std::setw(11) << "wall ms" << std::setw(11) << "req/s"
+              << std::setw(11) << "mean ms" << std::setw(11) << "p95 ms"
+              << std::setw(10) << "overlap" << std::setw(10) << "speedup" << "\n";
+
+    double baselineThroughput = 0.0;
+    for (int concurrency : levels) {
+        LevelResult result = runLevel(service, query, requests, concurrency);
+        double throughput = result.wallMs > 0.0 ? result.succeeded * 1000.0 / result.wallMs : 0.0;
+        if (baselineThroughput == 0.0) {
+            baselineThroughput = throughput;
+        }
+        std::cout << std::left << std::setw(12) << result.concurrency << std::right << std::fixed
+                  << std::setw(8) << result.succeeded << std::setw(8) << result.failed
+                  << std::setprecision(0) << std::setw(11) << result.wallMs
+                  << std::setprecision(2) << std::setw(11) << throughput
+                  << std::setprecision(0) << std::setw(11) << result.meanMs << std::setw(11) << result.p95Ms
+                  << std::setprecision(2) << std::setw(10) << result.overlap
+                  << std::setw(9) << (baselineThroughput > 0.0 ? throughput / baselineThroughput : 0.0) << "x\n";
+    }
+    std::cout << "\nRequests sent (including retries): " << service->getRequestCount() << "\n";
+    return 0;
+}
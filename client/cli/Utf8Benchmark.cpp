@@ -0,0 +1,158 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: UTF-8 校验与 Latin-1 转码微基准。对比 AIService 原先的逐字节实现、
+ *              Utf8 标量实现与运行时选择的 SIMD 实现，输入覆盖纯 ASCII、中英混排与 Latin-1 文本
+ *              用法：intellisearch_utf8_bench [输入大小(KB)，默认 256] [迭代次数，默认 200]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/utils/Utf8.h"
+
+using namespace IntelliSearch;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 原 AIService::is_valid_utf8 的逐字节实现，作为基准对照
+bool legacyIsValidUtf8(const std::string& str) {
+    const unsigned char* bytes = (const unsigned char*)str.c_str();
+    size_t len = str.length();
+
+    for (size_t i = 0; i < len; i++) {
+        if (bytes[i] <= 0x7F) {
+            continue;
+        } else if (bytes[i] >= 0xC2 && bytes[i] <= 0xDF) {
+            if (i + 1 >= len || (bytes[i + 1] & 0xC0) != 0x80) return false;
+            i += 1;
+        } else if (bytes[i] >= 0xE0 && bytes[i] <= 0xEF) {
+            if (i + 2 >= len || (bytes[i + 1] & 0xC0) != 0x80 ||
+                (bytes[i + 2] & 0xC0) != 0x80) return false;
+            i += 2;
+        } else if (bytes[i] >= 0xF0 && bytes[i] <= 0xF4) {
+            if (i + 3 >= len || (bytes[i + 1] & 0xC0) != 0x80 ||
+                (bytes[i + 2] & 0xC0) != 0x80 ||
+                (bytes[i + 3] & 0xC0) != 0x80) return false;
+            i += 3;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 原 AIService::utf8_encode 的逐字符追加实现
+std::string legacyLatin1ToUtf8(const std::string& str) {
+    std::string result;
+    result.reserve(str.length());
+    for (unsigned char c : str) {
+        if (c < 0x80) {
+            result += c;
+        } else {
+            result += (0xC0 | (c >> 6));
+            result += (0x80 | (c & 0x3F));
+        }
+    }
+    return result;
+}
+
+// 按给定片段随机拼接出约 size 字节的文本
+std::string buildInput(const std::vector<std::string>& pieces, size_t size, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::string text;
+    text.reserve(size + 16);
+    while (text.size() < size) {
+        text += pieces[rng() % pieces.size()];
+    }
+    return text;
+}
+
+// 运行 iterations 次并返回吞吐量（GB/s）
+double measure(const std::function<size_t()>& body, size_t bytesPerIteration, int iterations) {
+    volatile size_t sink = 0;
+    body();  // 预热
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        sink = sink + body();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return static_cast<double>(bytesPerIteration) * iterations / seconds / 1e9;
+}
+
+void printRow(const std::string& name, double legacy, double scalar, double simd) {
+    std::cout << std::left << std::setw(26) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << legacy
+              << std::setw(10) << scalar
+              << std::setw(10) << simd
+              << std::setw(9) << simd / legacy << "x\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t sizeKb = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 256;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 200;
+    size_t size = (sizeKb == 0 ? 256 : sizeKb) * 1024;
+    if (iterations <= 0) {
+        iterations = 200;
+    }
+
+    struct Dataset {
+        std::string name;
+        std::string text;
+    };
+    std::vector<Dataset> datasets = {
+        {"ascii", buildInput({"The quick brown fox ", "jumps over ", "the lazy dog. ", "{\"key\": 42}, "}, size, 1)},
+        {"mixed zh/en", buildInput({"检索增强生成", "RAG ", "技术架构的最新发展，", "LLM ", "向量数据库 "}, size, 2)},
+        {"chinese", buildInput({"意图解析", "搜索结果", "大语言模型", "全文检索。"}, size, 3)},
+        {"emoji", buildInput({"😀", "🚀 ", "ok ", "中文"}, size, 4)}
+    };
+
+    std::cout << "UTF-8 implementation: " << Utf8::activeImplementation()
+              << ", input " << size / 1024 << " KB, " << iterations << " iterations\n\n";
+    std::cout << std::left << std::setw(26) << "validate (GB/s)" << std::right
+              << std::setw(10) << "legacy" << std::setw(10) << "scalar" << std::setw(10) << "simd"
+              << std::setw(10) << "speedup" << "\n";
+
+    for (const auto& dataset : datasets) {
+        const std::string& text = dataset.text;
+        if (legacyIsValidUtf8(text) != Utf8::isValid(text) || Utf8::isValidScalar(text.data(), text.size()) != Utf8::isValid(text)) {
+            std::cerr << "Implementations disagree on dataset " << dataset.name << "\n";
+            return 1;
+        }
+        double legacy = measure([&]() { return static_cast<size_t>(legacyIsValidUtf8(text)); }, text.size(), iterations);
+        double scalar = measure([&]() { return static_cast<size_t>(Utf8::isValidScalar(text.data(), text.size())); },
+                                text.size(), iterations);
+        double simd = measure([&]() { return static_cast<size_t>(Utf8::isValid(text)); }, text.size(), iterations);
+        printRow(dataset.name, legacy, scalar, simd);
+    }
+
+    std::cout << "\n" << std::left << std::setw(26) << "latin1 -> utf8 (GB/s)" << std::right
+              << std::setw(10) << "legacy" << std::setw(10) << "scalar" << std::setw(10) << "simd"
+              << std::setw(10) << "speedup" << "\n";
+
+    std::string latinAscii = datasets[0].text;
+    std::string latinAccented = buildInput({"caf\xE9 ", "na\xEFve ", "r\xE9sum\xE9 ", "plain text "}, size, 5);
+    for (const auto& [name, text] : std::vector<std::pair<std::string, std::string>>{
+             {"latin1 ascii", latinAscii}, {"latin1 accented", latinAccented}}) {
+        if (legacyLatin1ToUtf8(text) != Utf8::latin1ToUtf8(text)) {
+            std::cerr << "Transcoders disagree on dataset " << name << "\n";
+            return 1;
+        }
+        double legacy = measure([&]() { return legacyLatin1ToUtf8(text).size(); }, text.size(), iterations);
+        double scalar = measure([&]() { return Utf8::latin1ToUtf8Scalar(text).size(); }, text.size(), iterations);
+        double simd = measure([&]() { return Utf8::latin1ToUtf8(text).size(); }, text.size(), iterations);
+        printRow(name, legacy, scalar, simd);
+    }
+    return 0;
+}
@@ -11,6 +11,8 @@ Rectangle {
     property var searchBridge
     property StackView stackView
     property string currentSessionId: ""
+    property string nextCursor: ""    // 下一页会话的游标，为空表示已全部加载
+    property int pageSize: 30
 
     // 信号定义
     signal sessionSelected(string sessionId)
@@ -37,21 +39,33 @@ Rectangle {
 
         // 使用正确的信号连接语法
         onSessionHistoryChanged: {
-            loadSessionHistory();
+            reloadTimer.restart();
         }
 
         onSessionCreated: function (sessionId) {
             // 当创建新会话时，更新当前会话ID
             currentSessionId = sessionId;
-            loadSessionHistory();
+            reloadTimer.restart();
         }
 
         onSessionUpdated: function (sessionId) {
             // 当会话更新时，刷新会话历史
-            loadSessionHistory();
+            reloadTimer.restart();
+        }
+
+        onHistoryLoadFailed: function (errorMessage) {
+            // 记录已损坏，不显示为空白的答案
+            console.error("Failed to load history record: " + errorMessage);
         }
     }
 
+    // 一次写入会连续发出多个信号，合并为一次刷新
+    Timer {
+        id: reloadTimer
+        interval: 50
+        onTriggered: loadSessionHistory()
+    }
+
     // 加载会话历史数据
     function loadSessionHistory() {
         // 检查searchBridge是否存在
@@ -60,11 +74,24 @@ Rectangle {
             return;
         }
 
-        // 清空现有模型
+        // 清空现有模型，重新加载第一页
         sessionModel.clear();
+        nextCursor = "";
+        appendSessionPage("");
+    }
+
+    // 滚动到底部时加载下一页
+    function loadMoreSessions() {
+        if (searchBridge && nextCursor !== "") {
+            appendSessionPage(nextCursor);
+        }
+    }
+
+    function appendSessionPage(cursor) {
         try {
-            // 获取会话历史数据
-            var sessions = searchBridge.getSessionsList(100);
+            // 获取一页会话历史数据
+            var page = searchBridge.getSessionsPage(cursor, pageSize);
+            var sessions = page.items;
 
             // 将数据添加到模型中
             for (var i = 0; i < sessions.length; i++) {
@@ -76,6 +103,7 @@ Rectangle {
                     lastQuery: sessions[i].last_query || ""
                 });
             }
+            nextCursor = page.nextCursor;
         } catch (e) {
             console.error("Error loading session history:", e);
         }
@@ -129,6 +157,12 @@ Rectangle {
             clip: true
             model: sessionModel
 
+            onAtYEndChanged: {
+                if (atYEnd && count > 0) {
+                    historyRecord.loadMoreSessions();
+                }
+            }
+
             // 当没有会话时显示的提示
             Rectangle {
                 anchors.fill: parent
@@ -25,6 +25,12 @@ Rectangle {
     property string initialMessage: ""
     property bool isSearching: searchBridge ? searchBridge.isSearching : false
     property string currentSessionId: ""
+    // 本页发起、尚未完成的搜索：请求 ID -> 回复在 chatModel 中的索引
+    property var pendingReplies: ({})
+    // 更早一页对话的游标，为空表示已加载到第一轮
+    property string olderCursor: ""
+    property bool loadingOlder: false
+    property int dialoguePageSize: 20
     
     ListModel {
         id: chatModel
@@ -39,20 +45,61 @@ Rectangle {
             console.log("收到初始消息:", initialMessage)
             addMessage(initialMessage, true)
             // 发送初始消息到后端处理
-            searchBridge.handleSearch(initialMessage)
+            submitSearch(initialMessage)
         }
         
-        // 连接搜索结果信号
-        searchBridge.searchResultsReady.connect(function(results) {
-            console.log("收到搜索结果:", results)
+        // 连接流式答案信号，先展示已生成的部分答案
+        searchBridge.searchPartialResult.connect(function(requestId, sessionId, text) {
+            var index = pendingReplies[requestId]
+            if (index === undefined) return
+            chatModel.setProperty(index, "messageText", text)
+            chatListView.positionViewAtEnd()
+        })
+
+        // 连接搜索结果信号，按请求 ID 写回对应的回复
+        searchBridge.searchResultsReady.connect(function(requestId, sessionId, results) {
+            var index = pendingReplies[requestId]
+            if (index === undefined) return
+            delete pendingReplies[requestId]
+            console.log("收到搜索结果:", requestId, results)
+            var text
             try {
                 var jsonResult = JSON.parse(results)
-                addMessage(JSON.stringify(jsonResult, null, 2), false)
+                text = JSON.stringify(jsonResult, null, 2)
             } catch (e) {
                 console.error("解析搜索结果出错:", e)
-                addMessage("抱歉，处理您的请求时出现错误。", false)
+                text = "抱歉，处理您的请求时出现错误。"
+            }
+            // 用最终结果替换占位或流式输出的部分答案
+            if (index < chatModel.count) {
+                chatModel.setProperty(index, "messageText", text)
+                chatListView.positionViewAtEnd()
             }
         })
+
+        // 被新查询取代或离开会话而取消的搜索
+        searchBridge.searchCancelled.connect(function(requestId, sessionId) {
+            var index = pendingReplies[requestId]
+            if (index === undefined) return
+            delete pendingReplies[requestId]
+            if (index < chatModel.count) {
+                chatModel.setProperty(index, "messageText", "已取消")
+            }
+        })
+    }
+
+    // 离开页面时取消本页发起、尚未完成的搜索
+    Component.onDestruction: {
+        for (var requestId in pendingReplies) {
+            searchBridge.cancelSearch(requestId)
+        }
+    }
+
+    // 发起搜索并为其预留回复位置，多个搜索同时进行时结果各自写回
+    function submitSearch(text) {
+        var requestId = searchBridge.handleSearch(text)
+        addMessage("正在搜索…", false)
+        pendingReplies[requestId] = chatModel.count - 1
     }
     
     // 加载会话历史记录
@@ -61,27 +108,20 @@ Rectangle {
         
         // 清空现有消息
         chatModel.clear()
+        pendingReplies = {}
+        olderCursor = ""
         
         try {
-            // 获取当前会话的对话历史
-            var dialogues = searchBridge.getSessionDialogues(currentSessionId)
-            console.log("加载历史记录:", dialogues.length, "条消息")
+            // 只获取当前会话最新的一页对话，更早的在滚动到顶部时加载
+            var page = searchBridge.getSessionDialoguesPage(currentSessionId, "", dialoguePageSize)
+            console.log("加载历史记录:", page.items.length, "条消息")
             
             // 将历史记录添加到聊天模型中
-            for (var i = 0; i < dialogues.length; i++) {
-                var dialogue = dialogues[i]
-                // 添加用户消息
-                addMessage(dialogue.user_query, true)
-                // 添加系统回复
-                if (dialogue.search_result) {
-                    try {
-                        var jsonResult = JSON.parse(dialogue.search_result)
-                        addMessage(JSON.stringify(jsonResult, null, 2), false)
-                    } catch (e) {
-                        addMessage(dialogue.search_result, false)
-                    }
-                }
+            var messages = dialogueMessages(page.items)
+            for (var i = 0; i < messages.length; i++) {
+                chatModel.append(messages[i])
             }
+            olderCursor = page.nextCursor
             
             // 滚动到底部
             chatListView.positionViewAtEnd()
@@ -89,6 +129,48 @@ Rectangle {
             console.error("加载历史记录失败:", e)
         }
     }
+
+    // 在顶部插入更早的一页对话，保持当前可见的消息不动
+    function loadOlderDialogues() {
+        if (!searchBridge || olderCursor === "" || loadingOlder) return;
+
+        loadingOlder = true
+        try {
+            var page = searchBridge.getSessionDialoguesPage(currentSessionId, olderCursor, dialoguePageSize)
+            var messages = dialogueMessages(page.items)
+            for (var i = 0; i < messages.length; i++) {
+                chatModel.insert(i, messages[i])
+            }
+            // 进行中的搜索的回复位置随之后移
+            for (var requestId in pendingReplies) {
+                pendingReplies[requestId] += messages.length
+            }
+            olderCursor = page.nextCursor
+            chatListView.positionViewAtIndex(messages.length, ListView.Beginning)
+        } catch (e) {
+            console.error("加载更早的历史记录失败:", e)
+        }
+        loadingOlder = false
+    }
+
+    // 把对话记录转换为聊天消息：用户查询及其系统回复
+    function dialogueMessages(dialogues) {
+        var messages = []
+        for (var i = 0; i < dialogues.length; i++) {
+            var dialogue = dialogues[i]
+            messages.push({ "messageText": dialogue.user_query, "isUserMessage": true })
+            if (dialogue.search_result) {
+                var text
+                try {
+                    text = JSON.stringify(JSON.parse(dialogue.search_result), null, 2)
+                } catch (e) {
+                    text = dialogue.search_result
+                }
+                messages.push({ "messageText": text, "isUserMessage": false })
+            }
+        }
+        return messages
+    }
     
     // 添加消息到聊天记录的函数
     function addMessage(text, isUserMessage) {
@@ -139,14 +221,24 @@ Rectangle {
                             width: parent.width
                             sourceComponent: model.isUserMessage ? userMessageComponent : botMessageComponent
                             onLoaded: {
-                                item.messageText = model.messageText
+                                // 绑定到模型，流式更新 messageText 时气泡内容同步刷新
+                                item.messageText = Qt.binding(function() { return model.messageText })
                                 item.maxBubbleWidth = chatListView.width * 0.7
                             }
                         }
                     }
                     
                     onCountChanged: {
-                        positionViewAtEnd()
+                        // 在顶部插入更早的消息时不跳到底部
+                        if (!loadingOlder) {
+                            positionViewAtEnd()
+                        }
+                    }
+
+                    onAtYBeginningChanged: {
+                        if (atYBeginning && count > 0) {
+                            loadOlderDialogues()
+                        }
                     }
                 }
             }
@@ -162,7 +254,7 @@ Rectangle {
                 onTextSubmitted: function(text) {
                     console.log("发送消息:", text)
                     addMessage(text, true)
-                    searchBridge.handleSearch(text)
+                    submitSearch(text)
                 }
             }
         }
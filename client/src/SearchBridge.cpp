@@ -1,18 +1,22 @@
 /*
  * Author: Montee
  * CreateDate: 2025-01-30
- * UpdateDate: 2025-02-09
- * UpdateReason: 新增删除搜索历史记录功能
+ * UpdateDate: 2026-10-17
+ * UpdateReason: 对话记录交由后台写入线程攒批提交，不再在主线程同步写库
  * Description: 搜索桥接类的实现，用于处理搜索请求和管理搜索历史
  */
 
 #include "SearchBridge.h"
 #include "../../log/Logger.h"
+#include "../../config/ConfigManager.h"
 #include <QDebug>
 #include <QFuture>
 #include <QFutureWatcher>
 #include <QtConcurrent>
+#include <QUuid>
 #include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
 
 namespace IntelliSearch
 {
@@ -24,7 +28,7 @@ namespace IntelliSearch
      * Description: 初始化搜索桥接类，设置数据库管理器和异步搜索完成的信号处理
      */
     SearchBridge::SearchBridge(QObject *parent)
-        : QObject(parent), intentParser(std::make_unique<IntentParser>()), dbManager(DatabaseManagerFactory::createDatabaseManager()), crawlerManager(std::make_unique<CrawlerManager>()), currentTurnNumber(0)
+        : QObject(parent), intentParser(std::make_unique<IntentParser>()), dbManager(DatabaseManagerFactory::createDatabaseManager()), crawlerManager(std::make_unique<CrawlerManager>())
     {
         if (!dbManager)
         {
@@ -38,8 +42,10 @@ namespace IntelliSearch
             throw std::runtime_error("Database initialization failed");
         }
 
-        connect(&searchWatcher, &QFutureWatcher<QString>::finished,
-                this, &SearchBridge::handleSearchComplete);
+        historyWriter = std::make_unique<HistoryWriter>(HistoryWriter::optionsFromConfig());
+
+        cancelSuperseded = ConfigManager::getInstance()->getSectionConfig("search_settings")
+                               .value("cancel_superseded", true);
 
         // 连接爬虫管理器信号
         connect(crawlerManager.get(), &CrawlerManager::crawlingCompleted,
@@ -52,19 +58,36 @@ namespace IntelliSearch
         INFOLOG("SearchBridge initialization completed");
     }
 
-    SearchBridge::~SearchBridge() = default;
+    /*
+     * Summary: SearchBridge类析构函数
+     * Description: 后台搜索任务引用 intentParser，先取消再等待全部结束后释放；
+     *              随后写入线程写完排队中的对话记录再退出
+     */
+    SearchBridge::~SearchBridge()
+    {
+        for (auto &pending : pendingSearches)
+        {
+            pending.cancellation->cancel();
+        }
+        for (auto &pending : pendingSearches)
+        {
+            pending.watcher->disconnect(this);
+            pending.watcher->waitForFinished();
+        }
+        historyWriter.reset();
+    }
 
     /*
      * Summary: 处理搜索请求
      * Parameters:
      *   const QString& query - 搜索查询字符串
-     * Return: void
-     * Description: 异步处理搜索请求，解析搜索意图并返回结果
+     * Return: QString - 请求 ID，结果信号据此区分不同的搜索
+     * Description: 异步处理搜索请求，解析搜索意图并返回结果。发起时即确定所属会话与轮次，
+     *              多个搜索可同时进行，期间切换会话不影响已发起搜索的归属
      */
-    void SearchBridge::handleSearch(const QString &query)
+    QString SearchBridge::handleSearch(const QString &query)
     {
         INFOLOG("Received search request: {}", query.toStdString());
-        lastQuery = query;
 
         // 如果没有活动会话，创建新会话
         if (currentSessionId.isEmpty())
@@ -77,88 +100,210 @@ namespace IntelliSearch
             }
         }
 
+        // 新查询取代同一会话中尚未完成的搜索，释放其占用的线程与配额
+        if (cancelSuperseded && !currentSessionId.isEmpty())
+        {
+            cancelSessionSearches(currentSessionId);
+        }
+
+        QString requestId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        PendingSearch pending;
+        pending.sessionId = currentSessionId;
+        pending.query = query;
+        pending.turnNumber = currentSessionId.isEmpty() ? 0 : reserveTurnNumber(currentSessionId);
+        pending.watcher = new QFutureWatcher<QString>(this);
+        pending.cancellation = std::make_shared<CancellationToken>();
+        connect(pending.watcher, &QFutureWatcher<QString>::finished,
+                this, [this, requestId]()
+                { handleSearchComplete(requestId); });
+
+        QString sessionId = pending.sessionId;
+        QFutureWatcher<QString> *watcher = pending.watcher;
+        std::shared_ptr<CancellationToken> cancellation = pending.cancellation;
+        pendingSearches.insert(requestId, pending);
+        DEBUGLOG("Search {} started in session {}, turn {}, {} in flight",
+                 requestId.toStdString(), sessionId.toStdString(), pending.turnNumber, pendingSearches.size());
+
+        emit searchStarted(requestId, sessionId, query);
         emit searchingChanged();
-        QFuture<QString> future = QtConcurrent::run([this, query]()
+        QFuture<QString> future = QtConcurrent::run([this, query, requestId, sessionId, cancellation]()
                                                     {
         try {
             DEBUGLOG("Starting async search for query: {}", query.toStdString());
             
             std::string stdQuery = query.toStdString();
-            auto intentParserResult = intentParser->parseSearchIntent(stdQuery);
-            auto searchResult = intentParser->search(intentParserResult["query"]);
-
-            // 合并意图解析结果和搜索结果
-            nlohmann::json combinedResult;
-            combinedResult["intent_parser"] = intentParserResult;
-            combinedResult["search_result"] = searchResult;
 
-            // 将结果转换为 JSON 字符串
-            QString jsonString = QString::fromStdString(combinedResult.dump());
-            
-            // 只有在搜索成功时才保存对话记录
-            if (!searchResult.empty() && !currentSessionId.isEmpty()) {
-                // 增加对话轮次
-                currentTurnNumber++;
-                
-                // 保存对话记录
-                if (!dbManager->addDialogueRecord(
-                    currentSessionId,
-                    lastQuery,
-                    intentParserResult.contains("intent") ? intentParserResult["intent"].get<std::string>() : "",
-                    intentParserResult.contains("query") ? QString::fromStdString(intentParserResult["query"].get<std::string>()) : lastQuery,
-                    QString::fromStdString(searchResult.dump()),
-                    currentTurnNumber
-                )) {
-                    WARNLOG("Failed to save dialogue record");
-                } else {
-                    emit sessionUpdated(currentSessionId);
-                    emit sessionHistoryChanged();
-                }
+            // 开启流式答案时累计增量文本，并按约 50ms 的间隔节流推送给界面
+            StreamCallback onPartial;
+            if (intentParser->isStreamAnswerEnabled()) {
+                auto partialText = std::make_shared<QString>();
+                auto lastEmit = std::make_shared<std::chrono::steady_clock::time_point>();
+                onPartial = [this, partialText, lastEmit, requestId, sessionId, cancellation](const std::string& delta) {
+                    if (cancellation->isCancelled()) {
+                        return;
+                    }
+                    partialText->append(QString::fromStdString(delta));
+                    auto now = std::chrono::steady_clock::now();
+                    if (now - *lastEmit >= std::chrono::milliseconds(50)) {
+                        *lastEmit = now;
+                        emit searchPartialResult(requestId, sessionId, *partialText);
+                    }
+                };
             }
-            
+
+            // 意图解析 + 搜索（开启推测搜索时两者并行），返回合并后的结果
+            nlohmann::json combinedResult = intentParser->parseAndSearch(stdQuery, onPartial, cancellation);
+
             DEBUGLOG("Search completed successfully");
-            return jsonString;
+            return QString::fromStdString(combinedResult.dump());
             
+        } catch (const RequestCancelled& e) {
+            DEBUGLOG("Search cancelled for query {}: {}", query.toStdString(), e.what());
+            return QString::fromStdString(nlohmann::json{{"cancelled", true}}.dump());
         } catch (const std::exception& e) {
             ERRORLOG("Search failed: {}", e.what());
-            return QString("{\"error\":\"%1\"}").arg(e.what());
+            return QString::fromStdString(nlohmann::json{{"error", e.what()}}.dump());
         } });
 
-        searchWatcher.setFuture(future);
+        watcher->setFuture(future);
+        return requestId;
     }
 
     /*
      * Summary: 处理搜索完成事件
-     * Parameters: 无
+     * Parameters:
+     *   const QString& requestId - 完成的请求 ID
      * Return: void
-     * Description: 处理搜索完成事件，保存搜索记录到数据库并发出信号
+     * Description: 在主线程中发出结果信号，并按发起时确定的会话与轮次把对话记录交给写入线程；
+     *              记录提交后再发出 sessionUpdated 与 sessionHistoryChanged
      */
-    void SearchBridge::handleSearchComplete()
+    void SearchBridge::handleSearchComplete(const QString &requestId)
     {
+        auto it = pendingSearches.find(requestId);
+        if (it == pendingSearches.end())
+        {
+            WARNLOG("Completion for unknown search request: {}", requestId.toStdString());
+            return;
+        }
+        PendingSearch pending = it.value();
+        pendingSearches.erase(it);
+        pending.watcher->deleteLater();
         emit searchingChanged();
+
+        // 被取消的搜索即使已拿到结果也不再保存与展示
+        if (pending.cancellation->isCancelled())
+        {
+            INFOLOG("Search {} cancelled", requestId.toStdString());
+            emit searchCancelled(requestId, pending.sessionId);
+            return;
+        }
+
         try
         {
-            QString result = searchWatcher.result();
+            QString result = pending.watcher->result();
             auto jsonResult = nlohmann::json::parse(result.toStdString());
             DEBUGLOG("Search results parsed: {}", jsonResult.dump().c_str());
 
+            if (jsonResult.contains("error"))
+            {
+                emit searchResultsReady(requestId, pending.sessionId, result);
+                return;
+            }
+
             // 获取意图解析结果和搜索结果
-            auto intentResult = jsonResult["intent_parser"];
-            auto searchResult = jsonResult["search_result"];
+            const auto &intentParserResult = jsonResult["intent_parser"];
+            const auto &searchResult = jsonResult["search_result"];
 
             // 直接发送搜索结果
-            emit searchResultsReady(QString::fromStdString(searchResult.dump()));
+            QString searchResultText = QString::fromStdString(searchResult.dump());
+            emit searchResultsReady(requestId, pending.sessionId, searchResultText);
+
+            // 只有在搜索成功时才保存对话记录；写入线程提交后再通知会话更新
+            if (!searchResult.empty() && !pending.sessionId.isEmpty())
+            {
+                DialogueRecord record;
+                record.sessionId = pending.sessionId;
+                record.userQuery = pending.query;
+                record.intentType = intentParserResult.contains("intent") ? QString::fromStdString(intentParserResult["intent"].get<std::string>()) : QString();
+                record.intentResult = intentParserResult.contains("query") ? QString::fromStdString(intentParserResult["query"].get<std::string>()) : pending.query;
+                record.searchResult = searchResultText;
+                record.turnNumber = pending.turnNumber;
+
+                // 回调在写入线程中执行，转回主线程发出信号
+                QString sessionId = pending.sessionId;
+                historyWriter->enqueue(std::move(record), [this, sessionId](bool success)
+                                       { QMetaObject::invokeMethod(this, [this, sessionId, success]()
+                                                                   {
+                    if (!success) {
+                        WARNLOG("Failed to save dialogue record");
+                        return;
+                    }
+                    emit sessionUpdated(sessionId);
+                    emit sessionHistoryChanged(); }, Qt::QueuedConnection); });
+                return;
+            }
         }
         catch (const std::exception &e)
         {
             ERRORLOG("Error processing search results: {}", e.what());
-            emit searchResultsReady(QString("{\"error\":\"搜索出错: %1\"}").arg(e.what()));
+            emit searchResultsReady(requestId, pending.sessionId,
+                                    QString::fromStdString(nlohmann::json{{"error", std::string("搜索出错: ") + e.what()}}.dump()));
         }
 
         // 在搜索完成后更新会话历史
         emit sessionHistoryChanged();
     }
 
+    /*
+     * Summary: 取消进行中的搜索
+     * Parameters:
+     *   const QString& requestId - handleSearch 返回的请求 ID
+     * Return: void
+     * Description: 令牌取消后排队中的限流请求被撤回，进行中的传输由 I/O 线程立即中止，
+     *              后台任务随即结束；结果在完成回调中以 searchCancelled 通知
+     */
+    void SearchBridge::cancelSearch(const QString &requestId)
+    {
+        auto it = pendingSearches.find(requestId);
+        if (it != pendingSearches.end() && !it->cancellation->isCancelled())
+        {
+            DEBUGLOG("Cancelling search {}", requestId.toStdString());
+            it->cancellation->cancel();
+        }
+    }
+
+    void SearchBridge::cancelSessionSearches(const QString &sessionId)
+    {
+        for (auto it = pendingSearches.begin(); it != pendingSearches.end(); ++it)
+        {
+            if (it->sessionId == sessionId && !it->cancellation->isCancelled())
+            {
+                DEBUGLOG("Cancelling search {} in session {}", it.key().toStdString(), sessionId.toStdString());
+                it->cancellation->cancel();
+            }
+        }
+    }
+
+    /*
+     * Summary: 为会话分配下一个轮次号
+     * Parameters:
+     *   const QString& sessionId - 会话 ID
+     * Return: int - 新的轮次号
+     * Description: 轮次在发起搜索时按提交顺序分配，结果乱序返回也能写入正确的轮次；
+     *              会话首次使用时以已保存记录中的最大轮次为起点
+     */
+    int SearchBridge::reserveTurnNumber(const QString &sessionId)
+    {
+        auto it = lastTurnNumbers.find(sessionId);
+        if (it == lastTurnNumbers.end())
+        {
+            // 记录只会为已有轮次号的会话排队，会话首次使用时队列中没有它的记录，无需等待写入线程；
+            // 只读索引中的最大轮次，不解压记录
+            it = lastTurnNumbers.insert(sessionId, dbManager->getLastTurnNumber(sessionId));
+        }
+        return ++it.value();
+    }
+
     QString SearchBridge::startNewSession()
     {
         INFOLOG("Creating new chat session");
@@ -202,21 +347,124 @@ namespace IntelliSearch
         DEBUGLOG("Retrieving dialogues for session: {}", sessionId.toStdString());
         QVariantList dialoguesList;
 
-        auto dialogues = dbManager->getDialogueHistory(sessionId);
-        for (const auto &dialogue : dialogues)
+        try
         {
-            dialoguesList.append(dialogue);
+            auto dialogues = dbManager->getDialogueHistory(sessionId);
+            for (const auto &dialogue : dialogues)
+            {
+                dialoguesList.append(dialogue);
+            }
+        }
+        catch (const PayloadDecodeError &e)
+        {
+            ERRORLOG("Failed to load dialogues of session {}: {}", sessionId.toStdString(), e.what());
+            emit historyLoadFailed(QString::fromStdString(e.what()));
         }
 
         return dialoguesList;
     }
 
+    /*
+     * Summary: 分页获取会话列表
+     * Parameters:
+     *   const QString& cursor - 上一页的 nextCursor，为空时取第一页
+     *   int limit - 每页会话数
+     * Return: QVariantMap - items 为会话列表，nextCursor 为下一页游标
+     */
+    QVariantMap SearchBridge::getSessionsPage(const QString &cursor, int limit)
+    {
+        HistoryPage page = dbManager->getSessionPage(cursor, limit);
+
+        QVariantList items;
+        for (const auto &session : page.items)
+        {
+            items.append(session);
+        }
+        QVariantMap result;
+        result["items"] = items;
+        result["nextCursor"] = page.nextCursor;
+        return result;
+    }
+
+    /*
+     * Summary: 分页获取会话的对话记录
+     * Parameters:
+     *   const QString& sessionId - 会话 ID
+     *   const QString& cursor - 上一页的 nextCursor，为空时取最新一页
+     *   int limit - 每页记录数
+     * Return: QVariantMap - items 为按轮次正序的记录，nextCursor 指向更早的记录
+     * Description: 打开长会话时只解压最新一页的搜索结果，向上滚动时再加载更早的记录
+     */
+    QVariantMap SearchBridge::getSessionDialoguesPage(const QString &sessionId, const QString &cursor, int limit)
+    {
+        HistoryPage page;
+        try
+        {
+            page = dbManager->getDialoguePage(sessionId, cursor, limit);
+        }
+        catch (const PayloadDecodeError &e)
+        {
+            ERRORLOG("Failed to load dialogues of session {}: {}", sessionId.toStdString(), e.what());
+            emit historyLoadFailed(QString::fromStdString(e.what()));
+        }
+
+        QVariantList items;
+        for (const auto &dialogue : page.items)
+        {
+            items.append(dialogue);
+        }
+        QVariantMap result;
+        result["items"] = items;
+        result["nextCursor"] = page.nextCursor;
+        return result;
+    }
+
+    /*
+     * Summary: 全文检索对话历史
+     * Parameters:
+     *   const QString& query - 检索词
+     *   int limit - 返回的最大条数
+     * Return: QVariantList - 命中的对话记录，最新的在前
+     * Description: 直接从本地历史中找回过去的答案，无需重新发起付费的搜索
+     */
+    QVariantList SearchBridge::searchHistory(const QString &query, int limit)
+    {
+        QVariantList matchesList;
+        if (query.trimmed().isEmpty())
+        {
+            return matchesList;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+            auto matches = dbManager->searchHistory(query, limit);
+            for (const auto &match : matches)
+            {
+                matchesList.append(match);
+            }
+        }
+        catch (const PayloadDecodeError &e)
+        {
+            ERRORLOG("History search for {} failed: {}", query.toStdString(), e.what());
+            emit historyLoadFailed(QString::fromStdString(e.what()));
+        }
+        DEBUGLOG("History search for {} returned {} matches in {:.2f} ms", query.toStdString(), matchesList.size(),
+                 std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+        return matchesList;
+    }
+
     void SearchBridge::setCurrentSession(const QString &sessionId)
     {
         if (currentSessionId != sessionId)
         {
+            // 离开会话时取消其中进行中的搜索；关闭 cancel_superseded 时它们继续执行并写回发起时的会话
+            if (cancelSuperseded && !currentSessionId.isEmpty())
+            {
+                cancelSessionSearches(currentSessionId);
+            }
             currentSessionId = sessionId;
-            currentTurnNumber = 0; // 重置对话轮次
             INFOLOG("Set current session to: {}", sessionId.toStdString());
         }
     }
@@ -3,9 +3,11 @@
 #include <QObject>
 #include <QString>
 #include <QVariantList>
+#include <QHash>
 #include <memory>
 #include "core/engine/IntentParser.h"
 #include "../../data/database/DatabaseManager.h"
+#include "../../data/database/HistoryWriter.h"
 #include "../../data/crawler/CrawlerManager.h"
 #include <QFuture>
 #include <QFutureWatcher>
@@ -18,6 +20,7 @@ namespace IntelliSearch
     {
         Q_OBJECT
         Q_PROPERTY(bool isSearching READ isSearching NOTIFY searchingChanged)
+        Q_PROPERTY(int activeSearchCount READ activeSearchCount NOTIFY searchingChanged)
         Q_PROPERTY(QVariantList sessionHistory READ getSessionsList NOTIFY sessionHistoryChanged)
         Q_PROPERTY(CrawlerManager *crawlerManager READ getCrawlerManager CONSTANT)
 
@@ -29,7 +32,13 @@ namespace IntelliSearch
         CrawlerManager *getCrawlerManager() const { return crawlerManager.get(); }
 
     public slots:
-        void handleSearch(const QString &query);
+        // 在当前会话中发起搜索，返回请求 ID；多个搜索可同时进行，结果信号携带请求 ID 与会话 ID。
+        // 开启 search_settings.cancel_superseded 时，同一会话中仍在进行的搜索会被取消
+        QString handleSearch(const QString &query);
+
+        // 取消进行中的搜索，已发出的请求立即中止，完成时发出 searchCancelled
+        Q_INVOKABLE void cancelSearch(const QString &requestId);
+        Q_INVOKABLE void cancelSessionSearches(const QString &sessionId);
 
         // 会话管理相关方法
         QString startNewSession();                                  // 开始新会话
@@ -37,6 +46,14 @@ namespace IntelliSearch
         QVariantList getSessionDialogues(const QString &sessionId); // 获取特定会话的对话历史
         void setCurrentSession(const QString &sessionId);           // 设置当前活动会话
 
+        // 全文检索历史查询与答案，返回命中的对话记录（含 session_id、session_title）
+        Q_INVOKABLE QVariantList searchHistory(const QString &query, int limit = 20);
+
+        // 分页读取历史，返回 {items, nextCursor}；nextCursor 为空表示没有更多。
+        // 会话按最后更新时间倒序，对话从最新一页往前翻，每页内按轮次正序
+        Q_INVOKABLE QVariantMap getSessionsPage(const QString &cursor, int limit = 20);
+        Q_INVOKABLE QVariantMap getSessionDialoguesPage(const QString &sessionId, const QString &cursor, int limit = 20);
+
         // 创建新会话并自动切换到该会话
         Q_INVOKABLE QString createAndSwitchToNewSession()
         {
@@ -53,12 +70,16 @@ namespace IntelliSearch
         Q_INVOKABLE void stopCrawling();
 
     signals:
-        void searchResultsReady(const QString &results); // 搜索结果就绪
+        void searchStarted(const QString &requestId, const QString &sessionId, const QString &query); // 搜索开始
+        void searchResultsReady(const QString &requestId, const QString &sessionId, const QString &results); // 搜索结果就绪
+        void searchPartialResult(const QString &requestId, const QString &sessionId, const QString &text);   // 流式答案更新（累计文本）
+        void searchCancelled(const QString &requestId, const QString &sessionId);                            // 搜索已取消
         void searchingChanged();                         // 搜索状态改变
         void searchStatusChanged(const QString &status); // 搜索状态改变
         void sessionCreated(const QString &sessionId);   // 会话创建
         void sessionUpdated(const QString &sessionId);   // 会话更新
         void sessionHistoryChanged();                    // 会话历史改变
+        void historyLoadFailed(const QString &errorMessage); // 历史记录无法还原（记录损坏或缺少压缩词典）
 
         // 爬虫相关信号
         void crawlingStarted();                          // 爬取开始
@@ -66,19 +87,33 @@ namespace IntelliSearch
         void crawlingError(const QString &errorMessage); // 爬取错误
         void crawlingProgress(int crawled, int total);   // 爬取进度
 
-    private slots:
-        void handleSearchComplete();
-
     private:
+        // 进行中的搜索，发起时即确定所属会话与轮次，结果据此回写
+        struct PendingSearch
+        {
+            QString sessionId;
+            QString query;
+            int turnNumber = 0;
+            QFutureWatcher<QString> *watcher = nullptr;
+            std::shared_ptr<CancellationToken> cancellation;
+        };
+
+        void handleSearchComplete(const QString &requestId);
+
+        // 为会话分配下一个轮次号，首次使用时从已保存的对话记录恢复
+        int reserveTurnNumber(const QString &sessionId);
+
         std::unique_ptr<IntentParser> intentParser;
         std::shared_ptr<IDatabaseManager> dbManager;
+        std::unique_ptr<HistoryWriter> historyWriter;   // 对话记录由后台线程攒批写入，析构时写完队列
         std::unique_ptr<CrawlerManager> crawlerManager; // 爬虫管理器
-        QFutureWatcher<QString> searchWatcher;
+        QHash<QString, PendingSearch> pendingSearches;  // 请求 ID -> 进行中的搜索
+        QHash<QString, int> lastTurnNumbers;            // 会话 ID -> 已分配的最大轮次号
         QString currentSessionId;
-        QString lastQuery;
-        int currentTurnNumber;
+        bool cancelSuperseded = true; // 新查询或离开会话时取消该会话中进行中的搜索
 
-        bool isSearching() const { return searchWatcher.isRunning(); }
+        bool isSearching() const { return !pendingSearches.isEmpty(); }
+        int activeSearchCount() const { return pendingSearches.size(); }
         void updateSessionHistory();
     };
 
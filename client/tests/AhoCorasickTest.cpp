@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <utility>
+
+#include "core/utils/AhoCorasick.h"
+
+using IntelliSearch::AhoCorasick;
+
+namespace {
+
+std::set<std::pair<size_t, size_t>> matchSet(const std::vector<AhoCorasick::Match>& matches) {
+    std::set<std::pair<size_t, size_t>> result;
+    for (const auto& match : matches) {
+        result.emplace(match.patternId, match.end);
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(AhoCorasickTest, FindsOverlappingPatterns) {
+    AhoCorasick automaton;
+    size_t he = automaton.addPattern("he");
+    size_t she = automaton.addPattern("she");
+    size_t his = automaton.addPattern("his");
+    size_t hers = automaton.addPattern("hers");
+    automaton.build();
+
+    auto matches = matchSet(automaton.findAll("ushers"));
+    std::set<std::pair<size_t, size_t>> expected = {{she, 4}, {he, 4}, {hers, 6}};
+    EXPECT_EQ(matches, expected);
+    EXPECT_TRUE(matchSet(automaton.findAll("this")).count({his, 4}));
+}
+
+TEST(AhoCorasickTest, MatchesChineseKeywordsByBytes) {
+    AhoCorasick automaton;
+    size_t weather = automaton.addPattern("天气");
+    size_t forecast = automaton.addPattern("天气预报");
+    automaton.build();
+
+    std::string text = "明天天气预报";
+    auto matches = matchSet(automaton.findAll(text));
+    std::set<std::pair<size_t, size_t>> expected = {{weather, std::string("明天天气").size()},
+                                                    {forecast, text.size()}};
+    EXPECT_EQ(matches, expected);
+    EXPECT_EQ(automaton.patternLength(forecast), std::string("天气预报").size());
+}
+
+TEST(AhoCorasickTest, NoMatchesInUnrelatedText) {
+    AhoCorasick automaton;
+    automaton.addPattern("python");
+    automaton.build();
+
+    EXPECT_TRUE(automaton.findAll("pytho pyth0n").empty());
+    EXPECT_TRUE(automaton.findAll("").empty());
+    EXPECT_EQ(automaton.patternCount(), 1u);
+}
+
+TEST(AhoCorasickTest, RepeatedPatternMatchesEveryOccurrence) {
+    AhoCorasick automaton;
+    size_t aa = automaton.addPattern("aa");
+    automaton.build();
+
+    auto matches = automaton.findAll("aaaa");
+    ASSERT_EQ(matches.size(), 3u);
+    for (size_t i = 0; i < matches.size(); ++i) {
+        EXPECT_EQ(matches[i].patternId, aa);
+        EXPECT_EQ(matches[i].end, i + 2);
+    }
+}
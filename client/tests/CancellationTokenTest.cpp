@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "core/api/CancellationToken.h"
+
+using namespace IntelliSearch;
+
+TEST(CancellationTokenTest, CancelRunsEachCallbackOnce) {
+    auto token = std::make_shared<CancellationToken>();
+    int calls = 0;
+    uint64_t id = token->subscribe([&calls]() { ++calls; });
+    EXPECT_NE(id, 0u);
+    EXPECT_FALSE(token->isCancelled());
+
+    token->cancel();
+    token->cancel();
+    EXPECT_TRUE(token->isCancelled());
+    EXPECT_TRUE(token->flag()->load());
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(token->subscriptionCount(), 0u);
+    EXPECT_THROW(token->throwIfCancelled("search"), RequestCancelled);
+}
+
+TEST(CancellationTokenTest, SubscribeAfterCancelRunsImmediately) {
+    CancellationToken token;
+    token.cancel();
+
+    bool called = false;
+    EXPECT_EQ(token.subscribe([&called]() { called = true; }), 0u);
+    EXPECT_TRUE(called);
+    EXPECT_EQ(token.subscriptionCount(), 0u);
+}
+
+TEST(CancellationTokenTest, UnsubscribedCallbackDoesNotRun) {
+    CancellationToken token;
+    bool called = false;
+    uint64_t id = token.subscribe([&called]() { called = true; });
+    token.unsubscribe(id);
+    token.cancel();
+    EXPECT_FALSE(called);
+}
+
+TEST(CancellationTokenTest, LinkedChildCancelsWithParent) {
+    auto parent = std::make_shared<CancellationToken>();
+    auto child = CancellationToken::linkedTo(parent);
+    auto sibling = CancellationToken::linkedTo(parent);
+
+    // 子令牌单独取消不影响父令牌与其他子令牌
+    sibling->cancel();
+    EXPECT_FALSE(parent->isCancelled());
+    EXPECT_FALSE(child->isCancelled());
+
+    bool childCallback = false;
+    child->subscribe([&childCallback]() { childCallback = true; });
+    parent->cancel();
+    EXPECT_TRUE(child->isCancelled());
+    EXPECT_TRUE(childCallback);
+}
+
+TEST(CancellationTokenTest, LinkingToCancelledParentYieldsCancelledChild) {
+    auto parent = std::make_shared<CancellationToken>();
+    parent->cancel();
+
+    auto child = CancellationToken::linkedTo(parent);
+    EXPECT_TRUE(child->isCancelled());
+    EXPECT_EQ(parent->subscriptionCount(), 0u);
+}
+
+TEST(CancellationTokenTest, NullParentYieldsIndependentToken) {
+    auto child = CancellationToken::linkedTo(nullptr);
+    ASSERT_NE(child, nullptr);
+    EXPECT_FALSE(child->isCancelled());
+    child->cancel();
+    EXPECT_TRUE(child->isCancelled());
+}
+
+TEST(CancellationTokenTest, DestroyedChildrenUnsubscribeFromParent) {
+    auto parent = std::make_shared<CancellationToken>();
+    {
+        std::vector<std::shared_ptr<CancellationToken>> children;
+        for (int i = 0; i < 1000; ++i) {
+            children.push_back(CancellationToken::linkedTo(parent));
+        }
+        EXPECT_EQ(parent->subscriptionCount(), 1000u);
+        children.resize(10);
+        EXPECT_EQ(parent->subscriptionCount(), 10u);
+    }
+    EXPECT_EQ(parent->subscriptionCount(), 0u);
+
+    // 父令牌先释放时子令牌的析构不访问它
+    auto orphan = CancellationToken::linkedTo(parent);
+    parent.reset();
+    EXPECT_FALSE(orphan->isCancelled());
+}
+
+TEST(CancellationTokenTest, ScopedSubscriptionUnsubscribesOnExit) {
+    auto token = std::make_shared<CancellationToken>();
+    bool called = false;
+    {
+        CancellationSubscription subscription(token, [&called]() { called = true; });
+        EXPECT_EQ(token->subscriptionCount(), 1u);
+    }
+    EXPECT_EQ(token->subscriptionCount(), 0u);
+    token->cancel();
+    EXPECT_FALSE(called);
+
+    // 空令牌不做任何事
+    CancellationSubscription empty(nullptr, []() {});
+}
+
+TEST(CancellationTokenTest, WaitForReturnsEarlyOnCancel) {
+    auto token = std::make_shared<CancellationToken>();
+    EXPECT_FALSE(token->waitFor(std::chrono::milliseconds(10)));
+
+    std::thread canceller([token]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        token->cancel();
+    });
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(token->waitFor(std::chrono::seconds(5)));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    canceller.join();
+}
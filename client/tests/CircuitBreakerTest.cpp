@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "core/api/CircuitBreaker.h"
+
+using namespace IntelliSearch;
+
+namespace {
+
+CircuitBreakerConfig testConfig() {
+    CircuitBreakerConfig config;
+    config.windowSize = 4;
+    config.failureThreshold = 2;
+    config.openDuration = std::chrono::milliseconds(50);
+    config.maxOpenDuration = std::chrono::milliseconds(200);
+    config.maxFailedProbes = 2;
+    return config;
+}
+
+void waitFor(std::chrono::milliseconds duration) {
+    std::this_thread::sleep_for(duration);
+}
+
+} // namespace
+
+TEST(CircuitBreakerTest, OpensAfterFailureThreshold) {
+    CircuitBreaker breaker("test_open", testConfig());
+    EXPECT_TRUE(breaker.tryAcquire());
+    breaker.onFailure(false);
+    EXPECT_EQ(breaker.getStats().state, CircuitState::Closed);
+    breaker.onFailure(true);
+
+    auto stats = breaker.getStats();
+    EXPECT_EQ(stats.state, CircuitState::Open);
+    EXPECT_EQ(stats.opened, 1u);
+    EXPECT_EQ(stats.timeouts, 1u);
+    EXPECT_FALSE(breaker.tryAcquire());
+    EXPECT_FALSE(breaker.isCallPermitted());
+    EXPECT_EQ(breaker.getStats().rejected, 1u);
+}
+
+TEST(CircuitBreakerTest, SuccessesSlideFailuresOutOfTheWindow) {
+    CircuitBreaker breaker("test_window", testConfig());
+    breaker.onFailure(false);
+    for (int i = 0; i < 4; ++i) {
+        breaker.onSuccess();
+    }
+    breaker.onFailure(false);
+    EXPECT_EQ(breaker.getStats().state, CircuitState::Closed);
+    EXPECT_EQ(breaker.getStats().recentFailures, 1u);
+}
+
+TEST(CircuitBreakerTest, HalfOpenAllowsOneTrialAndClosesOnSuccess) {
+    CircuitBreaker breaker("test_half_open", testConfig());
+    breaker.onFailure(false);
+    breaker.onFailure(false);
+    waitFor(std::chrono::milliseconds(80));
+
+    EXPECT_TRUE(breaker.isCallPermitted());
+    EXPECT_TRUE(breaker.tryAcquire());
+    EXPECT_EQ(breaker.getStats().state, CircuitState::HalfOpen);
+    EXPECT_FALSE(breaker.tryAcquire());
+
+    breaker.onAbandon();
+    EXPECT_TRUE(breaker.tryAcquire());
+    breaker.onSuccess();
+    EXPECT_EQ(breaker.getStats().state, CircuitState::Closed);
+    EXPECT_TRUE(breaker.tryAcquire());
+}
+
+TEST(CircuitBreakerTest, FailedTrialReopensWithLongerDuration) {
+    CircuitBreaker breaker("test_backoff", testConfig());
+    breaker.onFailure(false);
+    breaker.onFailure(false);
+    waitFor(std::chrono::milliseconds(80));
+    ASSERT_TRUE(breaker.tryAcquire());
+    breaker.onFailure(false);
+
+    EXPECT_EQ(breaker.getStats().state, CircuitState::Open);
+    EXPECT_EQ(breaker.getStats().opened, 2u);
+    // 第二次断开时长为 100 ms
+    waitFor(std::chrono::milliseconds(60));
+    EXPECT_FALSE(breaker.tryAcquire());
+    waitFor(std::chrono::milliseconds(80));
+    EXPECT_TRUE(breaker.tryAcquire());
+}
+
+TEST(CircuitBreakerTest, ProbeDecidesWhenToHalfOpen) {
+    CircuitBreaker breaker("test_probe", testConfig());
+    bool healthy = false;
+    breaker.setProbe([&]() { return healthy; });
+    breaker.onFailure(false);
+    breaker.onFailure(false);
+    waitFor(std::chrono::milliseconds(80));
+
+    // 设置了探测时由探测而不是请求决定是否半开
+    EXPECT_FALSE(breaker.tryAcquire());
+    auto next = breaker.probeIfDue(CircuitBreaker::Clock::now());
+    EXPECT_NE(next, CircuitBreaker::Clock::time_point::max());
+    EXPECT_EQ(breaker.getStats().probeFailures, 1u);
+    EXPECT_EQ(breaker.getStats().state, CircuitState::Open);
+
+    healthy = true;
+    breaker.probeIfDue(next);
+    EXPECT_EQ(breaker.getStats().state, CircuitState::HalfOpen);
+    EXPECT_EQ(breaker.getStats().probes, 2u);
+    EXPECT_TRUE(breaker.tryAcquire());
+}
+
+// 探测地址本身返回 404/405 时探测永远失败，熔断器仍须按时间恢复
+TEST(CircuitBreakerTest, RecoversWhenTheProbeEndpointIsMissing) {
+    for (long status : {404L, 405L}) {
+        SCOPED_TRACE(status);
+        CircuitBreaker breaker("test_probe_missing_" + std::to_string(status), testConfig());
+        breaker.setProbe([status]() { return CircuitBreakerRegistry::isHealthyProbeStatus(status); });
+        breaker.onFailure(false);
+        breaker.onFailure(false);
+
+        // 前两次探测失败，断开时间分别为 100 ms、200 ms
+        auto next = breaker.probeIfDue(CircuitBreaker::Clock::now() + std::chrono::milliseconds(60));
+        ASSERT_NE(next, CircuitBreaker::Clock::time_point::max());
+        EXPECT_FALSE(breaker.isCallPermitted());
+        next = breaker.probeIfDue(next);
+        EXPECT_EQ(breaker.getStats().probeFailures, 2u);
+
+        // 达到 maxFailedProbes 后不再探测，断开时间结束时放行真实请求试探
+        EXPECT_EQ(breaker.probeIfDue(next), CircuitBreaker::Clock::time_point::max());
+        EXPECT_EQ(breaker.getStats().probes, 2u);
+        EXPECT_FALSE(breaker.tryAcquire());
+        waitFor(std::chrono::milliseconds(230));
+        ASSERT_TRUE(breaker.tryAcquire());
+        EXPECT_EQ(breaker.getStats().state, CircuitState::HalfOpen);
+        breaker.onSuccess();
+        EXPECT_EQ(breaker.getStats().state, CircuitState::Closed);
+
+        // 关闭后探测重新生效，再次断开时仍由探测决定
+        breaker.onFailure(false);
+        breaker.onFailure(false);
+        waitFor(std::chrono::milliseconds(80));
+        EXPECT_FALSE(breaker.tryAcquire());
+        EXPECT_NE(breaker.probeIfDue(CircuitBreaker::Clock::now()), CircuitBreaker::Clock::time_point::max());
+        EXPECT_EQ(breaker.getStats().probes, 3u);
+    }
+}
+
+TEST(CircuitBreakerTest, DisabledBreakerNeverOpens) {
+    CircuitBreakerConfig config = testConfig();
+    config.enabled = false;
+    CircuitBreaker breaker("test_disabled", config);
+    for (int i = 0; i < 10; ++i) {
+        breaker.onFailure(false);
+    }
+    EXPECT_TRUE(breaker.tryAcquire());
+    EXPECT_EQ(breaker.getStats().opened, 0u);
+}
+
+TEST(CircuitBreakerTest, ProbeStatusClassification) {
+    EXPECT_TRUE(CircuitBreakerRegistry::isHealthyProbeStatus(200));
+    EXPECT_TRUE(CircuitBreakerRegistry::isHealthyProbeStatus(400));
+    EXPECT_FALSE(CircuitBreakerRegistry::isHealthyProbeStatus(0));
+    EXPECT_FALSE(CircuitBreakerRegistry::isHealthyProbeStatus(401));
+    EXPECT_FALSE(CircuitBreakerRegistry::isHealthyProbeStatus(403));
+    EXPECT_FALSE(CircuitBreakerRegistry::isHealthyProbeStatus(404));
+    EXPECT_FALSE(CircuitBreakerRegistry::isHealthyProbeStatus(405));
+    EXPECT_FALSE(CircuitBreakerRegistry::isHealthyProbeStatus(429));
+    EXPECT_FALSE(CircuitBreakerRegistry::isHealthyProbeStatus(503));
+}
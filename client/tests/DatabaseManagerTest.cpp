@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QVariant>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "data/database/DatabaseManager.h"
+#include "data/database/PayloadCodec.h"
+
+using namespace IntelliSearch;
+
+namespace {
+
+const QString kSessionId = "fixture-session";
+
+std::string searchResultJson(int index) {
+    std::string pages;
+    for (int page = 0; page < 4; ++page) {
+        std::string n = std::to_string(index * 10 + page);
+        pages += std::string(pages.empty() ? "" : ",") + R"({"title":"第)" + n + R"(条搜索结果","url":"https://example.com/a/)" + n +
+                 R"(","snippet":"关于查询 )" + n + R"( 的网页摘要，包含若干重复出现的描述文字。","siteName":"示例站点"})";
+    }
+    return R"({"result":"第)" + std::to_string(index) + R"(个问题的回答","webPages":[)" + pages + "]}";
+}
+
+std::string intentResultJson(int index) {
+    return R"({"intent_type":"general_search","keywords":["关键词)" + std::to_string(index) +
+           R"(","示例"],"search_query":"第)" + std::to_string(index) + R"(个问题的改写查询"})";
+}
+
+DialogueRecord makeRecord(int index) {
+    DialogueRecord record;
+    record.sessionId = kSessionId;
+    record.userQuery = QString("第%1个问题").arg(index);
+    record.intentType = "general_search";
+    record.intentResult = QString::fromStdString(intentResultJson(index));
+    record.searchResult = QString::fromStdString(searchResultJson(index));
+    record.turnNumber = index;
+    return record;
+}
+
+// 在测试目录中打开一个独立连接，用于构造夹具或检查存储格式
+class RawConnection {
+public:
+    explicit RawConnection(const QString& name) : name(name) {
+        db = QSqlDatabase::addDatabase("QSQLITE", name);
+        db.setDatabaseName(QDir::current().filePath("intellisearch.db"));
+        EXPECT_TRUE(db.open());
+    }
+
+    ~RawConnection() {
+        db.close();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(name);
+    }
+
+    QSqlQuery exec(const QString& sql) {
+        QSqlQuery query(db);
+        EXPECT_TRUE(query.exec(sql)) << sql.toStdString();
+        return query;
+    }
+
+    QVariant scalar(const QString& sql) {
+        QSqlQuery query = exec(sql);
+        return query.next() ? query.value(0) : QVariant();
+    }
+
+    QSqlDatabase db;
+
+private:
+    QString name;
+};
+
+// 构造迁移 3 之后、迁移 4 之前的数据库：结果以原文 TEXT 保存，尚无词典表与全文索引
+void createVersion3Database(int recordCount) {
+    RawConnection fixture("fixture");
+    fixture.exec("CREATE TABLE dialogue_sessions (session_id TEXT PRIMARY KEY, "
+                 "created_at DATETIME DEFAULT CURRENT_TIMESTAMP, last_updated DATETIME DEFAULT CURRENT_TIMESTAMP, "
+                 "title TEXT, status TEXT DEFAULT 'active')");
+    fixture.exec("CREATE TABLE dialogue_records (id INTEGER PRIMARY KEY AUTOINCREMENT, session_id TEXT NOT NULL, "
+                 "turn_number INTEGER NOT NULL, user_query TEXT NOT NULL, intent_type TEXT NOT NULL, "
+                 "intent_result TEXT NOT NULL, search_result TEXT NOT NULL, timestamp DATETIME DEFAULT CURRENT_TIMESTAMP)");
+    fixture.exec("CREATE INDEX idx_dialogue_records_session_turn ON dialogue_records (session_id, turn_number)");
+    fixture.exec("CREATE INDEX idx_dialogue_sessions_last_updated ON dialogue_sessions (last_updated)");
+    fixture.exec("INSERT INTO dialogue_sessions (session_id, title) VALUES ('" + kSessionId + "', 'fixture')");
+
+    QSqlQuery insert(fixture.db);
+    insert.prepare("INSERT INTO dialogue_records (session_id, turn_number, user_query, intent_type, intent_result, "
+                   "search_result) VALUES (?, ?, ?, ?, ?, ?)");
+    for (int i = 1; i <= recordCount; ++i) {
+        DialogueRecord record = makeRecord(i);
+        insert.addBindValue(record.sessionId);
+        insert.addBindValue(record.turnNumber);
+        insert.addBindValue(record.userQuery);
+        insert.addBindValue(record.intentType);
+        insert.addBindValue(record.intentResult);
+        insert.addBindValue(record.searchResult);
+        EXPECT_TRUE(insert.exec());
+    }
+    // 短于 min_size_bytes 的结果迁移后仍为 TEXT
+    fixture.exec("INSERT INTO dialogue_records (session_id, turn_number, user_query, intent_type, intent_result, "
+                 "search_result) VALUES ('" + kSessionId + "', " + QString::number(recordCount + 1) +
+                 ", 'short', 'general_search', '{}', '{\"result\":\"ok\"}')");
+    fixture.exec("PRAGMA user_version = 3");
+}
+
+} // namespace
+
+// SQLiteDatabaseManager 在当前目录下打开 intellisearch.db，每个用例切换到独立的临时目录
+class DatabaseManagerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(tempDir.isValid());
+        previousDir = QDir::currentPath();
+        ASSERT_TRUE(QDir::setCurrent(tempDir.path()));
+    }
+
+    void TearDown() override {
+        QDir::setCurrent(previousDir);
+    }
+
+    QTemporaryDir tempDir;
+    QString previousDir;
+};
+
+TEST_F(DatabaseManagerTest, Migration4CompressesExistingRecordsAndReadsThemBack) {
+    const int recordCount = 60;
+    createVersion3Database(recordCount);
+
+    {
+        SQLiteDatabaseManager manager;
+        ASSERT_TRUE(manager.initialize());
+
+        auto dialogues = manager.getDialogueHistory(kSessionId);
+        ASSERT_EQ(dialogues.size(), recordCount + 1);
+        for (int i = 1; i <= recordCount; ++i) {
+            DialogueRecord expected = makeRecord(i);
+            const auto& dialogue = dialogues[i - 1];
+            EXPECT_EQ(dialogue.value("turn_number").toInt(), i);
+            EXPECT_EQ(dialogue.value("intent_result").toString(), expected.intentResult);
+            EXPECT_EQ(dialogue.value("search_result").toString(), expected.searchResult);
+        }
+        EXPECT_EQ(dialogues.last().value("search_result").toString(), "{\"result\":\"ok\"}");
+        EXPECT_EQ(manager.getLastTurnNumber(kSessionId), recordCount + 1);
+    }
+
+    RawConnection inspect("inspect");
+    EXPECT_EQ(inspect.scalar("PRAGMA user_version").toInt(), 5);
+    EXPECT_EQ(inspect.scalar("SELECT COUNT(*) FROM payload_dictionaries").toInt(), 1);
+    EXPECT_EQ(inspect.scalar("SELECT COUNT(*) FROM dialogue_records WHERE typeof(search_result) = 'blob'").toInt(),
+              recordCount);
+    EXPECT_EQ(inspect.scalar("SELECT typeof(search_result) FROM dialogue_records WHERE user_query = 'short'").toString(),
+              "text");
+
+    // 迁移后的帧使用训练出的词典
+    QByteArray frame = inspect.scalar("SELECT search_result FROM dialogue_records ORDER BY id LIMIT 1").toByteArray();
+    EXPECT_NE(PayloadCodec::frameDictionaryId(std::string(frame.constData(), static_cast<size_t>(frame.size()))), 0u);
+}
+
+TEST_F(DatabaseManagerTest, ReadsFramesWhoseDictionaryWasTrainedByAnotherConnection) {
+    SQLiteDatabaseManager writer;
+    ASSERT_TRUE(writer.initialize());
+    SQLiteDatabaseManager reader;
+    ASSERT_TRUE(reader.initialize());
+    {
+        RawConnection setup("setup");
+        setup.exec("INSERT INTO dialogue_sessions (session_id) VALUES ('" + kSessionId + "')");
+    }
+
+    // 达到 train_after_records 后 writer 训练词典，之后的记录用词典压缩；reader 启动时词典尚不存在
+    QVector<DialogueRecord> records;
+    for (int i = 1; i <= 50; ++i) {
+        records.append(makeRecord(i));
+    }
+    ASSERT_TRUE(writer.addDialogueRecords(records));
+    ASSERT_TRUE(writer.addDialogueRecords({makeRecord(51)}));
+
+    {
+        RawConnection inspect("inspect");
+        QByteArray frame = inspect.scalar("SELECT search_result FROM dialogue_records WHERE turn_number = 51").toByteArray();
+        ASSERT_NE(PayloadCodec::frameDictionaryId(std::string(frame.constData(), static_cast<size_t>(frame.size()))), 0u);
+    }
+
+    HistoryPage page = reader.getDialoguePage(kSessionId, QString(), 1);
+    ASSERT_EQ(page.items.size(), 1);
+    EXPECT_EQ(page.items[0].value("search_result").toString(), makeRecord(51).searchResult);
+    EXPECT_EQ(page.items[0].value("intent_result").toString(), makeRecord(51).intentResult);
+}
+
+TEST_F(DatabaseManagerTest, CorruptPayloadFailsLoudlyWithTheRecordId) {
+    SQLiteDatabaseManager manager;
+    ASSERT_TRUE(manager.initialize());
+    QString sessionId = manager.createSession();
+    ASSERT_FALSE(sessionId.isEmpty());
+    DialogueRecord record = makeRecord(1);
+    record.sessionId = sessionId;
+    ASSERT_TRUE(manager.addDialogueRecords({record}));
+
+    qint64 recordId = 0;
+    {
+        RawConnection corrupt("corrupt");
+        recordId = corrupt.scalar("SELECT id FROM dialogue_records").toLongLong();
+        // zstd 帧头之后是无效数据
+        corrupt.exec("UPDATE dialogue_records SET search_result = X'28B52FFD2040DEADBEEF' WHERE id = " +
+                     QString::number(recordId));
+    }
+
+    try {
+        manager.getDialogueHistory(sessionId);
+        FAIL() << "expected PayloadDecodeError";
+    } catch (const PayloadDecodeError& e) {
+        EXPECT_EQ(e.getRecordId(), recordId);
+    }
+    EXPECT_THROW(manager.getDialoguePage(sessionId, QString(), 10), PayloadDecodeError);
+    EXPECT_THROW(manager.searchHistory("第1个问题", 10), PayloadDecodeError);
+
+    // 轮次号只读索引，不受损坏的记录影响
+    EXPECT_EQ(manager.getLastTurnNumber(sessionId), 1);
+}
+
+TEST_F(DatabaseManagerTest, MigrationRollsBackWhenARecordCannotBeDecoded) {
+    createVersion3Database(5);
+    {
+        RawConnection corrupt("corrupt");
+        corrupt.exec("UPDATE dialogue_records SET search_result = X'28B52FFD2040DEADBEEF' WHERE turn_number = 2");
+    }
+
+    {
+        SQLiteDatabaseManager manager;
+        EXPECT_FALSE(manager.initialize());
+    }
+
+    // 迁移 4 整体回滚，其余记录仍为原文
+    RawConnection inspect("inspect");
+    EXPECT_EQ(inspect.scalar("PRAGMA user_version").toInt(), 3);
+    EXPECT_EQ(inspect.scalar("SELECT COUNT(*) FROM dialogue_records WHERE typeof(search_result) = 'text'").toInt(), 5);
+    EXPECT_EQ(inspect.scalar("SELECT search_result FROM dialogue_records WHERE turn_number = 1").toString(),
+              makeRecord(1).searchResult);
+}
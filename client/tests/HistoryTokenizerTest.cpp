@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QVariant>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "data/database/HistoryTokenizer.h"
+
+using IntelliSearch::HistoryTokenizer;
+using IntelliSearch::HistoryTokens;
+
+namespace {
+
+// 与迁移 3 建立的全文索引结构一致
+const char* const kCreateIndex =
+    "CREATE VIRTUAL TABLE history_fts USING fts5("
+    "terms, grams, content='', prefix='1', tokenize='unicode61 remove_diacritics 2')";
+
+const std::vector<std::pair<qint64, std::string>> kDocuments = {
+    {1, "如何学习机器学习算法"},
+    {2, "今天北京天气怎么样？"},
+    {3, "Python 机器学习入门教程"},
+    {4, "学习笔记"},
+    {5, "天气预报 weather forecast"},
+};
+
+// 内存中的 FTS5 表，按 SQLiteDatabaseManager 的方式写入分词结果并执行 MATCH
+class HistoryIndex {
+public:
+    HistoryIndex(const HistoryTokenizer& tokenizer, const QString& name) : tokenizer(tokenizer), name(name) {
+        db = QSqlDatabase::addDatabase("QSQLITE", name);
+        db.setDatabaseName(":memory:");
+        if (db.open()) {
+            QSqlQuery query(db);
+            available = query.exec(kCreateIndex);
+        }
+    }
+
+    ~HistoryIndex() {
+        db.close();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(name);
+    }
+
+    void add(qint64 rowid, const std::string& text) {
+        HistoryTokens tokens = tokenizer.tokenize(text);
+        QSqlQuery insert(db);
+        insert.prepare("INSERT INTO history_fts (rowid, terms, grams) VALUES (?, ?, ?)");
+        insert.bindValue(0, rowid);
+        insert.bindValue(1, QString::fromStdString(HistoryTokenizer::join(tokens.terms)));
+        insert.bindValue(2, QString::fromStdString(HistoryTokenizer::join(tokens.grams)));
+        EXPECT_TRUE(insert.exec()) << insert.lastError().text().toStdString();
+    }
+
+    void addDocuments() {
+        for (const auto& [rowid, text] : kDocuments) {
+            add(rowid, text);
+        }
+    }
+
+    std::vector<qint64> search(const std::string& text) {
+        std::string match = tokenizer.buildMatchQuery(text);
+        std::vector<qint64> rowids;
+        QSqlQuery query(db);
+        query.prepare("SELECT rowid FROM history_fts WHERE history_fts MATCH ? ORDER BY rowid");
+        query.bindValue(0, QString::fromStdString(match));
+        EXPECT_TRUE(query.exec()) << match << ": " << query.lastError().text().toStdString();
+        while (query.next()) {
+            rowids.push_back(query.value(0).toLongLong());
+        }
+        return rowids;
+    }
+
+    bool available = false;
+
+private:
+    const HistoryTokenizer& tokenizer;
+    QString name;
+    QSqlDatabase db;
+};
+
+using Rowids = std::vector<qint64>;
+
+} // namespace
+
+// 不带词典的分词器，汉字全部按二元组切分
+class HistoryTokenizerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!index.available) {
+            GTEST_SKIP() << "SQLite is built without FTS5";
+        }
+        index.addDocuments();
+    }
+
+    HistoryTokenizer tokenizer;
+    HistoryIndex index{tokenizer, "history_fts_bigrams"};
+};
+
+TEST_F(HistoryTokenizerTest, CjkSubstringMatchesThroughBigramPhrase) {
+    EXPECT_EQ(index.search("器学习"), (Rowids{1, 3}));
+    EXPECT_EQ(index.search("学习机"), (Rowids{1}));
+    EXPECT_EQ(index.search("京天气怎"), (Rowids{2}));
+    EXPECT_EQ(index.search("学习"), (Rowids{1, 3, 4}));
+
+    // 二元组须相邻且按序出现
+    EXPECT_TRUE(index.search("学算").empty());
+    EXPECT_TRUE(index.search("习学").empty());
+    // 标点不属于任何段，不影响子串匹配
+    EXPECT_EQ(index.search("怎么样"), (Rowids{2}));
+}
+
+TEST_F(HistoryTokenizerTest, SingleCharacterQueryMatchesByPrefix) {
+    EXPECT_EQ(tokenizer.buildMatchQuery("气"), "grams : \"气\" *");
+    EXPECT_EQ(index.search("气"), (Rowids{2, 5}));
+    EXPECT_EQ(index.search("北"), (Rowids{2}));
+
+    // 段尾的字只出现在二元组的后一位，依靠末字单独成词命中
+    EXPECT_EQ(index.search("程"), (Rowids{3}));
+    EXPECT_EQ(index.search("记"), (Rowids{4}));
+    EXPECT_EQ(index.search("法"), (Rowids{1}));
+}
+
+TEST_F(HistoryTokenizerTest, MixedLatinAndCjkQueryRequiresEverySegment) {
+    EXPECT_EQ(tokenizer.buildMatchQuery("python学习"),
+              "terms : \"python\" * AND (grams : \"学习\" OR terms : \"学习\")");
+    EXPECT_EQ(index.search("python 学习"), (Rowids{3}));
+    EXPECT_EQ(index.search("PYTHON学习"), (Rowids{3}));
+
+    // 拉丁词按前缀匹配
+    EXPECT_EQ(index.search("Pyth机器"), (Rowids{3}));
+    EXPECT_EQ(index.search("weath 天气"), (Rowids{5}));
+    EXPECT_EQ(index.search("fore"), (Rowids{5}));
+    EXPECT_TRUE(index.search("python 天气").empty());
+}
+
+TEST_F(HistoryTokenizerTest, QueryWithoutSearchableTextIsEmpty) {
+    EXPECT_EQ(tokenizer.buildMatchQuery(""), "");
+    EXPECT_EQ(tokenizer.buildMatchQuery("？！ ,."), "");
+}
+
+// 带词典的分词器：terms 列保存最大匹配出的整词，grams 列不变，子串检索仍然有效
+class HistoryTokenizerDictionaryTest : public ::testing::Test {
+protected:
+    static std::string writeDictionary(const QTemporaryDir& dir) {
+        std::string path = dir.filePath("dict.txt").toStdString();
+        std::ofstream file(path);
+        // jieba 格式，每行只取第一个字段；单字与非汉字的词不进入词典
+        file << "机器学习 3 n\n机器 5 n\n学习 10 v\n天气预报 2 n\n入门 4 v\n"
+             << "学 20 v\nPython 1 eng\n\n";
+        return path;
+    }
+
+    void SetUp() override {
+        ASSERT_TRUE(dir.isValid());
+        if (!index.available) {
+            GTEST_SKIP() << "SQLite is built without FTS5";
+        }
+        index.addDocuments();
+    }
+
+    QTemporaryDir dir;
+    HistoryTokenizer tokenizer{writeDictionary(dir)};
+    HistoryIndex index{tokenizer, "history_fts_dictionary"};
+};
+
+TEST_F(HistoryTokenizerDictionaryTest, LoadsOnlyMultiCharacterCjkWords) {
+    EXPECT_EQ(tokenizer.dictionarySize(), 5u);
+    EXPECT_EQ(HistoryTokenizer().dictionarySize(), 0u);
+    EXPECT_EQ(HistoryTokenizer(dir.filePath("missing.txt").toStdString()).dictionarySize(), 0u);
+}
+
+TEST_F(HistoryTokenizerDictionaryTest, TermsUseTheLongestDictionaryWord) {
+    HistoryTokens tokens = tokenizer.tokenize("如何学习机器学习算法");
+    // 词典未覆盖的片段退化为二元组
+    EXPECT_EQ(tokens.terms, (std::vector<std::string>{"如何", "学习", "机器学习", "算法"}));
+    EXPECT_EQ(HistoryTokenizer::join(tokens.grams), "如何 何学 学习 习机 机器 器学 学习 习算 算法 法");
+
+    tokens = tokenizer.tokenize("Python 机器学习入门教程");
+    EXPECT_EQ(tokens.terms, (std::vector<std::string>{"python", "机器学习", "入门", "教程"}));
+
+    EXPECT_EQ(tokenizer.buildMatchQuery("机器学习"),
+              "(grams : \"机器 器学 学习\" OR terms : \"机器学习\")");
+}
+
+TEST_F(HistoryTokenizerDictionaryTest, DictionaryWordsAndSubstringsBothMatch) {
+    EXPECT_EQ(index.search("机器学习"), (Rowids{1, 3}));
+    EXPECT_EQ(index.search("天气预报"), (Rowids{5}));
+
+    // 子串跨越词典词的边界，仍由二元组短语命中
+    EXPECT_EQ(index.search("器学"), (Rowids{1, 3}));
+    EXPECT_EQ(index.search("习入门"), (Rowids{3}));
+    EXPECT_EQ(index.search("python 入门"), (Rowids{3}));
+}
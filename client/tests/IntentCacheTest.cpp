@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "core/api/IntentCache.h"
+
+using IntelliSearch::IntentCache;
+
+TEST(IntentCacheTest, ExactHitAfterNormalization) {
+    IntentCache cache(16, std::chrono::seconds(60), 3, 0.8);
+    nlohmann::json intent = {{"intent_type", "weather"}};
+    cache.store("北京 天气", intent, 120.0);
+
+    nlohmann::json result;
+    EXPECT_TRUE(cache.lookup("北京 天气", result));
+    EXPECT_EQ(result, intent);
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.exactHits, 1u);
+    EXPECT_EQ(stats.size, 1u);
+    EXPECT_DOUBLE_EQ(stats.savedLatencyMs, 120.0);
+}
+
+TEST(IntentCacheTest, NearHitForSimilarInput) {
+    IntentCache cache(16, std::chrono::seconds(60), 64, 0.5);
+    nlohmann::json intent = {{"intent_type", "weather"}};
+    cache.store("今天北京的天气怎么样", intent, 80.0);
+
+    nlohmann::json result;
+    EXPECT_TRUE(cache.lookup("今天北京天气怎么样", result));
+    EXPECT_EQ(result, intent);
+    EXPECT_EQ(cache.getStats().nearHits, 1u);
+}
+
+TEST(IntentCacheTest, DifferentNumbersNeverShareAnEntry) {
+    IntentCache cache(16, std::chrono::seconds(60), 64, 0.5);
+    cache.store("2023年北京马拉松报名时间和路线安排", {{"query", "2023"}}, 80.0);
+
+    nlohmann::json result;
+    EXPECT_FALSE(cache.lookup("2024年北京马拉松报名时间和路线安排", result));
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_GE(stats.collisions, 1u);
+}
+
+TEST(IntentCacheTest, UnrelatedInputMisses) {
+    IntentCache cache(16, std::chrono::seconds(60), 3, 0.8);
+    cache.store("北京天气", {{"intent_type", "weather"}}, 80.0);
+
+    nlohmann::json result;
+    EXPECT_FALSE(cache.lookup("上海美食推荐", result));
+    EXPECT_EQ(cache.getStats().misses, 1u);
+}
+
+TEST(IntentCacheTest, EvictsLeastRecentlyUsed) {
+    IntentCache cache(2, std::chrono::seconds(60), 0, 1.0);
+    cache.store("query one", {{"id", 1}}, 1.0);
+    cache.store("query two", {{"id", 2}}, 1.0);
+
+    nlohmann::json result;
+    ASSERT_TRUE(cache.lookup("query one", result));
+    cache.store("query three", {{"id", 3}}, 1.0);
+
+    EXPECT_TRUE(cache.lookup("query one", result));
+    EXPECT_FALSE(cache.lookup("query two", result));
+    EXPECT_TRUE(cache.lookup("query three", result));
+    EXPECT_EQ(cache.getStats().size, 2u);
+}
+
+TEST(IntentCacheTest, ExpiredEntriesMiss) {
+    IntentCache cache(16, std::chrono::seconds(0), 3, 0.8);
+    cache.store("北京天气", {{"intent_type", "weather"}}, 80.0);
+
+    nlohmann::json result;
+    EXPECT_FALSE(cache.lookup("北京天气", result));
+    EXPECT_EQ(cache.getStats().size, 0u);
+}
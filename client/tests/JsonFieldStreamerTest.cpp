@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "core/utils/JsonFieldStreamer.h"
+
+using IntelliSearch::JsonFieldStreamer;
+
+namespace {
+
+const std::string kReplacement = "\xEF\xBF\xBD";
+
+std::string streamWhole(const std::string& json) {
+    JsonFieldStreamer streamer("result");
+    return streamer.feed(json);
+}
+
+// 在 split 处把 JSON 切成两段输入
+std::string streamSplit(const std::string& json, size_t split) {
+    JsonFieldStreamer streamer("result");
+    std::string out = streamer.feed(json.substr(0, split));
+    out += streamer.feed(json.substr(split));
+    EXPECT_TRUE(streamer.isCompleted());
+    return out;
+}
+
+std::string streamByteByByte(const std::string& json) {
+    JsonFieldStreamer streamer("result");
+    std::string out;
+    for (char c : json) {
+        out += streamer.feed(std::string(1, c));
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(JsonFieldStreamerTest, DecodesEscapesAndPassesUtf8Through) {
+    EXPECT_EQ(streamWhole(R"({"result":"line\none \"quoted\" \\ \/ \t"})"), "line\none \"quoted\" \\ / \t");
+    EXPECT_EQ(streamWhole(R"({"result":"北京\u4e2d\u6587 😀 \uD83D\uDE00"})"), "北京中文 😀 😀");
+}
+
+TEST(JsonFieldStreamerTest, ChunkBoundaryAtEveryByte) {
+    // 覆盖原样透传的多字节字符、\uXXXX、代理对与简单转义
+    const std::string json = R"({"result":"中😀\u4e2d\ud83d\ude00\n\"\u00e9"})";
+    const std::string expected = "中😀中😀\n\"é";
+    ASSERT_EQ(streamWhole(json), expected);
+
+    for (size_t split = 0; split <= json.size(); ++split) {
+        EXPECT_EQ(streamSplit(json, split), expected) << "split at byte " << split;
+    }
+    EXPECT_EQ(streamByteByByte(json), expected);
+}
+
+TEST(JsonFieldStreamerTest, IgnoresNestedFieldWithTheSameName) {
+    const std::string json = R"({"meta":{"result":"inner","list":["result"]},"result":"outer"})";
+    EXPECT_EQ(streamWhole(json), "outer");
+    EXPECT_EQ(streamByteByByte(json), "outer");
+}
+
+TEST(JsonFieldStreamerTest, FieldAfterOtherKeys) {
+    JsonFieldStreamer streamer("result");
+    EXPECT_EQ(streamer.feed(R"({"intent":"search","score":0.9,"items":[1,{"result":"no"}],)"), "");
+    EXPECT_FALSE(streamer.isCompleted());
+    EXPECT_EQ(streamer.feed(R"("note":"result","result":"yes")"), "yes");
+    EXPECT_TRUE(streamer.isCompleted());
+    EXPECT_EQ(streamer.feed(R"(,"after":"ignored"})"), "");
+
+    // 字段值不是字符串时不输出
+    JsonFieldStreamer numeric("result");
+    EXPECT_EQ(numeric.feed(R"({"result":42,"other":"text"})"), "");
+    EXPECT_FALSE(numeric.isCompleted());
+}
+
+TEST(JsonFieldStreamerTest, MalformedUnicodeEscapeBecomesReplacementCharacter) {
+    EXPECT_EQ(streamWhole(R"({"result":"a\u12G4b"})"), "a" + kReplacement + "G4b");
+    // 结束引号打断 \u 时字段仍正常结束
+    JsonFieldStreamer streamer("result");
+    EXPECT_EQ(streamer.feed(R"({"result":"a\u4e"})"), "a" + kReplacement);
+    EXPECT_TRUE(streamer.isCompleted());
+    // 非法字符跨分段
+    EXPECT_EQ(streamSplit(R"({"result":"a\u4eZz"})", 15), "a" + kReplacement + "Zz");
+}
+
+TEST(JsonFieldStreamerTest, UnpairedSurrogatesBecomeReplacementCharacters) {
+    // 高代理项后跟普通字符、非低代理项的转义、简单转义或结束引号
+    EXPECT_EQ(streamWhole(R"({"result":"\ud83dx"})"), kReplacement + "x");
+    EXPECT_EQ(streamWhole(R"({"result":"\ud83d\u0041"})"), kReplacement + "A");
+    EXPECT_EQ(streamWhole(R"({"result":"\ud83d\n"})"), kReplacement + "\n");
+    EXPECT_EQ(streamWhole(R"({"result":"\ud83d"})"), kReplacement);
+    // 连续两个高代理项，第二个与随后的低代理项成对
+    EXPECT_EQ(streamWhole(R"({"result":"\ud83d\ud83d\ude00"})"), kReplacement + "😀");
+    // 单独的低代理项
+    EXPECT_EQ(streamWhole(R"({"result":"\ude00x"})"), kReplacement + "x");
+}
+
+TEST(JsonFieldStreamerTest, UnknownEscapeBecomesReplacementCharacter) {
+    EXPECT_EQ(streamWhole(R"({"result":"a\qb"})"), "a" + kReplacement + "qb");
+    EXPECT_EQ(streamWhole(R"({"result":"\中"})"), kReplacement + "中");
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "data/database/PayloadCodec.h"
+
+using IntelliSearch::PayloadCodec;
+
+namespace {
+
+// 结构与搜索结果 JSON 相近的样本，键名与模板内容高度重复
+std::string searchResultSample(int index) {
+    std::string pages;
+    for (int page = 0; page < 4; ++page) {
+        std::string n = std::to_string(index * 10 + page);
+        pages += std::string(pages.empty() ? "" : ",") + R"({"title":"第)" + n + R"(条搜索结果的标题","url":"https://example.com/articles/)" +
+                 n + R"(","snippet":"这是一段关于查询 )" + n + R"( 的网页摘要，包含若干重复出现的描述文字。","siteName":"示例站点","date":"2026-10-)" +
+                 std::to_string(page + 10) + R"("})";
+    }
+    return R"({"query":"查询)" + std::to_string(index) + R"(","webPages":[)" + pages + "]}";
+}
+
+std::vector<std::string> trainingSamples(int count) {
+    std::vector<std::string> samples;
+    for (int i = 0; i < count; ++i) {
+        samples.push_back(searchResultSample(i));
+    }
+    return samples;
+}
+
+} // namespace
+
+TEST(PayloadCodecTest, RoundTripWithoutDictionary) {
+    PayloadCodec codec;
+    std::string text = searchResultSample(1);
+    std::string frame = codec.compress(text);
+
+    EXPECT_EQ(PayloadCodec::frameDictionaryId(frame), 0u);
+    EXPECT_EQ(codec.decompress(frame), text);
+    EXPECT_EQ(codec.decompress(codec.compress("")), "");
+}
+
+TEST(PayloadCodecTest, DictionaryFramesCarryTheDictionaryId) {
+    std::string dictionary = PayloadCodec::trainDictionary(trainingSamples(200), 16 * 1024);
+    ASSERT_FALSE(dictionary.empty());
+
+    PayloadCodec codec;
+    uint32_t id = codec.addDictionary(dictionary);
+    ASSERT_NE(id, 0u);
+    EXPECT_EQ(codec.addDictionary(dictionary), id);
+    codec.setActiveDictionary(id);
+
+    std::string text = searchResultSample(500);
+    std::string frame = codec.compress(text);
+    EXPECT_EQ(PayloadCodec::frameDictionaryId(frame), id);
+    EXPECT_LT(frame.size(), PayloadCodec().compress(text).size());
+    EXPECT_EQ(codec.decompress(frame), text);
+}
+
+TEST(PayloadCodecTest, FrameWithUnloadedDictionaryThrowsUntilLoaded) {
+    std::string dictionary = PayloadCodec::trainDictionary(trainingSamples(200), 16 * 1024);
+    ASSERT_FALSE(dictionary.empty());
+
+    PayloadCodec writer;
+    uint32_t id = writer.addDictionary(dictionary);
+    writer.setActiveDictionary(id);
+    std::string text = searchResultSample(7);
+    std::string frame = writer.compress(text);
+
+    PayloadCodec reader;
+    EXPECT_FALSE(reader.hasDictionary(id));
+    EXPECT_THROW(reader.decompress(frame), std::runtime_error);
+
+    EXPECT_EQ(reader.addDictionary(dictionary), id);
+    EXPECT_EQ(reader.decompress(frame), text);
+}
+
+TEST(PayloadCodecTest, CorruptFrameThrows) {
+    PayloadCodec codec;
+    std::string frame = codec.compress(searchResultSample(3));
+    std::string truncated = frame.substr(0, frame.size() / 2);
+
+    EXPECT_THROW(codec.decompress(truncated), std::runtime_error);
+    EXPECT_THROW(codec.decompress("not a zstd frame"), std::runtime_error);
+}
+
+TEST(PayloadCodecTest, TooFewSamplesYieldNoDictionary) {
+    EXPECT_TRUE(PayloadCodec::trainDictionary(trainingSamples(3), 16 * 1024).empty());
+}
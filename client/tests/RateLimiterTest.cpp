@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/api/RateLimiter.h"
+
+using namespace IntelliSearch;
+
+namespace {
+
+// 调度线程可能仍登记着限流器的检查时间，测试创建的限流器在进程退出前不释放
+RateLimiter* makeLimiter(const std::string& name, RateLimits limits) {
+    static auto* limiters = new std::vector<std::unique_ptr<RateLimiter>>();
+    limiters->push_back(std::make_unique<RateLimiter>(name, limits, RateLimiterRegistry::getInstance()));
+    return limiters->back().get();
+}
+
+} // namespace
+
+TEST(RateLimiterTest, GrantsBurstImmediatelyAndQueuesTheRest) {
+    RateLimits limits;
+    limits.requestsPerMinute = 600;   // 每 100 ms 补充一个令牌
+    limits.burst = 2;
+    RateLimiter* limiter = makeLimiter("test_burst", limits);
+
+    std::atomic<int> granted{0};
+    limiter->submit([&]() { ++granted; }, nullptr);
+    limiter->submit([&]() { ++granted; }, nullptr);
+    EXPECT_EQ(granted.load(), 2);
+
+    std::promise<void> queuedGrant;
+    auto start = std::chrono::steady_clock::now();
+    uint64_t ticket = limiter->submit([&]() { queuedGrant.set_value(); }, nullptr);
+    EXPECT_NE(ticket, 0u);
+    EXPECT_EQ(limiter->getStats().queued, 1u);
+
+    auto future = queuedGrant.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+
+    auto stats = limiter->getStats();
+    EXPECT_EQ(stats.granted, 3u);
+    EXPECT_EQ(stats.delayed, 1u);
+    EXPECT_EQ(stats.queued, 0u);
+}
+
+TEST(RateLimiterTest, ReleaseGrantsNextWaiterUnderConcurrencyLimit) {
+    RateLimits limits;
+    limits.maxConcurrent = 1;
+    RateLimiter* limiter = makeLimiter("test_concurrency", limits);
+
+    bool first = false;
+    bool second = false;
+    limiter->submit([&]() { first = true; }, nullptr);
+    limiter->submit([&]() { second = true; }, nullptr);
+    EXPECT_TRUE(first);
+    EXPECT_FALSE(second);
+    EXPECT_EQ(limiter->getStats().inFlight, 1u);
+
+    limiter->release();
+    EXPECT_TRUE(second);
+    EXPECT_EQ(limiter->getStats().inFlight, 1u);
+    limiter->release();
+    EXPECT_EQ(limiter->getStats().inFlight, 0u);
+}
+
+TEST(RateLimiterTest, RejectsWhenQueueIsFull) {
+    RateLimits limits;
+    limits.maxConcurrent = 1;
+    limits.maxQueueLength = 1;
+    RateLimiter* limiter = makeLimiter("test_queue_full", limits);
+
+    limiter->submit([]() {}, nullptr);
+    limiter->submit([]() {}, nullptr);
+
+    std::string reason;
+    uint64_t ticket = limiter->submit([]() { FAIL() << "should not be granted"; },
+                                      [&](const std::string& message) { reason = message; });
+    EXPECT_EQ(ticket, 0u);
+    EXPECT_NE(reason.find("test_queue_full"), std::string::npos);
+    EXPECT_EQ(limiter->getStats().rejected, 1u);
+}
+
+TEST(RateLimiterTest, QueuedRequestTimesOut) {
+    RateLimits limits;
+    limits.maxConcurrent = 1;
+    limits.maxQueueTime = std::chrono::milliseconds(50);
+    RateLimiter* limiter = makeLimiter("test_timeout", limits);
+
+    limiter->submit([]() {}, nullptr);
+    std::promise<std::string> rejected;
+    limiter->submit([]() {}, [&](const std::string& message) { rejected.set_value(message); });
+
+    auto future = rejected.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    EXPECT_FALSE(future.get().empty());
+    EXPECT_EQ(limiter->getStats().timedOut, 1u);
+    EXPECT_EQ(limiter->getStats().queued, 0u);
+}
+
+TEST(RateLimiterTest, CancelledRequestLeavesTheQueue) {
+    RateLimits limits;
+    limits.maxConcurrent = 1;
+    RateLimiter* limiter = makeLimiter("test_cancel", limits);
+
+    limiter->submit([]() {}, nullptr);
+    bool granted = false;
+    uint64_t ticket = limiter->submit([&]() { granted = true; }, nullptr);
+    ASSERT_NE(ticket, 0u);
+
+    EXPECT_TRUE(limiter->cancel(ticket));
+    EXPECT_FALSE(limiter->cancel(ticket));
+    limiter->release();
+    EXPECT_FALSE(granted);
+
+    auto stats = limiter->getStats();
+    EXPECT_EQ(stats.cancelled, 1u);
+    EXPECT_EQ(stats.queued, 0u);
+    EXPECT_EQ(stats.inFlight, 0u);
+}
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/engine/SearchResultCache.h"
+
+using IntelliSearch::SearchResultCache;
+using Freshness = SearchResultCache::Freshness;
+
+namespace {
+
+constexpr std::chrono::milliseconds kTtl(50);
+constexpr std::chrono::milliseconds kStaleTtl(200);
+
+void waitFor(std::chrono::milliseconds duration) {
+    std::this_thread::sleep_for(duration);
+}
+
+// 与 SearchResultCache::shardFor 相同的分片规则，取落在 shard 分片上的前 count 个键
+std::vector<std::string> keysInShard(size_t shard, size_t shardCount, size_t count) {
+    std::vector<std::string> keys;
+    for (int i = 0; keys.size() < count; ++i) {
+        std::string key = "query-" + std::to_string(i);
+        if (std::hash<std::string>{}(key) % shardCount == shard) {
+            keys.push_back(key);
+        }
+    }
+    return keys;
+}
+
+} // namespace
+
+TEST(SearchResultCacheTest, FreshHitAndMiss) {
+    SearchResultCache cache(16, 4, kTtl, kStaleTtl);
+    EXPECT_EQ(cache.get("北京天气").freshness, Freshness::Miss);
+
+    cache.put("北京天气", {{"answer", "晴"}});
+    auto lookup = cache.get("北京天气");
+    EXPECT_EQ(lookup.freshness, Freshness::Fresh);
+    EXPECT_EQ(lookup.value["answer"], "晴");
+    EXPECT_FALSE(lookup.shouldRefresh);
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.size, 1u);
+}
+
+TEST(SearchResultCacheTest, EntryExpiresAfterTtlAndStaleWindow) {
+    SearchResultCache cache(16, 4, kTtl, kStaleTtl);
+    cache.put("key", "old");
+
+    waitFor(kTtl + std::chrono::milliseconds(20));
+    auto stale = cache.get("key");
+    EXPECT_EQ(stale.freshness, Freshness::Stale);
+    EXPECT_EQ(stale.value, "old");
+
+    waitFor(kStaleTtl);
+    EXPECT_EQ(cache.get("key").freshness, Freshness::Miss);
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.staleHits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.size, 0u);
+}
+
+TEST(SearchResultCacheTest, StaleWindowRequestsOneRefreshUntilPut) {
+    SearchResultCache cache(16, 4, kTtl, kStaleTtl);
+    cache.put("key", "old");
+    waitFor(kTtl + std::chrono::milliseconds(20));
+
+    EXPECT_TRUE(cache.get("key").shouldRefresh);
+    EXPECT_FALSE(cache.get("key").shouldRefresh);
+    EXPECT_FALSE(cache.get("key").shouldRefresh);
+    EXPECT_EQ(cache.getStats().refreshes, 1u);
+    EXPECT_EQ(cache.getStats().staleHits, 3u);
+
+    // 刷新写回后重新计时，下一个过期窗口再刷新一次
+    cache.put("key", "new");
+    auto fresh = cache.get("key");
+    EXPECT_EQ(fresh.freshness, Freshness::Fresh);
+    EXPECT_EQ(fresh.value, "new");
+    waitFor(kTtl + std::chrono::milliseconds(20));
+    EXPECT_TRUE(cache.get("key").shouldRefresh);
+    EXPECT_EQ(cache.getStats().refreshes, 2u);
+}
+
+TEST(SearchResultCacheTest, ConcurrentStaleLookupsRequestOneRefresh) {
+    SearchResultCache cache(16, 4, kTtl, kStaleTtl);
+    cache.put("key", "old");
+    waitFor(kTtl + std::chrono::milliseconds(20));
+
+    std::atomic<int> refreshRequests{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&]() {
+            for (int j = 0; j < 50; ++j) {
+                if (cache.get("key").shouldRefresh) {
+                    ++refreshRequests;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(refreshRequests.load(), 1);
+    EXPECT_EQ(cache.getStats().refreshes, 1u);
+}
+
+TEST(SearchResultCacheTest, AbandonedRefreshIsRequestedAgain) {
+    SearchResultCache cache(16, 4, kTtl, kStaleTtl);
+    cache.put("key", "old");
+    waitFor(kTtl + std::chrono::milliseconds(20));
+
+    ASSERT_TRUE(cache.get("key").shouldRefresh);
+    cache.abandonRefresh("key");
+    auto retry = cache.get("key");
+    EXPECT_TRUE(retry.shouldRefresh);
+    EXPECT_EQ(retry.value, "old");
+    EXPECT_FALSE(cache.get("key").shouldRefresh);
+    EXPECT_EQ(cache.getStats().refreshes, 2u);
+
+    // 不存在的键不受影响
+    cache.abandonRefresh("missing");
+    EXPECT_EQ(cache.get("missing").freshness, Freshness::Miss);
+}
+
+TEST(SearchResultCacheTest, EvictsLeastRecentlyUsedWithinEachShard) {
+    // 容量 4、两个分片，每个分片最多 2 条
+    SearchResultCache cache(4, 2, kTtl * 100, kStaleTtl);
+    auto first = keysInShard(0, 2, 3);
+    auto second = keysInShard(1, 2, 1);
+
+    cache.put(second[0], 0);
+    cache.put(first[0], 1);
+    cache.put(first[1], 2);
+    // 访问使 first[0] 成为最近使用，first[1] 被淘汰
+    EXPECT_EQ(cache.get(first[0]).freshness, Freshness::Fresh);
+    cache.put(first[2], 3);
+
+    // 总条目数未超过总容量，淘汰只发生在满的分片内
+    EXPECT_EQ(cache.get(first[1]).freshness, Freshness::Miss);
+    EXPECT_EQ(cache.get(first[0]).freshness, Freshness::Fresh);
+    EXPECT_EQ(cache.get(first[2]).freshness, Freshness::Fresh);
+    EXPECT_EQ(cache.get(second[0]).freshness, Freshness::Fresh);
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(stats.size, 3u);
+
+    // 更新已有的键不淘汰
+    cache.put(first[0], 4);
+    EXPECT_EQ(cache.getStats().evictions, 1u);
+    EXPECT_EQ(cache.get(first[0]).value, 4);
+}
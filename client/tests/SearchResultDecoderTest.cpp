@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "core/api/SearchService/SearchResultDecoder.h"
+
+using namespace IntelliSearch;
+
+namespace {
+
+// 与 Bocha::fetchResultsAsync 使用的字段布局相同
+const SearchResultSchema& bochaSchema() {
+    static const SearchResultSchema schema = {
+        {"data", "webPages", "value", "*"},
+        {
+            {"name", &WebPageResult::title},
+            {"url", &WebPageResult::url},
+            {"snippet", &WebPageResult::snippet},
+            {"siteName", &WebPageResult::siteName},
+            {"dateLastCrawled", &WebPageResult::date}
+        },
+        {"data", "images", "value", "*"},
+        {
+            {"thumbnailUrl", &ImageResult::thumbnailUrl},
+            {"contentUrl", &ImageResult::contentUrl}
+        },
+        {"data", "webPages", "someResultsRemoved"},
+        "data"
+    };
+    return schema;
+}
+
+} // namespace
+
+TEST(SearchResultDecoderTest, DecodesPagesImagesAndFilteredFlag) {
+    std::string body = R"({
+        "code": 200,
+        "data": {
+            "webPages": {
+                "someResultsRemoved": true,
+                "value": [
+                    {"name": "标题一", "url": "https://a.com", "snippet": "摘要", "siteName": "A",
+                     "dateLastCrawled": "2026-10-01", "extra": {"name": "ignored"}, "rank": 1},
+                    {"name": "Title 2", "url": "https://b.com", "snippet": null}
+                ]
+            },
+            "images": {"value": [{"thumbnailUrl": "t", "contentUrl": "c", "width": 10}]}
+        }
+    })";
+
+    auto results = SearchResultDecoder::decode(body, bochaSchema());
+    ASSERT_EQ(results.webPages.size(), 2u);
+    EXPECT_EQ(results.webPages[0].title, "标题一");
+    EXPECT_EQ(results.webPages[0].url, "https://a.com");
+    EXPECT_EQ(results.webPages[0].snippet, "摘要");
+    EXPECT_EQ(results.webPages[0].siteName, "A");
+    EXPECT_EQ(results.webPages[0].date, "2026-10-01");
+    EXPECT_EQ(results.webPages[1].title, "Title 2");
+    EXPECT_TRUE(results.webPages[1].snippet.empty());
+    ASSERT_EQ(results.images.size(), 1u);
+    EXPECT_EQ(results.images[0].thumbnailUrl, "t");
+    EXPECT_EQ(results.images[0].contentUrl, "c");
+    EXPECT_TRUE(results.hasFilteredResults);
+}
+
+TEST(SearchResultDecoderTest, EmptyResultListIsValid) {
+    auto results = SearchResultDecoder::decode(R"({"data": {"webPages": {"value": []}}})", bochaSchema());
+    EXPECT_TRUE(results.webPages.empty());
+    EXPECT_TRUE(results.images.empty());
+    EXPECT_FALSE(results.hasFilteredResults);
+}
+
+TEST(SearchResultDecoderTest, RejectsMissingRootObject) {
+    EXPECT_THROW(SearchResultDecoder::decode(R"({"code": 401, "message": "invalid key"})", bochaSchema()),
+                 std::runtime_error);
+    EXPECT_THROW(SearchResultDecoder::decode(R"({"data": null})", bochaSchema()), std::runtime_error);
+}
+
+TEST(SearchResultDecoderTest, RejectsMalformedJson) {
+    EXPECT_THROW(SearchResultDecoder::decode(R"({"data": {"webPages": )", bochaSchema()), std::runtime_error);
+    EXPECT_THROW(SearchResultDecoder::decode("", bochaSchema()), std::runtime_error);
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include "core/api/SearchResultMerger.h"
+
+using namespace IntelliSearch;
+
+namespace {
+
+WebPageResult page(const std::string& title, const std::string& url, const std::string& snippet) {
+    WebPageResult result;
+    result.title = title;
+    result.url = url;
+    result.snippet = snippet;
+    return result;
+}
+
+ProviderSearchResults provider(const std::string& name, double weight, std::vector<WebPageResult> pages) {
+    ProviderSearchResults result;
+    result.provider = name;
+    result.weight = weight;
+    result.results.webPages = std::move(pages);
+    return result;
+}
+
+} // namespace
+
+TEST(SearchResultMergerTest, RanksByWeightedScore) {
+    auto merged = SearchResultMerger::merge(
+        {provider("bocha", 1.0, {page("a", "https://a.com/1", "alpha"), page("b", "https://b.com/1", "beta")}),
+         provider("exa", 0.8, {page("c", "https://c.com/1", "gamma")})},
+        MergeOptions());
+
+    ASSERT_EQ(merged.webPages.size(), 3u);
+    EXPECT_EQ(merged.webPages[0].title, "a");   // 1.0
+    EXPECT_EQ(merged.webPages[1].title, "c");   // 0.8
+    EXPECT_EQ(merged.webPages[2].title, "b");   // 0.5
+}
+
+TEST(SearchResultMergerTest, DeduplicatesNormalizedUrlsAndAccumulatesScore) {
+    auto merged = SearchResultMerger::merge(
+        {provider("bocha", 1.0, {page("first", "https://a.com/x", "alpha"), page("dup", "https://b.com/y", "short")}),
+         provider("exa", 1.0, {page("dup", "http://www.B.com/y/#top", "a much longer snippet")})},
+        MergeOptions());
+
+    ASSERT_EQ(merged.webPages.size(), 2u);
+    // 0.5 + 1.0 超过 a.com 的 1.0
+    EXPECT_EQ(merged.webPages[0].url, "https://b.com/y");
+    EXPECT_EQ(merged.webPages[0].snippet, "a much longer snippet");
+    EXPECT_EQ(merged.webPages[1].url, "https://a.com/x");
+}
+
+TEST(SearchResultMergerTest, DeduplicatesSimilarSnippets) {
+    std::string snippet = "北京今天晴转多云，最高气温二十五度，最低气温十五度，空气质量良好";
+    auto merged = SearchResultMerger::merge(
+        {provider("bocha", 1.0, {page("a", "https://a.com/weather", snippet)}),
+         provider("exa", 1.0, {page("b", "https://mirror.com/weather", snippet + "。")})},
+        MergeOptions());
+
+    ASSERT_EQ(merged.webPages.size(), 1u);
+    EXPECT_EQ(merged.webPages[0].url, "https://a.com/weather");
+}
+
+TEST(SearchResultMergerTest, RespectsResultLimits) {
+    std::vector<WebPageResult> pages;
+    for (int i = 0; i < 5; ++i) {
+        pages.push_back(page("p" + std::to_string(i), "https://a.com/" + std::to_string(i),
+                             "snippet number " + std::to_string(i) + " " + std::string(i + 1, 'x')));
+    }
+    MergeOptions options;
+    options.maxResultsPerProvider = 3;
+    options.maxResults = 2;
+
+    auto merged = SearchResultMerger::merge({provider("bocha", 1.0, pages)}, options);
+    ASSERT_EQ(merged.webPages.size(), 2u);
+    EXPECT_EQ(merged.webPages[0].title, "p0");
+    EXPECT_EQ(merged.webPages[1].title, "p1");
+}
+
+TEST(SearchResultMergerTest, MergesImagesAndFilteredFlag) {
+    auto first = provider("bocha", 1.0, {});
+    first.results.images.push_back({"thumb1", "https://img.com/1.png"});
+    auto second = provider("exa", 1.0, {});
+    second.results.images.push_back({"thumb1b", "https://img.com/1.png"});
+    second.results.images.push_back({"thumb2", "https://img.com/2.png"});
+    second.results.hasFilteredResults = true;
+
+    auto merged = SearchResultMerger::merge({first, second}, MergeOptions());
+    ASSERT_EQ(merged.images.size(), 2u);
+    EXPECT_EQ(merged.images[0].thumbnailUrl, "thumb1");
+    EXPECT_TRUE(merged.hasFilteredResults);
+}
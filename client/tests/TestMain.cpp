@@ -0,0 +1,32 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 单元测试入口。先创建 QCoreApplication（加载 SQLite 驱动插件需要），
+ *              再加载测试专用配置并把日志写到临时目录，最后运行全部用例
+ */
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QDir>
+
+#include "log/Logger.h"
+#include "config/ConfigManager.h"
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+
+    ConfigManager::getInstance()->init(INTELLISEARCH_TEST_CONFIG);
+
+    LogConfig logConfig;
+    logConfig.logLevel = "warn";
+    logConfig.logPath = QDir::temp().filePath("intellisearch_tests/tests.log").toStdString();
+    logConfig.consoleOutput = false;
+    logConfig.maxFileSize = 1024 * 1024;
+    logConfig.maxFiles = 1;
+    INITLOG(logConfig);
+
+    return RUN_ALL_TESTS();
+}
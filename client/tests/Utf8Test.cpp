@@ -0,0 +1,242 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/utils/TextUtils.h"
+#include "core/utils/Utf8.h"
+
+using namespace IntelliSearch;
+
+namespace {
+
+// 校验结果必须与标量实现一致，返回 SIMD 实现（长度不足时为标量实现）的结果
+bool checkedIsValid(const std::string& text) {
+    bool expected = Utf8::isValidScalar(text.data(), text.size());
+    bool actual = Utf8::isValid(text);
+    EXPECT_EQ(actual, expected) << "implementation " << Utf8::activeImplementation() << " disagrees on "
+                                << ::testing::PrintToString(text);
+    return actual;
+}
+
+std::string encode(uint32_t codePoint) {
+    std::string out;
+    if (codePoint < 0x80) {
+        out += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codePoint >> 6));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codePoint >> 18));
+        out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+    return out;
+}
+
+// 把 sequence 放在 ASCII 填充中，使其恰好结束于 end（不含），之后再填充到 totalLength
+std::string placeEndingAt(const std::string& sequence, size_t end, size_t totalLength) {
+    std::string text(end - sequence.size(), 'a');
+    text += sequence;
+    if (totalLength > text.size()) {
+        text.append(totalLength - text.size(), 'b');
+    }
+    return text;
+}
+
+// 向量实现按 16 / 32 字节分块，这些位置正好位于块的末尾附近
+const std::vector<size_t>& blockEdgeEnds() {
+    static const std::vector<size_t> ends = {13, 14, 15, 16, 29, 30, 31, 32, 45, 46, 47, 48, 61, 62, 63, 64};
+    return ends;
+}
+
+const std::vector<std::string>& invalidSequences() {
+    static const std::vector<std::string> sequences = {
+        "\xC0\x80", "\xC1\xBF",                             // 两字节过长编码
+        "\xE0\x80\x80", "\xE0\x9F\xBF",                     // 三字节过长编码
+        "\xF0\x80\x80\x80", "\xF0\x8F\xBF\xBF",             // 四字节过长编码
+        "\xED\xA0\x80", "\xED\xAF\xBF", "\xED\xBF\xBF",     // 代理区 U+D800..U+DFFF
+        "\xF4\x90\x80\x80", "\xF4\xBF\xBF\xBF",             // U+110000 及以上
+        "\xF5\x80\x80\x80", "\xF7\xBF\xBF\xBF",             // 超出范围的前导字节
+        "\xF8\x88\x80\x80\x80", "\xFE", "\xFF",
+        "\x80", "\xBF",                                     // 单独的后续字节
+        "\xC3\xA9\xA9",                                     // 多余的后续字节
+    };
+    return sequences;
+}
+
+// 各长度编码的最小与最大码点，以及代理区两侧
+const std::vector<std::pair<std::string, uint32_t>>& boundarySequences() {
+    static const std::vector<std::pair<std::string, uint32_t>> sequences = {
+        {"\xC2\x80", 0x80}, {"\xDF\xBF", 0x7FF},
+        {"\xE0\xA0\x80", 0x800}, {"\xED\x9F\xBF", 0xD7FF},
+        {"\xEE\x80\x80", 0xE000}, {"\xEF\xBF\xBF", 0xFFFF},
+        {"\xF0\x90\x80\x80", 0x10000}, {"\xF4\x8F\xBF\xBF", 0x10FFFF},
+    };
+    return sequences;
+}
+
+// TextUtils 解码后重新编码的结果
+std::string reencode(const std::string& text) {
+    std::string out;
+    for (uint32_t codePoint : TextUtils::decodeUtf8(text)) {
+        TextUtils::appendUtf8(out, codePoint);
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(Utf8Test, AcceptsCommonText) {
+    EXPECT_TRUE(checkedIsValid(""));
+    EXPECT_TRUE(checkedIsValid("plain ascii text"));
+    EXPECT_TRUE(checkedIsValid("搜索结果：北京今天晴，最高气温 25°C 😀"));
+    EXPECT_TRUE(checkedIsValid(std::string(100, 'x') + "中文" + std::string(100, 'y')));
+}
+
+TEST(Utf8Test, TruncatedSequencesAtBlockEdges) {
+    const std::vector<std::string> sequences = {encode(0xE9), encode(0x4E2D), encode(0x1F600)};
+    for (const auto& sequence : sequences) {
+        for (size_t end : blockEdgeEnds()) {
+            // 完整序列在同一位置合法，保证下面的失败确实来自截断
+            EXPECT_TRUE(checkedIsValid(placeEndingAt(sequence, end, end))) << "end " << end;
+            EXPECT_TRUE(checkedIsValid(placeEndingAt(sequence, end, 96))) << "end " << end;
+
+            for (size_t kept = 1; kept < sequence.size(); ++kept) {
+                std::string truncated = sequence.substr(0, kept);
+                // 截断的序列位于输入末尾
+                EXPECT_FALSE(checkedIsValid(placeEndingAt(truncated, end, end)))
+                    << sequence.size() << "-byte sequence cut to " << kept << " bytes, ending at " << end;
+                // 截断的序列后跟 ASCII
+                EXPECT_FALSE(checkedIsValid(placeEndingAt(truncated, end, 96)))
+                    << sequence.size() << "-byte sequence cut to " << kept << " bytes, ending at " << end
+                    << ", followed by ASCII";
+                // 截断的序列后跟另一个完整的多字节序列
+                EXPECT_FALSE(checkedIsValid(placeEndingAt(truncated, end, end) + sequence + std::string(40, 'c')))
+                    << sequence.size() << "-byte sequence cut to " << kept << " bytes, ending at " << end
+                    << ", followed by a lead byte";
+            }
+        }
+    }
+}
+
+TEST(Utf8Test, RejectsOverlongSurrogateAndOutOfRange) {
+    for (size_t offset = 0; offset < 64; ++offset) {
+        for (const auto& sequence : invalidSequences()) {
+            std::string text = std::string(offset, 'a') + sequence + std::string(64, 'b');
+            EXPECT_FALSE(checkedIsValid(text)) << ::testing::PrintToString(sequence) << " at offset " << offset;
+        }
+        for (const auto& [sequence, codePoint] : boundarySequences()) {
+            std::string text = std::string(offset, 'a') + sequence + std::string(64, 'b');
+            EXPECT_TRUE(checkedIsValid(text)) << ::testing::PrintToString(sequence) << " at offset " << offset;
+        }
+    }
+}
+
+TEST(Utf8Test, TextUtilsDecodesOnlyValidSequences) {
+    for (const auto& [sequence, codePoint] : boundarySequences()) {
+        EXPECT_EQ(TextUtils::decodeUtf8(sequence), std::vector<uint32_t>{codePoint})
+            << ::testing::PrintToString(sequence);
+        EXPECT_EQ(reencode("a" + sequence + "b"), "a" + sequence + "b");
+    }
+
+    // 非法序列的字节按 Latin-1 字符保留，不会解出过长编码、代理或超出范围的码点
+    for (const auto& sequence : invalidSequences()) {
+        for (uint32_t codePoint : TextUtils::decodeUtf8(sequence)) {
+            EXPECT_LE(codePoint, 0xFFu) << ::testing::PrintToString(sequence);
+        }
+        EXPECT_TRUE(Utf8::isValid(reencode(sequence))) << ::testing::PrintToString(sequence);
+    }
+
+    // 截断的序列
+    EXPECT_EQ(TextUtils::decodeUtf8("\xE4\xB8"), (std::vector<uint32_t>{0xE4, 0xB8}));
+    EXPECT_EQ(TextUtils::decodeUtf8("\xF0\x9F\x98"), (std::vector<uint32_t>{0xF0, 0x9F, 0x98}));
+}
+
+TEST(Utf8Test, TextUtilsReencodingAlwaysYieldsValidUtf8) {
+    std::mt19937 rng(20261018);
+    std::uniform_int_distribution<int> lengthDist(0, 64);
+    std::uniform_int_distribution<int> byteDist(0, 255);
+    for (int iteration = 0; iteration < 5000; ++iteration) {
+        std::string text(lengthDist(rng), '\0');
+        for (auto& c : text) {
+            c = static_cast<char>(byteDist(rng));
+        }
+        std::string reencoded = reencode(text);
+        ASSERT_TRUE(Utf8::isValid(reencoded)) << "iteration " << iteration << ": " << ::testing::PrintToString(text);
+        // 合法输入原样往返
+        if (Utf8::isValid(text)) {
+            ASSERT_EQ(reencoded, text) << "iteration " << iteration;
+        }
+    }
+}
+
+TEST(Utf8Test, RandomInputsMatchScalar) {
+    std::mt19937 rng(20261017);
+    std::uniform_int_distribution<int> lengthDist(0, 160);
+    std::uniform_int_distribution<int> byteDist(0, 255);
+    std::uniform_int_distribution<int> choiceDist(0, 9);
+    // 按码点长度加权，保证多字节序列足够多
+    const std::vector<std::pair<uint32_t, uint32_t>> ranges = {
+        {0x20, 0x7E}, {0x80, 0x7FF}, {0x800, 0xD7FF}, {0xE000, 0xFFFF}, {0x10000, 0x10FFFF}};
+
+    for (int iteration = 0; iteration < 20000; ++iteration) {
+        std::string text;
+        int length = lengthDist(rng);
+        while (static_cast<int>(text.size()) < length) {
+            const auto& range = ranges[rng() % ranges.size()];
+            text += encode(std::uniform_int_distribution<uint32_t>(range.first, range.second)(rng));
+        }
+
+        // 大部分输入注入一处错误：替换、删除或插入一个随机字节
+        int mutation = choiceDist(rng);
+        if (!text.empty() && mutation < 3) {
+            text[rng() % text.size()] = static_cast<char>(byteDist(rng));
+        } else if (!text.empty() && mutation < 5) {
+            text.erase(rng() % text.size(), 1);
+        } else if (mutation < 7) {
+            text.insert(text.begin() + (text.empty() ? 0 : rng() % text.size()), static_cast<char>(byteDist(rng)));
+        }
+
+        bool expected = Utf8::isValidScalar(text.data(), text.size());
+        ASSERT_EQ(Utf8::isValid(text), expected) << "iteration " << iteration << ": "
+                                                 << ::testing::PrintToString(text);
+        if (mutation >= 7) {
+            ASSERT_TRUE(expected) << "generated text must be valid: " << ::testing::PrintToString(text);
+        }
+    }
+
+    // 完全随机的字节
+    for (int iteration = 0; iteration < 5000; ++iteration) {
+        std::string text(lengthDist(rng), '\0');
+        for (auto& c : text) {
+            c = static_cast<char>(byteDist(rng));
+        }
+        ASSERT_EQ(Utf8::isValid(text), Utf8::isValidScalar(text.data(), text.size()))
+            << "iteration " << iteration << ": " << ::testing::PrintToString(text);
+    }
+}
+
+TEST(Utf8Test, Latin1ToUtf8MatchesScalar) {
+    EXPECT_EQ(Utf8::latin1ToUtf8("caf\xE9"), "caf\xC3\xA9");
+    EXPECT_EQ(Utf8::latin1ToUtf8(""), "");
+
+    std::mt19937 rng(1017);
+    std::uniform_int_distribution<int> lengthDist(0, 200);
+    std::uniform_int_distribution<int> byteDist(0, 255);
+    for (int iteration = 0; iteration < 2000; ++iteration) {
+        std::string text(lengthDist(rng), '\0');
+        for (auto& c : text) {
+            c = static_cast<char>(byteDist(rng));
+        }
+        std::string converted = Utf8::latin1ToUtf8(text);
+        ASSERT_EQ(converted, Utf8::latin1ToUtf8Scalar(text)) << "iteration " << iteration;
+        ASSERT_TRUE(Utf8::isValid(converted));
+    }
+}
@@ -183,6 +183,17 @@ nlohmann::json ConfigManager::getAllApiProviders() const {
     return nlohmann::json();
 }
 
+nlohmann::json ConfigManager::getSectionConfig(const std::string& section) const {
+    try {
+        if (config_.contains(section) && config_[section].is_object()) {
+            return config_[section];
+        }
+    } catch (const std::exception& e) {
+        WARNLOG("获取配置节 {} 失败: {}", section, e.what());
+    }
+    return nlohmann::json::object();
+}
+
 void ConfigManager::reload() {
     loadConfig(configPath_);
     INFOLOG("配置文件已重新加载: {}", configPath_);
@@ -50,6 +50,9 @@ public:
     // 获取所有 API 提供商的配置
     nlohmann::json getAllApiProviders() const;
 
+    // 获取顶层配置节（如 search_settings），不存在时返回空对象
+    nlohmann::json getSectionConfig(const std::string& section) const;
+
     // 获取特定提供商的特定类型的提示文件路径
     std::string getProviderPromptPath(const std::string& provider, const std::string& promptType) const;
 
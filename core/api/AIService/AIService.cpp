@@ -1,54 +1,130 @@
 #include "AIService.h"
+#include "../AsyncHttpClient.h"
+#include "../CircuitBreaker.h"
+#include "../PromptRegistry.h"
+#include "../RateLimiter.h"
+#include "../../utils/Utf8.h"
 #include "../../../log/Logger.h"
 #include "../../../config/ConfigManager.h"
 #include <nlohmann/json.hpp>
 #include <string>
-#include <fstream>
-#include <sstream>
-#include <filesystem>
 #include <thread>
 #include <chrono>
+#include <memory>
 
 namespace IntelliSearch {
 
+namespace {
+
+// 流式响应的解析上下文，由 feedSseData 增量填充
+struct SseStreamContext {
+    StreamCallback onToken;
+    std::string lineBuffer;      // 尚未遇到换行的残留数据
+    std::string rawResponse;     // 收到首个事件前的原始数据（用于报告非SSE的错误响应）
+    std::string content;         // 累积的完整内容
+    std::string error;           // 事件流中返回的错误信息
+    bool receivedEvents = false; // 是否收到过 data: 事件
+};
+
 /*
- * Summary: AIService构造函数
+ * Summary: 从单个SSE事件中提取增量文本
  * Parameters:
- *   QObject* parent - 父对象指针
- * Description: 初始化AIService，设置CURL句柄，并检查初始化是否成功
+ *   const nlohmann::json& event - 事件的JSON数据
+ * Return: std::string - 增量文本，没有内容时返回空字符串
+ * Description: 兼容 OpenAI 风格（choices[0].delta.content）与 DashScope 增量输出（output.choices[0].message.content）
  */
-AIService::AIService() : curl(nullptr), requestCount(0), lastResetTime(getCurrentTimeMs()) {
-    curl = curl_easy_init();
-    if (!curl) {
-        ERRORLOG("Failed to initialize CURL in AIService");
-        throw std::runtime_error("CURL initialization failed");
+std::string extractStreamDelta(const nlohmann::json& event) {
+    if (event.contains("choices") && event["choices"].is_array() && !event["choices"].empty()) {
+        const auto& choice = event["choices"][0];
+        if (choice.contains("delta") && choice["delta"].contains("content") &&
+            choice["delta"]["content"].is_string()) {
+            return choice["delta"]["content"].get<std::string>();
+        }
     }
+    if (event.contains("output") && event["output"].is_object()) {
+        const auto& output = event["output"];
+        if (output.contains("choices") && output["choices"].is_array() && !output["choices"].empty() &&
+            output["choices"][0].contains("message") && output["choices"][0]["message"].contains("content") &&
+            output["choices"][0]["message"]["content"].is_string()) {
+            return output["choices"][0]["message"]["content"].get<std::string>();
+        }
+        if (output.contains("text") && output["text"].is_string()) {
+            return output["text"].get<std::string>();
+        }
+    }
+    return {};
 }
-/*
-* Summary: AIService析构函数
-* Description: 释放CURL句柄
-*/
-AIService::~AIService() {
-    if (curl) {
-        curl_easy_cleanup(curl);
-        curl = nullptr;
+
+// 处理一行SSE数据，只关心 data: 行，其余（event:/id:/注释）忽略
+void handleSseLine(SseStreamContext& context, std::string line) {
+    if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+    }
+    if (line.compare(0, 5, "data:") != 0) {
+        return;
+    }
+
+    std::string data = line.substr(line.size() > 5 && line[5] == ' ' ? 6 : 5);
+    context.receivedEvents = true;
+    if (data == "[DONE]") {
+        return;
+    }
+
+    try {
+        auto event = nlohmann::json::parse(data);
+        if (event.contains("error")) {
+            context.error = event["error"].is_object() && event["error"].contains("message")
+                                ? event["error"]["message"].get<std::string>()
+                                : event["error"].dump();
+            return;
+        }
+
+        std::string delta = extractStreamDelta(event);
+        if (!delta.empty()) {
+            context.content += delta;
+            if (context.onToken) {
+                context.onToken(delta);
+            }
+        }
+    } catch (const nlohmann::json::exception& e) {
+        WARNLOG("Failed to parse SSE event: {} - {}", e.what(), data);
     }
 }
 
 /*
-* Summary: CURL写回调函数
-* Parameters:
-*   void* contents - 回调数据
-*   size_t size - 数据大小
-*   size_t nmemb - 数据数量
-*   std::string* userp - 用户数据指针
-*/
-size_t AIService::WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
-    size_t totalSize = size * nmemb;
-    userp->append((char*)contents, totalSize);
-    return totalSize;
+ * Summary: 增量解析SSE数据
+ * Parameters:
+ *   SseStreamContext& context - 解析上下文
+ *   const char* data - 本次收到的数据
+ *   size_t size - 数据长度
+ * Description: 按行切分SSE数据，每个完整的 data: 事件立即解析并回调增量内容
+ */
+void feedSseData(SseStreamContext& context, const char* data, size_t size) {
+    if (!context.receivedEvents) {
+        context.rawResponse.append(data, size);
+    }
+
+    context.lineBuffer.append(data, size);
+    size_t lineStart = 0;
+    size_t lineEnd;
+    while ((lineEnd = context.lineBuffer.find('\n', lineStart)) != std::string::npos) {
+        handleSseLine(context, context.lineBuffer.substr(lineStart, lineEnd - lineStart));
+        lineStart = lineEnd + 1;
+    }
+    context.lineBuffer.erase(0, lineStart);
 }
 
+} // namespace
+
+/*
+ * Summary: AIService构造函数
+ * Description: HTTP 请求统一通过 AsyncHttpClient 发送，不持有CURL句柄：每个请求从连接池租借句柄，
+ *              同一服务实例可被任意多个线程并发调用
+ */
+AIService::AIService() = default;
+
+AIService::~AIService() = default;
+
 /*
 * Summary: 获取当前时间戳（毫秒）
 * Returns:
@@ -66,30 +142,13 @@ int64_t AIService::getCurrentTimeMs() {
 *   const std::string& str - 需要编码的字符串
 * Returns:
 *   std::string - 编码后的字符串
+* Description: 已是合法 UTF-8 时原样返回，否则按 Latin-1 转码；校验与转码均由 Utf8 的向量化实现完成
 */
 std::string AIService::utf8_encode(const std::string& str) {
-    try {
-        if (is_valid_utf8(str)) {
-            return str;
-        }
-        
-        std::string result;
-        result.reserve(str.length());
-        
-        for (unsigned char c : str) {
-            if (c < 0x80) { // ASCII字符
-                result += c;
-            } else { // 非ASCII字符，使用UTF-8编码
-                result += (0xC0 | (c >> 6));
-                result += (0x80 | (c & 0x3F));
-            }
-        }
-        
-        return result;
-    } catch (const std::exception& e) {
-        ERRORLOG("UTF-8 encoding failed: {}", e.what());
+    if (Utf8::isValid(str)) {
         return str;
     }
+    return Utf8::latin1ToUtf8(str);
 }
 
 /*
@@ -100,29 +159,7 @@ std::string AIService::utf8_encode(const std::string& str) {
 *   bool - 如果字符串为UTF-8编码，返回true，否则返回false
 */
 bool AIService::is_valid_utf8(const std::string& str) {
-    const unsigned char* bytes = (const unsigned char*)str.c_str();
-    size_t len = str.length();
-    
-    for (size_t i = 0; i < len; i++) {
-        if (bytes[i] <= 0x7F) { // ASCII字符
-            continue;
-        } else if (bytes[i] >= 0xC2 && bytes[i] <= 0xDF) { // 2字节序列
-            if (i + 1 >= len || (bytes[i + 1] & 0xC0) != 0x80) return false;
-            i += 1;
-        } else if (bytes[i] >= 0xE0 && bytes[i] <= 0xEF) { // 3字节序列 
-            if (i + 2 >= len || (bytes[i + 1] & 0xC0) != 0x80 || 
-                (bytes[i + 2] & 0xC0) != 0x80) return false;
-            i += 2;
-        } else if (bytes[i] >= 0xF0 && bytes[i] <= 0xF4) { // 4字节序列
-            if (i + 3 >= len || (bytes[i + 1] & 0xC0) != 0x80 || 
-                (bytes[i + 2] & 0xC0) != 0x80 || 
-                (bytes[i + 3] & 0xC0) != 0x80) return false;
-            i += 3;
-        } else {
-            return false;
-        }
-    }
-    return true;
+    return Utf8::isValid(str);
 }
 
 /*
@@ -133,158 +170,227 @@ bool AIService::is_valid_utf8(const std::string& str) {
 * Returns:
 *   nlohmann::json - API响应
 */
-nlohmann::json AIService::retryApiCall(const std::string& query, const std::string& promptType, int attempt) {
+nlohmann::json AIService::retryApiCall(const std::string& query, const std::string& promptType,
+                                      const ApiCallOptions& options, int attempt) {
     auto config = ConfigManager::getInstance();
     int maxAttempts = config->getIntValue("api/retry/max_attempts", 3);
     int initialDelay = config->getIntValue("api/retry/initial_delay_ms", 1000);
     int maxDelay = config->getIntValue("api/retry/max_delay_ms", 5000);
-    int maxRequestsPerMinute = config->getIntValue("api/max_requests_per_minute", 3);
-
-    // 检查并重置请求计数器
-    int64_t currentTime = getCurrentTimeMs();
-    if (currentTime - lastResetTime >= 60000) { // 1分钟
-        requestCount = 0;
-        lastResetTime = currentTime;
-    }
 
-    // 检查请求速率限制
-    if (requestCount >= maxRequestsPerMinute) {
-        int64_t waitTime = 60000 - (currentTime - lastResetTime);
-        if (waitTime > 0) {
-            WARNLOG("Rate limit reached, waiting for {} ms", waitTime);
-            std::this_thread::sleep_for(std::chrono::milliseconds(waitTime));
-            requestCount = 0;
-            lastResetTime = getCurrentTimeMs();
-        }
+    // 流式模式下记录本次尝试是否已向调用方输出过内容，已输出则不再重试，避免重复内容
+    auto streamed = std::make_shared<bool>(false);
+    ApiCallOptions attemptOptions = options;
+    if (options.onToken) {
+        attemptOptions.onToken = [streamed, onToken = options.onToken](const std::string& delta) {
+            *streamed = true;
+            onToken(delta);
+        };
     }
 
     try {
         requestCount++;
-        return executeApiCall(query, promptType);
+        return executeApiCall(query, promptType, attemptOptions);
+    } catch (const RateLimitExceeded& e) {
+        // 已在限流队列中等待过 max_queue_ms，立即重试只会再次排队
+        WARNLOG("API call rejected by rate limiter: {}", e.what());
+        throw;
+    } catch (const RequestCancelled&) {
+        throw;
+    } catch (const CircuitOpenError& e) {
+        WARNLOG("API call rejected: {}", e.what());
+        throw;
     } catch (const std::exception& e) {
-        if (attempt < maxAttempts) {
+        // 本次失败使熔断器断开时不再重试，避免在故障期间耗尽整个重试周期
+        if (attempt < maxAttempts && !*streamed && !options.isCancelled() && circuitBreaker()->isCallPermitted()) {
             int delay = std::min(initialDelay * (1 << attempt), maxDelay);
             WARNLOG("API call failed, retrying in {} ms (attempt {}/{}): {}", delay, attempt + 1, maxAttempts, e.what());
-            std::this_thread::sleep_for(std::chrono::milliseconds(delay));
-            return retryApiCall(query, promptType, attempt + 1);
+            // 退避等待期间被取消时立即返回
+            if (options.cancellation) {
+                options.cancellation->waitFor(std::chrono::milliseconds(delay));
+                options.cancellation->throwIfCancelled("API call");
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+            }
+            return retryApiCall(query, promptType, options, attempt + 1);
         }
         throw;
     }
 }
 
 /*
-* Summary: 设置基本的CURL选项
+* Summary: 发送POST请求并返回响应体
 * Parameters:
 *   const std::string& url - API URL
-*   std::string* response - 存储API响应的指针
-*/
-void AIService::setupBasicCurlOptions(const std::string& url, std::string* response) {
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, response);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 2L);
-    curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "gzip");
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl, CURLOPT_ENCODING, "UTF-8");
-}
-
-/*
-* Summary: 设置请求头
-* Parameters:
-*   const std::string& contentType - 内容类型
-*   const std::string& authToken - 认证令牌
+*   const std::string& authHeader - 认证请求头
+*   const std::string& requestBody - 序列化后的请求体
+*   const ApiCallOptions& options - 调用选项，onToken 非空时按SSE流式接收
+*   const std::vector<std::string>& extraHeaders - 额外请求头（如 DashScope 的 X-DashScope-SSE）
 * Returns:
-*   curl_slist* - 请求头列表
+*   std::string - 响应体；流式模式下为 wrapStreamedContent 拼装的非流式格式
+* Description: 请求失败时抛出 std::runtime_error
 */
-curl_slist* AIService::setupRequestHeaders(const std::string& contentType, const std::string& authToken) {
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, contentType.c_str());
-    if (!authToken.empty()) {
-        headers = curl_slist_append(headers, authToken.c_str());
+std::string AIService::performRequest(const std::string& url, const std::string& authHeader,
+                                      const std::string& requestBody, const ApiCallOptions& options,
+                                      const std::vector<std::string>& extraHeaders) {
+    SseStreamContext streamContext;
+    bool streaming = static_cast<bool>(options.onToken);
+
+    HttpRequest request;
+    request.url = url;
+    request.body = requestBody;
+    request.timeoutMs = 30000;
+    request.acceptCompressed = true;
+    request.headers.push_back("Content-Type: application/json");
+    if (!authHeader.empty()) {
+        request.headers.push_back(authHeader);
+    }
+    request.headers.insert(request.headers.end(), extraHeaders.begin(), extraHeaders.end());
+    if (options.cancellation) {
+        request.cancelled = options.cancellation->flag();
+    }
+
+    if (streaming) {
+        // 数据在 I/O 线程中回调；当前线程阻塞在 future 上直到传输结束，streamContext 始终有效
+        streamContext.onToken = options.onToken;
+        request.headers.push_back("Accept: text/event-stream");
+        request.onData = [&streamContext](const char* data, size_t size) {
+            feedSseData(streamContext, data, size);
+            return true;
+        };
+    }
+
+    if (options.isCancelled()) {
+        throw RequestCancelled("API call cancelled");
+    }
+
+    // 熔断器断开时立即失败，不再等待超时
+    CircuitBreaker* breaker = circuitBreaker();
+    if (!breaker->tryAcquire()) {
+        throw CircuitOpenError("Circuit open for " + getServiceName());
+    }
+
+    INFOLOG("Sending API request with content: {}", requestBody);
+
+    // 发送请求：配置了 rate_limits 的服务商先经过限流器，获得许可后才提交给 I/O 线程，
+    // 排队期间不占用任何线程，请求完成时归还并发许可。
+    // 取消时撤回仍在排队的请求，并唤醒 I/O 线程立即中止已发出的传输
+    std::future<HttpResponse> pendingResponse;
+    std::unique_ptr<CancellationSubscription> cancelSubscription;
+    RateLimiter* limiter = RateLimiterRegistry::getInstance()->get(getServiceName());
+    if (limiter) {
+        auto promise = std::make_shared<std::promise<HttpResponse>>();
+        auto sharedRequest = std::make_shared<HttpRequest>(std::move(request));
+        pendingResponse = promise->get_future();
+        uint64_t ticket = limiter->submit(
+            [limiter, promise, sharedRequest]() {
+                // 排队期间已被取消则直接归还许可，不再占用配额
+                if (sharedRequest->cancelled && sharedRequest->cancelled->load()) {
+                    limiter->release();
+                    promise->set_exception(std::make_exception_ptr(RequestCancelled("API call cancelled")));
+                    return;
+                }
+                AsyncHttpClient::getInstance()->send(std::move(*sharedRequest),
+                    [limiter, promise](HttpResponse response) {
+                        limiter->release();
+                        promise->set_value(std::move(response));
+                    });
+            },
+            [promise](const std::string& reason) {
+                promise->set_exception(std::make_exception_ptr(RateLimitExceeded(reason)));
+            });
+        cancelSubscription = std::make_unique<CancellationSubscription>(options.cancellation,
+            [limiter, ticket, promise]() {
+                if (ticket != 0 && limiter->cancel(ticket)) {
+                    promise->set_exception(std::make_exception_ptr(RequestCancelled("API call cancelled")));
+                    return;
+                }
+                AsyncHttpClient::getInstance()->wakeup();
+            });
+    } else {
+        pendingResponse = AsyncHttpClient::getInstance()->send(std::move(request));
+        cancelSubscription = std::make_unique<CancellationSubscription>(options.cancellation,
+            []() { AsyncHttpClient::getInstance()->wakeup(); });
+    }
+    HttpResponse result;
+    try {
+        result = pendingResponse.get();
+    } catch (...) {
+        // 限流器拒绝或排队期间被取消，请求没有发出
+        breaker->onAbandon();
+        throw;
+    }
+    if (options.isCancelled()) {
+        breaker->onAbandon();
+        DEBUGLOG("API request cancelled: {}", url);
+        throw RequestCancelled("API call cancelled");
+    }
+    if (!result.ok()) {
+        breaker->onFailure(result.curlCode == CURLE_OPERATION_TIMEDOUT);
+        ERRORLOG("CURL request failed: {}", result.error);
+        throw std::runtime_error("CURL request failed: " + result.error);
+    }
+    // 5xx 与 429 说明服务商故障或过载；其余状态码（如鉴权失败）由 processApiResponse 报告，不计入熔断
+    if (result.statusCode >= 500 || result.statusCode == 429) {
+        breaker->onFailure(false);
+    } else {
+        breaker->onSuccess();
+    }
+    std::string response = std::move(result.body);
+
+    if (streaming) {
+        // 处理末尾没有换行的最后一行
+        if (!streamContext.lineBuffer.empty()) {
+            handleSseLine(streamContext, streamContext.lineBuffer);
+            streamContext.lineBuffer.clear();
+        }
+        if (!streamContext.error.empty()) {
+            ERRORLOG("API returned error in stream: {}", streamContext.error);
+            throw std::runtime_error("API error: " + streamContext.error);
+        }
+        // 服务端没有返回SSE事件（通常是错误响应），按原始响应交给 processApiResponse 处理
+        response = streamContext.receivedEvents ? wrapStreamedContent(streamContext.content)
+                                                : streamContext.rawResponse;
     }
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    return headers;
+
+    INFOLOG("Received API response: {}", response);
+    return response;
+}
+
+CircuitBreaker* AIService::circuitBreaker() const {
+    return CircuitBreakerRegistry::getInstance()->get("ai/" + getServiceName());
 }
 
 /*
-* Summary: 查找并读取提示文件
+* Summary: 将流式累积的内容包装为 OpenAI 兼容的非流式响应
 * Parameters:
-*   const std::string& promptsFilePath - 提示文件路径
+*   const std::string& content - 累积的完整内容
 * Returns:
-*   nlohmann::json - 提示文件内容
+*   std::string - 序列化后的响应体
 */
-nlohmann::json AIService::loadPromptsFile(const std::string& promptsFilePath) {
-    INFOLOG("尝试加载提示文件: {}", promptsFilePath);
-    auto searchPaths = buildSearchPaths(promptsFilePath);
-    std::string triedPaths;
-    std::ifstream promptsFile;
-    
-    for (const auto& path : searchPaths) {
-        // DEBUGLOG("尝试路径: {}", path.string());
-        if (std::filesystem::exists(path)) {
-            DEBUGLOG("文件存在: {}", path.string());
-            promptsFile.open(path);
-            if (promptsFile.is_open()) {
-                INFOLOG("成功打开提示文件: {}", path.string());
-                break;
-            }
-        }
-        triedPaths += "\n              " + path.string();
-    }
-    
-    if (!promptsFile.is_open()) {
-        ERRORLOG("无法打开提示文件: {}, 尝试的路径: {}", promptsFilePath, triedPaths);
-        throw std::runtime_error("Failed to open prompts file: " + promptsFilePath + "\n尝试的路径: " + triedPaths);
-    }
-
-    std::stringstream buffer;
-    buffer << promptsFile.rdbuf();
-    auto jsonContent = nlohmann::json::parse(buffer.str());
-    DEBUGLOG("成功解析提示文件JSON");
-    return jsonContent;
+std::string AIService::wrapStreamedContent(const std::string& content) const {
+    nlohmann::json response = {
+        {"choices", nlohmann::json::array({
+            {{"message", {{"role", "assistant"}, {"content", content}}}}
+        })}
+    };
+    return response.dump();
 }
 
 /*
-* Summary: 构建搜索路径列表
+* Summary: 构建带提示模板的消息数组
 * Parameters:
 *   const std::string& promptsFilePath - 提示文件路径
+*   const std::string& query - 用户查询
 * Returns:
-*   std::vector<std::filesystem::path> - 搜索路径列表
+*   nlohmann::json - [system 消息, user 消息]
+* Description: 模板由 PromptRegistry 预先加载并渲染，每次请求只需拼接用户查询
 */
-std::vector<std::filesystem::path> AIService::buildSearchPaths(const std::string& promptsFilePath) {
-    std::vector<std::filesystem::path> searchPaths;
-    auto* config = ConfigManager::getInstance();
-    std::filesystem::path currentPath = std::filesystem::current_path();
-    std::filesystem::path configDir = std::filesystem::path(config->getConfigPath()).parent_path();
-    
-    // 获取文件名部分
-    std::filesystem::path promptsFile(promptsFilePath);
-    std::string filename = promptsFile.filename().string();
-    
-    DEBUGLOG("构建搜索路径，原始路径: {}, 文件名: {}", promptsFilePath, filename);
-    
-    // 添加原始路径和基本路径组合
-    searchPaths.push_back(promptsFilePath);
-    searchPaths.push_back(currentPath / promptsFilePath);
-    searchPaths.push_back(configDir / promptsFilePath);
-    
-    // 向上查找目录，使用传入的文件名而不是硬编码的文件名
-    std::filesystem::path tempPath = currentPath;
-    for (int i = 0; i < 5 && tempPath.has_parent_path(); ++i) {
-        searchPaths.push_back(tempPath / promptsFilePath);
-        searchPaths.push_back(tempPath / "config" / filename);
-        tempPath = tempPath.parent_path();
-    }
-    
-    // 记录所有搜索路径
-//    std::string pathsLog = "搜索路径列表:";
-//    for (const auto& path : searchPaths) {
-//        pathsLog += "\n  - " + path.string();
-//    }
-//    DEBUGLOG("{}", pathsLog);
-    
-    return searchPaths;
+nlohmann::json AIService::buildPromptMessages(const std::string& promptsFilePath, const std::string& query) {
+    auto prompt = PromptRegistry::getInstance()->get(promptsFilePath);
+    return nlohmann::json::array({
+        {{"role", "system"}, {"content", prompt->systemContent}},
+        {{"role", "user"}, {"content", prompt->userPrefix + utf8_encode(query)}}
+    });
 }
 
     /*
@@ -2,16 +2,34 @@
 #define INTELLISEARCH_AISERVICE_H
 
 #include "../APIService.h"
+#include "../CancellationToken.h"
 #include "../../../log/Logger.h"
-#include <curl/curl.h>
 #include <nlohmann/json.hpp>
 #include <string>
 #include <vector>
-#include <filesystem>
+#include <atomic>
 #include <chrono>
+#include <functional>
+#include <memory>
+#include <stdexcept>
 
 namespace IntelliSearch {
 
+class CircuitBreaker;
+
+// 流式输出回调，参数为本次收到的增量文本
+using StreamCallback = std::function<void(const std::string& delta)>;
+
+// 单次 API 调用的附加选项
+struct ApiCallOptions {
+    // 非空时以流式（SSE）方式请求，每收到一段增量内容回调一次
+    StreamCallback onToken;
+    // 非空且被取消时中止进行中或排队中的请求，不再重试（搜索被新查询取代、对冲请求落败时使用）
+    std::shared_ptr<CancellationToken> cancellation;
+
+    bool isCancelled() const { return cancellation && cancellation->isCancelled(); }
+};
+
 class AIService : public APIService {
 public:
     // 构造函数
@@ -21,8 +39,10 @@ public:
     virtual ~AIService();
 
     // 解析用户输入的意图
-    virtual nlohmann::json parseIntent(const std::string& userInput) = 0;
-    virtual nlohmann::json searchParser(const std::string& userInput) = 0;
+    virtual nlohmann::json parseIntent(const std::string& userInput,
+                                       const ApiCallOptions& options = ApiCallOptions()) = 0;
+    virtual nlohmann::json searchParser(const std::string& userInput,
+                                        const ApiCallOptions& options = ApiCallOptions()) = 0;
 
     // 获取服务名称
     virtual std::string getServiceName() const = 0;
@@ -33,6 +53,9 @@ public:
     // 获取服务优先级（用于负载均衡和故障转移）
     virtual int getPriority() const = 0;
 
+    // 已发出的请求次数（含重试）
+    uint64_t getRequestCount() const { return requestCount.load(); }
+
 protected:
     // API调用的通用错误处理
     virtual void handleError(const std::string& error) {
@@ -45,11 +68,9 @@ protected:
     // 通用的API调用重试逻辑
     nlohmann::json retryApiCall(const std::string& query, 
                                const std::string& promptType = "", 
+                               const ApiCallOptions& options = ApiCallOptions(),
                                int attempt = 0);
     
-    // CURL写回调函数
-    static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp);
-
     // 获取当前时间戳（毫秒）
     static int64_t getCurrentTimeMs();
 
@@ -63,28 +84,25 @@ protected:
     virtual nlohmann::json processApiResponse(const std::string& response);
 
     // 执行实际的API调用, 子类必须实现
-    virtual nlohmann::json executeApiCall(const std::string& query, const std::string& promptType) = 0;
+    virtual nlohmann::json executeApiCall(const std::string& query, const std::string& promptType,
+                                          const ApiCallOptions& options) = 0;
 
-    // 设置基本的CURL参数
-    void setupBasicCurlOptions(const std::string& url, std::string* response);
+    // 发送POST请求并返回响应体；流式模式下逐段回调增量内容，结束后拼装为非流式响应格式
+    std::string performRequest(const std::string& url, const std::string& authHeader,
+                               const std::string& requestBody, const ApiCallOptions& options,
+                               const std::vector<std::string>& extraHeaders = {});
 
-    // 设置请求头
-    curl_slist* setupRequestHeaders(const std::string& contentType, const std::string& authToken);
+    // 将流式累积的完整内容包装为与非流式响应相同的结构，供 processApiResponse 复用
+    virtual std::string wrapStreamedContent(const std::string& content) const;
 
-    // 查找并读取提示文件
-    nlohmann::json loadPromptsFile(const std::string& promptsFilePath);
+    // 本服务的熔断器（"ai/<服务名>"）
+    CircuitBreaker* circuitBreaker() const;
 
-    // 构建搜索路径列表
-    std::vector<std::filesystem::path> buildSearchPaths(const std::string& promptsFilePath);
+    // 使用预渲染的提示模板构建 system + user 消息数组
+    nlohmann::json buildPromptMessages(const std::string& promptsFilePath, const std::string& query);
 
-    // CURL句柄
-    CURL* curl;
-    
-    // API请求计数器
-    int requestCount;
-    
-    // 上次重置计数器的时间
-    int64_t lastResetTime;
+    // 实际发出的请求次数（含重试），同一服务实例会被多个线程并发调用
+    std::atomic<uint64_t> requestCount{0};
 };
 
 } // namespace IntelliSearch
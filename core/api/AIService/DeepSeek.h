@@ -14,19 +14,27 @@ namespace IntelliSearch {
         DeepSeek();
         ~DeepSeek();
 
-        nlohmann::json parseIntent(const std::string& userInput) override;
-        nlohmann::json searchParser(const std::string& userInput) override;
+        nlohmann::json parseIntent(const std::string& userInput,
+                                   const ApiCallOptions& options = ApiCallOptions()) override;
+        nlohmann::json searchParser(const std::string& userInput,
+                                    const ApiCallOptions& options = ApiCallOptions()) override;
         std::string getServiceName() const override { return "DeepSeek"; }
-        bool isAvailable() const override { return curl != nullptr && !apiKey.empty(); }
+        bool isAvailable() const override { return !apiKey.empty(); }
         int getPriority() const override { return 1; }
+        std::string getHealthCheckUrl() const override { return baseUrl + "/models"; }
+        std::vector<std::string> getHealthCheckHeaders() const override { return {"Authorization: Bearer " + apiKey}; }
 
       protected:
         void handleError(const std::string& error) override { ERRORLOG("DeepSeekAPIService error: {}", error); }
         bool validateApiKey() const override { return !apiKey.empty(); }
 
     private:
-        nlohmann::json callAPI(const std::string& query, const std::string& promptType = "") { return retryApiCall(query, promptType);};
-        nlohmann::json executeApiCall(const std::string& query, const std::string& promptType) override;
+        nlohmann::json callAPI(const std::string& query, const std::string& promptType = "",
+                               const ApiCallOptions& options = ApiCallOptions()) {
+            return retryApiCall(query, promptType, options);
+        }
+        nlohmann::json executeApiCall(const std::string& query, const std::string& promptType,
+                                      const ApiCallOptions& options) override;
 
 
         std::string apiKey;
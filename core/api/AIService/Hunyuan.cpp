@@ -17,7 +17,7 @@ namespace IntelliSearch {
 
     Hunyuan::~Hunyuan() = default;
 
-    nlohmann::json Hunyuan::parseIntent(const std::string& userInput) {
+    nlohmann::json Hunyuan::parseIntent(const std::string& userInput, const ApiCallOptions& options) {
         // 验证API密钥
         if (!validateApiKey()) {
             handleError("Invalid API key");
@@ -25,37 +25,36 @@ namespace IntelliSearch {
         }
 
         try {
-            return callAPI(userInput);
+            // 指定使用 intent_parser prompt
+            return callAPI(userInput, "intent_parser", options);
+        } catch (const RequestCancelled&) {
+            throw;
         } catch (const std::exception& e) {
             handleError(e.what());
             throw;
         }
     }
 
-    nlohmann::json Hunyuan::searchParser(const std::string& userInput) {
+    nlohmann::json Hunyuan::searchParser(const std::string& userInput, const ApiCallOptions& options) {
     // 验证API密钥
     if (!validateApiKey()) {
         handleError("Invalid API key");
         throw std::runtime_error("Invalid API key");
     }
     try {
-        // 指定使用 intent_parser prompt
-        return callAPI(userInput, "search_parser");
+        return callAPI(userInput, "search_parser", options);
+    } catch (const RequestCancelled&) {
+        throw;
     } catch (const std::exception& e) {
         handleError(e.what());
         throw;
     }
 }
 
-    nlohmann::json Hunyuan::executeApiCall(const std::string& query, const std::string& promptType) {
+    nlohmann::json Hunyuan::executeApiCall(const std::string& query, const std::string& promptType,
+                                           const ApiCallOptions& options) {
         try {
-            requestCount++;
             const std::string apiUrl = baseUrl + "/v1/chat/completions";
-            std::string response;
-
-            setupBasicCurlOptions(apiUrl, &response);
-            std::string authHeader = "Authorization: Bearer " + apiKey;
-            struct curl_slist* headers = setupRequestHeaders("Content-Type: application/json", authHeader);
 
             // 获取配置管理器实例并构建请求体
             auto* config = ConfigManager::getInstance();
@@ -64,20 +63,13 @@ namespace IntelliSearch {
                 {"messages", nlohmann::json::array()},
                 {"temperature", 0.3},
                 {"max_tokens", 4096},
-                {"response_format", config->getApiProviderConfig("Hunyuan")["response_format"]}
+                {"response_format", config->getApiProviderConfig("hunyuan")["response_format"]}
             };
 
             // 如果指定了 promptType，则加载对应的 prompt
             if (!promptType.empty()) {
-                std::string promptsFilePath = config->getProviderPromptPath("kimi", promptType);
-                auto promptsJson = loadPromptsFile(promptsFilePath);
-                
-                requestBody["messages"] = nlohmann::json::array({
-                    {{"role", "system"}, {"content", utf8_encode(promptsJson["system"].dump())}},
-                    {{"role", "user"}, {"content", "示例输入：" + promptsJson["examples"]["input"].get<std::string>() + 
-                                                "\n示例输出：" + promptsJson["examples"]["output"].dump() + 
-                                                "\n\n实际输入：" + utf8_encode(query)}}
-                });
+                std::string promptsFilePath = config->getProviderPromptPath("hunyuan", promptType);
+                requestBody["messages"] = buildPromptMessages(promptsFilePath, query);
             } else {
                 // 普通聊天模式
                 requestBody["messages"] = nlohmann::json::array({
@@ -85,20 +77,11 @@ namespace IntelliSearch {
                 });
             }
 
-            std::string requestBodyStr = requestBody.dump();
-            INFOLOG("Sending API request with content: {}", requestBodyStr);
-            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, requestBodyStr.c_str());
-
-            // 发送请求
-            CURLcode res = curl_easy_perform(curl);
-            curl_slist_free_all(headers);
-
-            if (res != CURLE_OK) {
-                ERRORLOG("CURL request failed: {}", curl_easy_strerror(res));
-                throw std::runtime_error(std::string("CURL request failed: ") + curl_easy_strerror(res));
+            if (options.onToken) {
+                requestBody["stream"] = true;
             }
 
-            INFOLOG("Received API response: {}", response);
+            std::string response = performRequest(apiUrl, "Authorization: Bearer " + apiKey, requestBody.dump(), options);
             return processApiResponse(response);
         } catch (const std::exception& e) {
             throw;
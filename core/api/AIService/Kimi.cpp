@@ -29,7 +29,7 @@ Kimi::Kimi() {
 
 Kimi::~Kimi() = default;
 
-nlohmann::json Kimi::parseIntent(const std::string& userInput) {
+nlohmann::json Kimi::parseIntent(const std::string& userInput, const ApiCallOptions& options) {
     // 验证API密钥
     if (!validateApiKey()) {
         handleError("Invalid API key");
@@ -38,21 +38,25 @@ nlohmann::json Kimi::parseIntent(const std::string& userInput) {
 
     try {
         // 指定使用 intent_parser prompt
-        return callAPI(userInput, "intent_parser");
+        return callAPI(userInput, "intent_parser", options);
+    } catch (const RequestCancelled&) {
+        throw;
     } catch (const std::exception& e) {
         handleError(e.what());
         throw;
     }
 }
 
-nlohmann::json Kimi::searchParser(const std::string& userInput) {
+nlohmann::json Kimi::searchParser(const std::string& userInput, const ApiCallOptions& options) {
     // 验证API密钥
     if (!validateApiKey()) {
         handleError("Invalid API key");
         throw std::runtime_error("Invalid API key");
     }
     try {
-        return callAPI(userInput, "search_parser");
+        return callAPI(userInput, "search_parser", options);
+    } catch (const RequestCancelled&) {
+        throw;
     } catch (const std::exception& e) {
         handleError(e.what());
         throw;
@@ -64,53 +68,31 @@ void Kimi::handleError(const std::string& error) {
 }
 
 bool Kimi::isAvailable() const {
-    return curl != nullptr && !apiKey.empty();
+    return !apiKey.empty();
 }
 
 bool Kimi::validateApiKey() const {
     return !apiKey.empty();
 }
 
-nlohmann::json Kimi::callAPI(const std::string& query, const std::string& promptType) {
-    return retryApiCall(query, promptType);
+nlohmann::json Kimi::callAPI(const std::string& query, const std::string& promptType, const ApiCallOptions& options) {
+    return retryApiCall(query, promptType, options);
 }
 
-// 修改 executeApiCall 方法
-nlohmann::json Kimi::executeApiCall(const std::string& query, const std::string& promptType) {
-    try {
-        requestCount++;
-        const std::string apiUrl = baseUrl +  "/v1/chat/completions";
-        std::string response;
-
-        // 使用基类方法设置基本的CURL参数
-        setupBasicCurlOptions(apiUrl, &response);
-
-        // 使用基类方法设置请求头
-        std::string authHeader = "Authorization: Bearer " + apiKey;
-        struct curl_slist* headers = setupRequestHeaders("Content-Type: application/json", authHeader);
-
-        // 构建请求体
-        auto* config = ConfigManager::getInstance();
-        nlohmann::json requestBody = buildRequestBody(query, promptType, config);
-
-        std::string requestBodyStr = requestBody.dump();
-        INFOLOG("Sending API request with content: {}", requestBodyStr);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, requestBodyStr.c_str());
+nlohmann::json Kimi::executeApiCall(const std::string& query, const std::string& promptType,
+                                    const ApiCallOptions& options) {
+    const std::string apiUrl = baseUrl +  "/v1/chat/completions";
 
-        // 发送请求
-        CURLcode res = curl_easy_perform(curl);
-        curl_slist_free_all(headers);
-
-        if (res != CURLE_OK) {
-            ERRORLOG("CURL request failed: {}", curl_easy_strerror(res));
-            throw std::runtime_error(std::string("CURL request failed: ") + curl_easy_strerror(res));
-        }
-
-        INFOLOG("Received API response: {}", response);
-        return processApiResponse(response, promptType);  // 添加promptType参数
-    } catch (const std::exception& e) {
-        throw;
+    // 构建请求体
+    auto* config = ConfigManager::getInstance();
+    nlohmann::json requestBody = buildRequestBody(query, promptType, config);
+    if (options.onToken) {
+        requestBody["stream"] = true;
     }
+
+    // 使用基类方法发送请求（流式模式下由基类拼装完整响应）
+    std::string response = performRequest(apiUrl, "Authorization: Bearer " + apiKey, requestBody.dump(), options);
+    return processApiResponse(response, promptType);  // 添加promptType参数
 }
 
 /*
@@ -134,24 +116,8 @@ nlohmann::json Kimi::buildRequestBody(const std::string& query, const std::strin
     // 如果指定了 promptType，则加载对应的 prompt
     if (!promptType.empty()) {
         std::string promptsFilePath = config->getProviderPromptPath("kimi", promptType);
-        DEBUGLOG("加载提示文件: {}, 提示类型: {}", promptsFilePath, promptType);
-        auto promptsJson = loadPromptsFile(promptsFilePath);
-
-        if(promptType == "intent_parser") {
-            requestBody["messages"] = nlohmann::json::array({
-                {{"role", "system"}, {"content", utf8_encode(promptsJson["system"].dump())}},
-                {{"role", "user"}, {"content", "示例输入：" + promptsJson["examples"]["input"].get<std::string>() + 
-                                              "\n示例输出：" + promptsJson["examples"]["output"].dump() + 
-                                              "\n\n实际输入：" + utf8_encode(query)}}
-            });
-        } else if(promptType == "search_parser") {
-            requestBody["messages"] = nlohmann::json::array({
-                {{"role", "system"}, {"content", utf8_encode(promptsJson["system"].dump())}},
-                {{"role", "user"}, {"content", "示例输入：" + promptsJson["examples"]["input"].dump() +
-                                              "\n示例输出：" + promptsJson["examples"]["output"].dump() +
-                                              "\n\n实际输入：" + utf8_encode(query)}}
-            });
-        }
+        DEBUGLOG("使用提示文件: {}, 提示类型: {}", promptsFilePath, promptType);
+        requestBody["messages"] = buildPromptMessages(promptsFilePath, query);
     } else {
         // 普通聊天模式
         requestBody["messages"] = nlohmann::json::array({
@@ -11,11 +11,16 @@ public:
     ~Kimi();
 
     // 实现 APIService 接口
-    nlohmann::json parseIntent(const std::string& userInput) override;
-    virtual nlohmann::json searchParser(const std::string& userInput) override;
+    nlohmann::json parseIntent(const std::string& userInput,
+                               const ApiCallOptions& options = ApiCallOptions()) override;
+    virtual nlohmann::json searchParser(const std::string& userInput,
+                                        const ApiCallOptions& options = ApiCallOptions()) override;
     std::string getServiceName() const override { return "Kimi"; }
     bool isAvailable() const override;
     int getPriority() const override { return 1; }
+    // 探测需要鉴权的模型列表接口，不消耗调用额度
+    std::string getHealthCheckUrl() const override { return baseUrl + "/v1/models"; }
+    std::vector<std::string> getHealthCheckHeaders() const override { return {"Authorization: Bearer " + apiKey}; }
 
 protected:
     nlohmann::json buildRequestBody(const std::string& query, const std::string& promptType, ConfigManager* config);
@@ -24,10 +29,12 @@ protected:
 
 private:
     // 调用 Kimi API
-    nlohmann::json callAPI(const std::string& query, const std::string& promptType = "");
+    nlohmann::json callAPI(const std::string& query, const std::string& promptType = "",
+                           const ApiCallOptions& options = ApiCallOptions());
     
     // 执行API调用
-    nlohmann::json executeApiCall(const std::string& query, const std::string& promptType) override;
+    nlohmann::json executeApiCall(const std::string& query, const std::string& promptType,
+                                  const ApiCallOptions& options) override;
     
     // 处理 API 响应
     nlohmann::json processApiResponse(const std::string& response) override;
@@ -27,14 +27,17 @@ Qwen::Qwen() {
 
 Qwen::~Qwen() = default;
 
-nlohmann::json Qwen::parseIntent(const std::string& userInput) {
+nlohmann::json Qwen::parseIntent(const std::string& userInput, const ApiCallOptions& options) {
     if (!validateApiKey()) {
         handleError("Invalid API key");
         throw std::runtime_error("Invalid API key");
     }
 
     try {
-        return callAPI(userInput);
+        // 指定使用 intent_parser prompt
+        return callAPI(userInput, "intent_parser", options);
+    } catch (const RequestCancelled&) {
+        throw;
     } catch (const std::exception& e) {
         handleError(e.what());
         throw;
@@ -42,15 +45,16 @@ nlohmann::json Qwen::parseIntent(const std::string& userInput) {
 }
 
 
-nlohmann::json Qwen::searchParser(const std::string& userInput) {
+nlohmann::json Qwen::searchParser(const std::string& userInput, const ApiCallOptions& options) {
     // 验证API密钥
     if (!validateApiKey()) {
         handleError("Invalid API key");
         throw std::runtime_error("Invalid API key");
     }
     try {
-        // 指定使用 intent_parser prompt
-        return callAPI(userInput, "search_parser");
+        return callAPI(userInput, "search_parser", options);
+    } catch (const RequestCancelled&) {
+        throw;
     } catch (const std::exception& e) {
         handleError(e.what());
         throw;
@@ -69,18 +73,11 @@ bool Qwen::validateApiKey() const {
     return !apiKey.empty();
 }
 
-nlohmann::json Qwen::executeApiCall(const std::string& query, const std::string& promptType) {
+nlohmann::json Qwen::executeApiCall(const std::string& query, const std::string& promptType,
+                                    const ApiCallOptions& options) {
     try {
-        requestCount++;
         const std::string apiUrl = baseUrl + "/api/v1/services/aigc/text-generation/generation";
-        std::string response;
-
-        // 使用基类方法设置基本的CURL参数
-        setupBasicCurlOptions(apiUrl, &response);
-
-        // 使用基类方法设置请求头
-        std::string authHeader = "Authorization: Bearer " + apiKey;
-        struct curl_slist* headers = setupRequestHeaders("Content-Type: application/json", authHeader);
+        std::vector<std::string> extraHeaders;
         
         auto* config = ConfigManager::getInstance();
             nlohmann::json requestBody = {
@@ -93,15 +90,8 @@ nlohmann::json Qwen::executeApiCall(const std::string& query, const std::string&
 
             // 如果指定了 promptType，则加载对应的 prompt
             if (!promptType.empty()) {
-                std::string promptsFilePath = config->getProviderPromptPath("kimi", promptType);
-                auto promptsJson = loadPromptsFile(promptsFilePath);
-                
-                requestBody["messages"] = nlohmann::json::array({
-                    {{"role", "system"}, {"content", utf8_encode(promptsJson["system"].dump())}},
-                    {{"role", "user"}, {"content", "示例输入：" + promptsJson["examples"]["input"].get<std::string>() + 
-                                                "\n示例输出：" + promptsJson["examples"]["output"].dump() + 
-                                                "\n\n实际输入：" + utf8_encode(query)}}
-                });
+                std::string promptsFilePath = config->getProviderPromptPath("qwen", promptType);
+                requestBody["messages"] = buildPromptMessages(promptsFilePath, query);
             } else {
                 // 普通聊天模式
                 requestBody["messages"] = nlohmann::json::array({
@@ -109,20 +99,13 @@ nlohmann::json Qwen::executeApiCall(const std::string& query, const std::string&
                 });
             }
 
-        std::string requestBodyStr = requestBody.dump();
-        INFOLOG("Sending API request with content: {}", requestBodyStr);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, requestBodyStr.c_str());
-
-        // 发送请求
-        CURLcode res = curl_easy_perform(curl);
-        curl_slist_free_all(headers);
-
-        if (res != CURLE_OK) {
-            ERRORLOG("CURL request failed: {}", curl_easy_strerror(res));
-            throw std::runtime_error(std::string("CURL request failed: ") + curl_easy_strerror(res));
+        if (options.onToken) {
+            // DashScope 需要显式开启SSE，并使用增量输出模式
+            requestBody["parameters"]["incremental_output"] = true;
+            extraHeaders.push_back("X-DashScope-SSE: enable");
         }
 
-        INFOLOG("Received API response: {}", response);
+        std::string response = performRequest(apiUrl, "Authorization: Bearer " + apiKey, requestBody.dump(), options, extraHeaders);
         return processApiResponse(response);
     } catch (const std::exception& e) {
         throw;
@@ -167,4 +150,21 @@ nlohmann::json Qwen::processApiResponse(const std::string& response) {
     }
 }
 
+/*
+ * Summary: 将流式累积的内容包装为 DashScope 非流式响应格式
+ * Parameters:
+ *   const std::string& content - 累积的完整内容
+ * Return: std::string - 序列化后的响应体，结构与 processApiResponse 期望的 output.choices 一致
+ */
+std::string Qwen::wrapStreamedContent(const std::string& content) const {
+    nlohmann::json response = {
+        {"output", {
+            {"choices", nlohmann::json::array({
+                {{"message", {{"role", "assistant"}, {"content", content}}}}
+            })}
+        }}
+    };
+    return response.dump();
+}
+
 } // namespace IntelliSearch
\ No newline at end of file
@@ -10,20 +10,29 @@ public:
     Qwen();
     ~Qwen();
 
-    nlohmann::json parseIntent(const std::string& userInput) override;
-    nlohmann::json searchParser(const std::string& userInput) override;
+    nlohmann::json parseIntent(const std::string& userInput,
+                               const ApiCallOptions& options = ApiCallOptions()) override;
+    nlohmann::json searchParser(const std::string& userInput,
+                                const ApiCallOptions& options = ApiCallOptions()) override;
     std::string getServiceName() const override { return "Qwen"; }
     bool isAvailable() const override;
     int getPriority() const override { return 1; }
+    std::string getHealthCheckUrl() const override { return baseUrl + "/compatible-mode/v1/models"; }
+    std::vector<std::string> getHealthCheckHeaders() const override { return {"Authorization: Bearer " + apiKey}; }
 
 protected:
     void handleError(const std::string& error) override;
     bool validateApiKey() const override;
 
 private:
-    nlohmann::json callAPI(const std::string& query, const std::string& promptType = "") { return retryApiCall(query, promptType);};
-    nlohmann::json executeApiCall(const std::string& query, const std::string& promptType) override;
+    nlohmann::json callAPI(const std::string& query, const std::string& promptType = "",
+                           const ApiCallOptions& options = ApiCallOptions()) {
+        return retryApiCall(query, promptType, options);
+    }
+    nlohmann::json executeApiCall(const std::string& query, const std::string& promptType,
+                                  const ApiCallOptions& options) override;
     nlohmann::json processApiResponse(const std::string& response) override;
+    std::string wrapStreamedContent(const std::string& content) const override;
 
     std::string apiKey;
     std::string baseUrl;
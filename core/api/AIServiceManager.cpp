@@ -3,11 +3,64 @@
 #include "AIService/Qwen.h"
 #include "AIService/Hunyuan.h"
 #include "AIService/DeepSeek.h"
+#include "PromptRegistry.h"
+#include "CircuitBreaker.h"
 #include "../log/Logger.h"
 #include "../config/ConfigManager.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <thread>
 
 namespace IntelliSearch {
 
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 统计键：服务商名/调用类型，意图解析与结果分析的耗时分布相差一个数量级，不能混在一起
+std::string statsKey(const std::string& serviceName, LlmCallKind kind) {
+    return serviceName + (kind == LlmCallKind::Intent ? "/intent" : "/analysis");
+}
+
+// 一次对冲调用中主、备两个请求共享的状态，下标 0 为主服务，1 为备用服务
+struct HedgeRace {
+    // 两个请求各自的取消令牌都随调用方的令牌一同取消
+    explicit HedgeRace(const std::shared_ptr<CancellationToken>& parent)
+        : cancellation{CancellationToken::linkedTo(parent), CancellationToken::linkedTo(parent)} {}
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    int running = 0;
+    int winner = -1;                 // 先成功的一方；流式模式下为先输出内容的一方
+    bool resultReady = false;
+    nlohmann::json result;
+    std::exception_ptr errors[2];
+    std::shared_ptr<CancellationToken> cancellation[2];
+    bool cancelledLoser = false;
+    bool hedged = false;             // 到达对冲延迟后发出了备用请求
+    std::future<void> backup;        // 备用请求所在的线程，调用返回前等待其结束
+
+    // 在持有锁时确定胜者并取消另一方，返回 index 是否为胜者
+    bool claimLocked(int index) {
+        if (winner == -1) {
+            winner = index;
+            if (running > 1) {
+                cancellation[1 - index]->cancel();
+                cancelledLoser = true;
+            }
+        }
+        return winner == index;
+    }
+};
+
+} // namespace
+
 AIServiceManager* AIServiceManager::instance = nullptr;
 std::mutex AIServiceManager::instanceMutex;
 
@@ -28,8 +81,70 @@ AIServiceManager* AIServiceManager::getInstance() {
         std::lock_guard<std::mutex> lock(instanceMutex);
         if (instance == nullptr) {
             instance = new AIServiceManager();
-            instance->registerService(it->second());
-            INFOLOG("AIServiceManager initialized with {}", apiProvider);
+
+            // 注册所有配置了的服务商，ai_service 指定的服务商排在首位，关闭路由时固定使用它
+            auto hedgingConfig = config->getSectionConfig("hedging");
+            std::string hedgeProvider = hedgingConfig.value("hedge_provider", "");
+            auto providers = config->getSectionConfig("api_providers");
+            std::vector<std::string> providerKeys = {apiProvider};
+            for (const auto& entry : serviceMap) {
+                if (entry.first != apiProvider && providers.contains(entry.first)) {
+                    providerKeys.push_back(entry.first);
+                }
+            }
+            for (const auto& key : providerKeys) {
+                try {
+                    auto service = serviceMap.at(key)();
+                    if (key == hedgeProvider) {
+                        instance->hedging.hedgeService = service->getServiceName();
+                    }
+                    instance->registerService(std::move(service));
+                } catch (const std::exception& e) {
+                    WARNLOG("Skipping AI service {}: {}", key, e.what());
+                }
+            }
+            if (instance->services.empty()) {
+                ERRORLOG("Failed to create AI service {}", apiProvider);
+                throw std::runtime_error("No AI service could be created");
+            }
+
+            auto routingConfig = config->getSectionConfig("routing");
+            RoutingConfig routing;
+            routing.enabled = routingConfig.value("enabled", true);
+            routing.initialLatencyMs = routingConfig.value("initial_latency_ms", 2000.0);
+            routing.latencyAlpha = routingConfig.value("latency_alpha", 0.3);
+            routing.errorAlpha = routingConfig.value("error_alpha", 0.2);
+            routing.errorPenalty = routingConfig.value("error_penalty", 4.0);
+            routing.decay = std::chrono::milliseconds(routingConfig.value("error_decay_ms", 30000));
+            instance->intentRouter = std::make_unique<ProviderRouter>(routing);
+            instance->analysisRouter = std::make_unique<ProviderRouter>(routing);
+
+            auto cacheConfig = config->getSectionConfig("intent_cache");
+            if (cacheConfig.value("enabled", false)) {
+                instance->intentCache = std::make_unique<IntentCache>(
+                    cacheConfig.value("capacity", 2048),
+                    std::chrono::seconds(cacheConfig.value("ttl_s", 1800)),
+                    cacheConfig.value("max_hamming_distance", 16),
+                    cacheConfig.value("similarity_threshold", 0.85));
+            }
+            if (hedgingConfig.value("enabled", false)) {
+                HedgingConfig& hedging = instance->hedging;
+                hedging.enabled = true;
+                hedging.latencyPercentile = hedgingConfig.value("latency_percentile", 0.95);
+                hedging.minSamples = hedgingConfig.value("min_samples", static_cast<size_t>(20));
+                hedging.defaultDelay = std::chrono::milliseconds(hedgingConfig.value("default_delay_ms", 4000));
+                hedging.minDelay = std::chrono::milliseconds(hedgingConfig.value("min_delay_ms", 500));
+                if (!hedgeProvider.empty() && hedging.hedgeService.empty()) {
+                    WARNLOG("Hedge provider {} is not available, using the best-ranked alternative", hedgeProvider);
+                }
+                INFOLOG("Hedging enabled after p{} latency, backup {}", hedging.latencyPercentile * 100,
+                        hedging.hedgeService.empty() ? "best-ranked provider" : hedging.hedgeService);
+                instance->hedgeTimerThread = std::thread(&AIServiceManager::runHedgeTimers, instance);
+            }
+            // 启动时加载并校验提示文件，请求路径上不再读取文件
+            PromptRegistry::getInstance()->preloadAll();
+            INFOLOG("AIServiceManager initialized with {} providers, default {}, routing {}",
+                    instance->services.size(), instance->services.front()->getServiceName(), routing.enabled ? "on" : "off");
         }
         return instance;
     } else {
@@ -41,9 +156,20 @@ AIServiceManager* AIServiceManager::getInstance() {
 void AIServiceManager::registerService(std::unique_ptr<AIService> service) {
     std::lock_guard<std::mutex> lock(servicesMutex);
     INFOLOG("Registering AI service: {}", service->getServiceName());
+    std::string healthCheckUrl = service->getHealthCheckUrl();
+    if (!healthCheckUrl.empty()) {
+        CircuitBreakerRegistry::getInstance()->registerHttpProbe("ai/" + service->getServiceName(), healthCheckUrl,
+                                                                 service->getHealthCheckHeaders());
+    }
     services.push_back(std::move(service));
 }
 
+// 服务已配置且熔断器未断开
+bool AIServiceManager::isUsable(AIService* service) {
+    return service->isAvailable() &&
+           CircuitBreakerRegistry::getInstance()->get("ai/" + service->getServiceName())->isCallPermitted();
+}
+
 AIService* AIServiceManager::getService(const std::string& serviceName) {
     std::lock_guard<std::mutex> lock(servicesMutex);
     for (const auto& service : services) {
@@ -54,13 +180,42 @@ AIService* AIServiceManager::getService(const std::string& serviceName) {
     return nullptr;
 }
 
-AIService* AIServiceManager::getPreferredService() {
+ProviderRouter& AIServiceManager::routerFor(LlmCallKind kind) {
+    return kind == LlmCallKind::Intent ? *intentRouter : *analysisRouter;
+}
+
+/*
+ * Summary: 获取当前应使用的服务
+ * Parameters:
+ *   LlmCallKind kind - 调用类型
+ * Return: AIService* - 选中的服务，没有可用服务时返回 nullptr
+ * Description: 熔断器断开的服务商不参与选择。开启 routing 时由该类调用的 ProviderRouter 按耗时、错误率与
+ *              进行中的请求数在可用服务商间选择；关闭时按静态优先级选择，同优先级取 ai_service 指定的服务商
+ */
+AIService* AIServiceManager::getPreferredService(LlmCallKind kind) {
     std::lock_guard<std::mutex> lock(servicesMutex);
+    ProviderRouter& router = routerFor(kind);
+    if (router.getConfig().enabled) {
+        std::vector<std::string> candidates;
+        for (const auto& service : services) {
+            if (isUsable(service.get())) {
+                candidates.push_back(service->getServiceName());
+            }
+        }
+        std::string picked = router.pick(candidates);
+        for (const auto& service : services) {
+            if (service->getServiceName() == picked) {
+                return service.get();
+            }
+        }
+        return nullptr;
+    }
+
     AIService* preferred = nullptr;
     int highestPriority = -1;
 
     for (const auto& service : services) {
-        if (service->isAvailable() && service->getPriority() > highestPriority) {
+        if (isUsable(service.get()) && service->getPriority() > highestPriority) {
             preferred = service.get();
             highestPriority = service->getPriority();
         }
@@ -69,6 +224,38 @@ AIService* AIServiceManager::getPreferredService() {
     return preferred;
 }
 
+/*
+ * Summary: 选择对冲请求的备用服务
+ * Parameters:
+ *   AIService* primary - 主服务
+ *   LlmCallKind kind - 调用类型，按该类调用的代价排序候选
+ * Return: AIService* - hedge_provider 可用且不是主服务时返回它，否则返回代价最低的其他可用服务；没有时返回 nullptr
+ */
+AIService* AIServiceManager::selectBackupService(AIService* primary, LlmCallKind kind) {
+    std::lock_guard<std::mutex> lock(servicesMutex);
+    std::vector<std::string> candidates;
+    for (const auto& service : services) {
+        if (service.get() == primary || !isUsable(service.get())) {
+            continue;
+        }
+        if (service->getServiceName() == hedging.hedgeService) {
+            return service.get();
+        }
+        candidates.push_back(service->getServiceName());
+    }
+    if (candidates.empty()) {
+        return nullptr;
+    }
+
+    std::string best = routerFor(kind).rank(candidates).front();
+    for (const auto& service : services) {
+        if (service->getServiceName() == best) {
+            return service.get();
+        }
+    }
+    return nullptr;
+}
+
 AIService* AIServiceManager::selectNextAvailableService() {
     std::lock_guard<std::mutex> lock(servicesMutex);
     if (services.empty()) {
@@ -86,10 +273,11 @@ AIService* AIServiceManager::selectNextAvailableService() {
     return nullptr;
 }
 
-nlohmann::json AIServiceManager::parseIntent(const std::string& userInput) {
+nlohmann::json AIServiceManager::parseIntent(const std::string& userInput,
+                                             const std::shared_ptr<CancellationToken>& cancellation) {
     DEBUGLOG("Parsing intent for input: {}", userInput);
     
-    AIService* service = getPreferredService();
+    AIService* service = getPreferredService(LlmCallKind::Intent);
     if (!service) {
         service = selectNextAvailableService();
     }
@@ -100,7 +288,285 @@ nlohmann::json AIServiceManager::parseIntent(const std::string& userInput) {
     }
 
     DEBUGLOG("Using service: {} to parse intent", service->getServiceName());
-    return service->parseIntent(userInput);
+    ServiceCall call = [userInput](AIService* target, const ApiCallOptions& options) {
+        return target->parseIntent(userInput, options);
+    };
+    ApiCallOptions options;
+    options.cancellation = cancellation;
+    if (!intentCache) {
+        return callWithHedging(service, LlmCallKind::Intent, call, options);
+    }
+
+    nlohmann::json cached;
+    if (intentCache->lookup(userInput, cached)) {
+        INFOLOG("Intent cache hit for input: {}", userInput);
+        return cached;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto result = callWithHedging(service, LlmCallKind::Intent, call, options);
+    double latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // 只缓存有效的意图结果
+    if (result.is_object() && result.contains("query") && !result.contains("error")) {
+        intentCache->store(userInput, result, latencyMs);
+    }
+    return result;
+}
+
+IntentCacheStats AIServiceManager::getIntentCacheStats() {
+    return intentCache ? intentCache->getStats() : IntentCacheStats();
+}
+
+std::map<std::string, ProviderHealthStats> AIServiceManager::getProviderStats() {
+    std::map<std::string, ProviderHealthStats> stats;
+    for (LlmCallKind kind : {LlmCallKind::Intent, LlmCallKind::Analysis}) {
+        for (const auto& [name, providerStats] : routerFor(kind).getStats()) {
+            stats[statsKey(name, kind)] = providerStats;
+        }
+    }
+    return stats;
+}
+
+/*
+ * Summary: 调用服务并记录耗时与结果
+ * Description: 同时更新对冲用的耗时分位数与该类调用的路由健康度；被取消的请求不计为服务商错误
+ */
+nlohmann::json AIServiceManager::invokeService(AIService* service, LlmCallKind kind, const ServiceCall& call,
+                                               const ApiCallOptions& options) {
+    std::string name = service->getServiceName();
+    ProviderRouter& router = routerFor(kind);
+    auto start = Clock::now();
+    router.onStart(name);
+    try {
+        nlohmann::json result = call(service, options);
+        double latencyMs = elapsedMs(start);
+        router.onFinish(name, latencyMs, true);
+        latencyTracker.record(statsKey(name, kind), latencyMs);
+        return result;
+    } catch (const RequestCancelled&) {
+        router.onCancel(name, elapsedMs(start));
+        throw;
+    } catch (const CircuitOpenError&) {
+        // 熔断器已记录该服务商的故障，快速失败不再计入路由的耗时与错误率
+        router.onCancel(name, 0.0);
+        throw;
+    } catch (...) {
+        router.onFinish(name, elapsedMs(start), false);
+        throw;
+    }
+}
+
+HedgingStats AIServiceManager::getHedgingStats() {
+    std::lock_guard<std::mutex> lock(hedgingStatsMutex);
+    return hedgingStats;
+}
+
+nlohmann::json AIServiceManager::searchParser(AIService* service, const std::string& prompt,
+                                              const ApiCallOptions& options) {
+    ServiceCall call = [prompt](AIService* target, const ApiCallOptions& attemptOptions) {
+        return target->searchParser(prompt, attemptOptions);
+    };
+    return callWithHedging(service, LlmCallKind::Analysis, call, options);
+}
+
+/*
+ * Summary: 计算对冲触发延迟
+ * Parameters:
+ *   AIService* primary - 主服务
+ *   LlmCallKind kind - 调用类型
+ * Return: std::chrono::milliseconds - 主服务最近同类调用耗时的 latency_percentile 分位数，
+ *                                     样本不足时为 default_delay_ms，且不低于 min_delay_ms
+ */
+std::chrono::milliseconds AIServiceManager::hedgeDelay(AIService* primary, LlmCallKind kind) {
+    double percentileMs = 0.0;
+    std::chrono::milliseconds delay = hedging.defaultDelay;
+    if (latencyTracker.percentile(statsKey(primary->getServiceName(), kind), hedging.latencyPercentile,
+                                  hedging.minSamples, percentileMs)) {
+        delay = std::chrono::milliseconds(static_cast<int64_t>(percentileMs));
+    }
+    return std::max(delay, hedging.minDelay);
+}
+
+/*
+ * Summary: 带对冲的服务调用
+ * Parameters:
+ *   AIService* primary - 主服务
+ *   LlmCallKind kind - 调用类型，决定使用哪一组耗时分位数
+ *   const ServiceCall& call - 实际调用，按值捕获参数
+ *   const ApiCallOptions& options - 调用选项
+ * Return: nlohmann::json - 胜出一方的结果
+ * Description: 主请求直接在调用线程中执行，同时在定时线程登记对冲延迟；到期时主请求仍未返回才启动线程
+ *              请求备用服务商，主请求在延迟内失败时则在调用线程中接着请求备用服务商。
+ *              非流式调用先成功的一方胜出，流式调用先输出内容的一方胜出，落败方的请求经 cancelled 标志中止，
+ *              其输出的内容会被丢弃；返回前等待备用请求结束。两方均失败时抛出胜者（或主服务）的异常
+ */
+nlohmann::json AIServiceManager::callWithHedging(AIService* primary, LlmCallKind kind, const ServiceCall& call,
+                                                 const ApiCallOptions& options) {
+    AIService* backup = hedging.enabled ? selectBackupService(primary, kind) : nullptr;
+    if (!backup) {
+        return invokeService(primary, kind, call, options);
+    }
+
+    auto race = std::make_shared<HedgeRace>(options.cancellation);
+    auto start = Clock::now();
+    // 执行一方的请求并登记结果，调用前需已在持有锁时递增 running
+    auto attempt = [this, race, kind, call, options, start](int index, AIService* service) {
+        ApiCallOptions attemptOptions = options;
+        attemptOptions.cancellation = race->cancellation[index];
+        if (options.onToken) {
+            attemptOptions.onToken = [race, index, onToken = options.onToken](const std::string& delta) {
+                bool won;
+                {
+                    std::lock_guard<std::mutex> lock(race->mutex);
+                    won = race->claimLocked(index);
+                }
+                if (won) {
+                    onToken(delta);
+                }
+            };
+        }
+
+        try {
+            nlohmann::json result = invokeService(service, kind, call, attemptOptions);
+            std::lock_guard<std::mutex> lock(race->mutex);
+            if (race->claimLocked(index)) {
+                race->result = std::move(result);
+                race->resultReady = true;
+            }
+        } catch (const RequestCancelled&) {
+            // 主请求被取消时已超过对冲延迟，按已耗时记一个样本，避免分位数只统计快请求而不断下降
+            if (index == 0) {
+                latencyTracker.record(statsKey(service->getServiceName(), kind), elapsedMs(start));
+            }
+            std::lock_guard<std::mutex> lock(race->mutex);
+            race->errors[index] = std::current_exception();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(race->mutex);
+            race->errors[index] = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(race->mutex);
+        --race->running;
+        race->finished.notify_all();
+    };
+
+    std::chrono::milliseconds delay = hedgeDelay(primary, kind);
+    {
+        std::lock_guard<std::mutex> lock(race->mutex);
+        ++race->running;
+    }
+    // 主请求结束后 running 归零，此后到期的回调不会再发出备用请求
+    HedgeTimerKey timer = scheduleHedge(start + delay, [race, attempt, options, primary, backup, delay]() {
+        std::lock_guard<std::mutex> lock(race->mutex);
+        if (race->hedged || race->running == 0 || race->resultReady || race->winner != -1 || options.isCancelled()) {
+            return;
+        }
+        DEBUGLOG("{} has not answered within {} ms, hedging with {}",
+                 primary->getServiceName(), delay.count(), backup->getServiceName());
+        race->hedged = true;
+        ++race->running;
+        race->backup = std::async(std::launch::async, attempt, 1, backup);
+    });
+    attempt(0, primary);
+    cancelHedge(timer);
+
+    std::unique_lock<std::mutex> lock(race->mutex);
+    // 主请求在对冲延迟内失败，直接在当前线程请求备用服务商；调用方已取消时不再发出
+    if (!race->hedged && !race->resultReady && race->winner == -1 && !options.isCancelled()) {
+        race->hedged = true;
+        ++race->running;
+        lock.unlock();
+        attempt(1, backup);
+        lock.lock();
+    }
+    // 移出 future 再等待：其共享状态持有捕获了 race 的回调，留在 race 中会形成循环引用
+    if (race->backup.valid()) {
+        std::future<void> backupDone = std::move(race->backup);
+        lock.unlock();
+        backupDone.wait();
+        lock.lock();
+    }
+    bool hedged = race->hedged;
+
+    {
+        std::lock_guard<std::mutex> statsLock(hedgingStatsMutex);
+        ++hedgingStats.calls;
+        hedgingStats.hedged += hedged ? 1 : 0;
+        if (race->resultReady && race->winner == 0) {
+            ++hedgingStats.primaryWins;
+        } else if (race->resultReady) {
+            ++hedgingStats.hedgeWins;
+        } else {
+            ++hedgingStats.failures;
+        }
+        hedgingStats.cancelled += race->cancelledLoser ? 1 : 0;
+    }
+
+    if (race->resultReady) {
+        if (race->winner == 1) {
+            INFOLOG("Hedged request to {} answered before {}", backup->getServiceName(), primary->getServiceName());
+        }
+        return race->result;
+    }
+    int failed = race->winner != -1 ? race->winner : 0;
+    std::exception_ptr error = race->errors[failed] ? race->errors[failed] : race->errors[1 - failed];
+    lock.unlock();
+    std::rethrow_exception(error);
+}
+
+AIServiceManager::~AIServiceManager() {
+    {
+        std::lock_guard<std::mutex> lock(hedgeTimersMutex);
+        stoppingHedgeTimers = true;
+    }
+    hedgeTimersCondition.notify_all();
+    if (hedgeTimerThread.joinable()) {
+        hedgeTimerThread.join();
+    }
+}
+
+AIServiceManager::HedgeTimerKey AIServiceManager::scheduleHedge(Clock::time_point due, std::function<void()> callback) {
+    HedgeTimerKey key;
+    {
+        std::lock_guard<std::mutex> lock(hedgeTimersMutex);
+        key = {due, nextHedgeTimerId++};
+        hedgeTimers.emplace(key, std::move(callback));
+    }
+    hedgeTimersCondition.notify_one();
+    return key;
+}
+
+void AIServiceManager::cancelHedge(const HedgeTimerKey& key) {
+    std::lock_guard<std::mutex> lock(hedgeTimersMutex);
+    hedgeTimers.erase(key);
+}
+
+/*
+ * Summary: 对冲定时线程主循环
+ * Description: 回调在锁外执行，只做状态检查和启动备用请求，不会阻塞其他调用的定时
+ */
+void AIServiceManager::runHedgeTimers() {
+    std::unique_lock<std::mutex> lock(hedgeTimersMutex);
+    while (!stoppingHedgeTimers) {
+        if (hedgeTimers.empty()) {
+            hedgeTimersCondition.wait(lock);
+            continue;
+        }
+        auto due = hedgeTimers.begin()->first.first;
+        if (Clock::now() < due) {
+            hedgeTimersCondition.wait_until(lock, due);
+            continue;
+        }
+        std::function<void()> callback = std::move(hedgeTimers.begin()->second);
+        hedgeTimers.erase(hedgeTimers.begin());
+        lock.unlock();
+        try {
+            callback();
+        } catch (const std::exception& e) {
+            ERRORLOG("Hedge timer callback failed: {}", e.what());
+        }
+        lock.lock();
+    }
 }
 
 } // namespace IntelliSearch 
\ No newline at end of file
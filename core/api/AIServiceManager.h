@@ -2,12 +2,47 @@
 #define INTELLISEARCH_AISERVICEMANAGER_H
 
 #include "AIService/AIService.h"
+#include "IntentCache.h"
+#include "LatencyTracker.h"
+#include "ProviderRouter.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
 #include <memory>
 #include <vector>
 #include <mutex>
+#include <thread>
 
 namespace IntelliSearch {
 
+// LLM 调用类型：意图解析请求短，结果分析请求长且多为流式，两者的耗时与路由健康度分开统计
+enum class LlmCallKind {
+    Intent,
+    Analysis
+};
+
+// 对冲请求配置（hedging 配置节）
+struct HedgingConfig {
+    bool enabled = false;
+    std::string hedgeService;                      // 备用服务名，为空或不可用时取代价最低的其他服务商
+    double latencyPercentile = 0.95;               // 主服务商超过该分位耗时仍未返回时发出备用请求
+    size_t minSamples = 20;                        // 样本不足时使用 defaultDelay
+    std::chrono::milliseconds defaultDelay{4000};
+    std::chrono::milliseconds minDelay{500};
+};
+
+// 对冲请求统计
+struct HedgingStats {
+    uint64_t calls = 0;          // 开启对冲后经过的调用数
+    uint64_t hedged = 0;         // 发出了备用请求的调用数
+    uint64_t primaryWins = 0;    // 主服务商先返回（含未触发对冲）
+    uint64_t hedgeWins = 0;      // 备用服务商先返回
+    uint64_t cancelled = 0;      // 被取消的落败请求数
+    uint64_t failures = 0;       // 两方均失败的调用数
+};
+
 class AIServiceManager {
 public:
     static AIServiceManager* getInstance();
@@ -18,15 +53,30 @@ public:
     // 根据服务名称获取服务
     AIService* getService(const std::string& serviceName);
 
-    // 获取当前可用的最高优先级服务
-    AIService* getPreferredService();
+    // 获取当前应使用的服务：开启 routing 时按该类调用的实时健康度选择，否则取最高优先级服务
+    AIService* getPreferredService(LlmCallKind kind);
+
+    // 解析用户输入意图；开启 intent_cache 时相同或近似的输入直接复用缓存结果。
+    // cancellation 被取消时中止请求并抛出 RequestCancelled
+    nlohmann::json parseIntent(const std::string& userInput,
+                               const std::shared_ptr<CancellationToken>& cancellation = nullptr);
 
-    // 解析用户输入意图
-    nlohmann::json parseIntent(const std::string& userInput);
+    // 使用指定服务分析搜索结果；开启 hedging 时主服务超时未返回会同时请求备用服务商
+    nlohmann::json searchParser(AIService* service, const std::string& prompt,
+                                const ApiCallOptions& options = ApiCallOptions());
+
+    // 意图缓存统计，未开启时返回全零
+    IntentCacheStats getIntentCacheStats();
+
+    // 对冲请求统计，未开启时返回全零
+    HedgingStats getHedgingStats();
+
+    // 各服务商的路由健康度统计，键为“服务名/调用类型”
+    std::map<std::string, ProviderHealthStats> getProviderStats();
 
 private:
     AIServiceManager() = default;
-    ~AIServiceManager() = default;
+    ~AIServiceManager();
 
     AIServiceManager(const AIServiceManager&) = delete;
     AIServiceManager& operator=(const AIServiceManager&) = delete;
@@ -34,12 +84,68 @@ private:
     // 选择下一个可用服务（用于故障转移）
     AIService* selectNextAvailableService();
 
+    // 服务已配置且熔断器未断开
+    bool isUsable(AIService* service);
+
+    // 选择对冲请求的备用服务
+    AIService* selectBackupService(AIService* primary, LlmCallKind kind);
+
+    // 该类调用使用的路由器
+    ProviderRouter& routerFor(LlmCallKind kind);
+
+    using ServiceCall = std::function<nlohmann::json(AIService* service, const ApiCallOptions& options)>;
+
+    // 调用服务并更新耗时分位数与路由健康度
+    nlohmann::json invokeService(AIService* service, LlmCallKind kind, const ServiceCall& call,
+                                 const ApiCallOptions& options);
+
+    // 调用服务并记录耗时；开启 hedging 时按主服务同类调用的耗时分位数决定是否发出备用请求，
+    // 先返回的一方胜出，另一方被取消。备用请求在其他线程中执行，call 只能按值捕获
+    nlohmann::json callWithHedging(AIService* primary, LlmCallKind kind, const ServiceCall& call,
+                                   const ApiCallOptions& options);
+
+    // 主服务该类调用的对冲触发延迟
+    std::chrono::milliseconds hedgeDelay(AIService* primary, LlmCallKind kind);
+
+    using HedgeTimerKey = std::pair<std::chrono::steady_clock::time_point, uint64_t>;
+
+    // 登记到期时在定时线程上执行的回调，返回用于撤销的键
+    HedgeTimerKey scheduleHedge(std::chrono::steady_clock::time_point due, std::function<void()> callback);
+
+    // 撤销尚未执行的回调；回调已在执行时不等待其结束
+    void cancelHedge(const HedgeTimerKey& key);
+
+    // 对冲定时线程：休眠到最早的触发时间，依次执行到期的回调
+    void runHedgeTimers();
+
     static AIServiceManager* instance;
     static std::mutex instanceMutex;
 
     std::vector<std::unique_ptr<AIService>> services;
     std::mutex servicesMutex;
     size_t currentServiceIndex{0};
+
+    // 意图缓存，未开启时为空
+    std::unique_ptr<IntentCache> intentCache;
+
+    // 各服务商最近的调用耗时，按服务商与调用类型分别统计
+    LatencyTracker latencyTracker;
+
+    // 按健康度分配请求，意图解析与结果分析各用一个路由器，互不影响耗时 EWMA
+    std::unique_ptr<ProviderRouter> intentRouter;
+    std::unique_ptr<ProviderRouter> analysisRouter;
+
+    HedgingConfig hedging;
+    std::mutex hedgingStatsMutex;
+    HedgingStats hedgingStats;
+
+    // 所有对冲调用共用一个定时线程，只有到达对冲延迟时才为备用请求启动线程
+    std::mutex hedgeTimersMutex;
+    std::condition_variable hedgeTimersCondition;
+    std::map<HedgeTimerKey, std::function<void()>> hedgeTimers;
+    uint64_t nextHedgeTimerId = 0;
+    bool stoppingHedgeTimers = false;
+    std::thread hedgeTimerThread;
 };
 
 } // namespace IntelliSearch
@@ -2,6 +2,7 @@
 #define INTELLISEARCH_APISERVICE_H
 
 #include <string>
+#include <vector>
 #include <nlohmann/json.hpp>
 
 namespace IntelliSearch {
@@ -19,6 +20,12 @@ public:
     // 获取服务优先级（用于负载均衡和故障转移）
     virtual int getPriority() const = 0;
 
+    // 熔断后用于后台探测的地址（轻量 GET 请求），为空时改用半开状态的试探请求
+    virtual std::string getHealthCheckUrl() const { return ""; }
+
+    // 探测请求附带的请求头，用于需要鉴权的探测地址
+    virtual std::vector<std::string> getHealthCheckHeaders() const { return {}; }
+
 protected:
     // API调用的通用错误处理
     virtual void handleError(const std::string& error) = 0;
@@ -0,0 +1,243 @@
+#include "AsyncHttpClient.h"
+#include "../log/Logger.h"
+#include <stdexcept>
+
+namespace IntelliSearch {
+
+std::unique_ptr<AsyncHttpClient> AsyncHttpClient::instance = nullptr;
+std::mutex AsyncHttpClient::instanceMutex;
+
+AsyncHttpClient* AsyncHttpClient::getInstance() {
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    if (!instance) {
+        instance = std::unique_ptr<AsyncHttpClient>(new AsyncHttpClient());
+    }
+    return instance.get();
+}
+
+/*
+ * Summary: AsyncHttpClient构造函数
+ * Description: 创建 multi 句柄并启动 I/O 线程
+ */
+AsyncHttpClient::AsyncHttpClient() {
+    // 确保 curl_global_init 先于 multi 句柄执行
+    HttpConnectionPool::getInstance();
+
+    multi = curl_multi_init();
+    if (!multi) {
+        ERRORLOG("Failed to initialize CURL multi handle");
+        throw std::runtime_error("CURL multi initialization failed");
+    }
+
+    ioThread = std::thread(&AsyncHttpClient::run, this);
+    INFOLOG("AsyncHttpClient I/O thread started");
+}
+
+/*
+ * Summary: AsyncHttpClient析构函数
+ * Description: 停止 I/O 线程，未完成的请求以 CURLE_ABORTED_BY_CALLBACK 回调
+ */
+AsyncHttpClient::~AsyncHttpClient() {
+    stopping = true;
+    curl_multi_wakeup(multi);
+    if (ioThread.joinable()) {
+        ioThread.join();
+    }
+    curl_multi_cleanup(multi);
+}
+
+std::future<HttpResponse> AsyncHttpClient::send(HttpRequest request) {
+    auto promise = std::make_shared<std::promise<HttpResponse>>();
+    auto future = promise->get_future();
+    send(std::move(request), [promise](HttpResponse response) {
+        promise->set_value(std::move(response));
+    });
+    return future;
+}
+
+/*
+ * Summary: 提交请求
+ * Parameters:
+ *   HttpRequest request - 请求参数
+ *   HttpCompletion onComplete - 完成回调
+ * Description: 从连接池租借句柄后放入队列并唤醒 I/O 线程，本函数不会阻塞等待网络
+ */
+void AsyncHttpClient::send(HttpRequest request, HttpCompletion onComplete) {
+    auto transfer = std::make_unique<Transfer>(std::move(request), std::move(onComplete),
+                                               HttpConnectionPool::getInstance()->acquire());
+    ++inFlight;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        pending.push_back(std::move(transfer));
+    }
+    curl_multi_wakeup(multi);
+}
+
+void AsyncHttpClient::wakeup() {
+    sweepRequested = true;
+    curl_multi_wakeup(multi);
+}
+
+size_t AsyncHttpClient::writeCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+    size_t totalSize = size * nmemb;
+    auto* transfer = static_cast<Transfer*>(userp);
+    if (transfer->request.onData) {
+        // 返回与数据长度不同的值会使 curl 以 CURLE_WRITE_ERROR 中止传输；异常不能穿过 curl 的 C 代码
+        try {
+            return transfer->request.onData(static_cast<char*>(contents), totalSize) ? totalSize : 0;
+        } catch (const std::exception& e) {
+            ERRORLOG("HTTP data callback threw: {}", e.what());
+            return 0;
+        }
+    }
+    transfer->response.body.append(static_cast<char*>(contents), totalSize);
+    return totalSize;
+}
+
+// 返回非零值时 curl 中止传输；取消方调用 wakeup() 时由 abortCancelledTransfers 立即中止，
+// 进度回调作为兜底，在传输空闲时也会周期调用
+int AsyncHttpClient::progressCallback(void* userp, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+    auto* transfer = static_cast<Transfer*>(userp);
+    return transfer->request.cancelled && transfer->request.cancelled->load() ? 1 : 0;
+}
+
+void AsyncHttpClient::startPendingTransfers() {
+    std::deque<std::unique_ptr<Transfer>> batch;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        batch.swap(pending);
+    }
+
+    for (auto& transfer : batch) {
+        CURL* curl = transfer->handle.get();
+        const auto& request = transfer->request;
+
+        // 排队期间已被取消的请求不再发出
+        if (request.cancelled && request.cancelled->load()) {
+            transfer->response.curlCode = CURLE_ABORTED_BY_CALLBACK;
+            transfer->response.error = "Request cancelled";
+            --inFlight;
+            transfer->onComplete(std::move(transfer->response));
+            continue;
+        }
+
+        for (const auto& header : request.headers) {
+            transfer->headers = curl_slist_append(transfer->headers, header.c_str());
+        }
+
+        curl_easy_setopt(curl, CURLOPT_URL, request.url.c_str());
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, transfer->headers);
+        if (request.method == "GET") {
+            curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+        } else {
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, request.body.c_str());
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(request.body.size()));
+        }
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, request.timeoutMs);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &AsyncHttpClient::writeCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, transfer.get());
+        curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, transfer->errorBuffer);
+        curl_easy_setopt(curl, CURLOPT_PRIVATE, transfer.get());
+        if (request.acceptCompressed) {
+            curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+        }
+        if (request.cancelled) {
+            curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, &AsyncHttpClient::progressCallback);
+            curl_easy_setopt(curl, CURLOPT_XFERINFODATA, transfer.get());
+            curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+        } else {
+            curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1L);
+        }
+
+        CURLMcode code = curl_multi_add_handle(multi, curl);
+        if (code != CURLM_OK) {
+            ERRORLOG("Failed to add transfer to multi handle: {}", curl_multi_strerror(code));
+            transfer->response.curlCode = CURLE_FAILED_INIT;
+            transfer->response.error = curl_multi_strerror(code);
+            curl_slist_free_all(transfer->headers);
+            --inFlight;
+            transfer->onComplete(std::move(transfer->response));
+            continue;
+        }
+        active.emplace(curl, std::move(transfer));
+    }
+}
+
+void AsyncHttpClient::finishTransfer(CURL* curl, CURLcode result) {
+    auto it = active.find(curl);
+    if (it == active.end()) {
+        return;
+    }
+    std::unique_ptr<Transfer> transfer = std::move(it->second);
+    active.erase(it);
+
+    curl_multi_remove_handle(multi, curl);
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &transfer->response.statusCode);
+    curl_slist_free_all(transfer->headers);
+    transfer->headers = nullptr;
+
+    transfer->response.curlCode = result;
+    if (result != CURLE_OK) {
+        transfer->response.error = transfer->errorBuffer[0] ? transfer->errorBuffer : curl_easy_strerror(result);
+    }
+
+    --inFlight;
+    try {
+        transfer->onComplete(std::move(transfer->response));
+    } catch (const std::exception& e) {
+        ERRORLOG("HTTP completion callback threw: {}", e.what());
+    }
+    // transfer 析构时句柄归还连接池
+}
+
+void AsyncHttpClient::abortCancelledTransfers() {
+    std::vector<CURL*> cancelled;
+    for (const auto& entry : active) {
+        const auto& flag = entry.second->request.cancelled;
+        if (flag && flag->load()) {
+            cancelled.push_back(entry.first);
+        }
+    }
+    for (CURL* curl : cancelled) {
+        finishTransfer(curl, CURLE_ABORTED_BY_CALLBACK);
+    }
+}
+
+/*
+ * Summary: I/O 线程主循环
+ * Description: 接收新请求、驱动所有传输并分发完成事件；没有事件时阻塞在 curl_multi_poll，
+ *              send() 通过 curl_multi_wakeup 唤醒
+ */
+void AsyncHttpClient::run() {
+    while (!stopping) {
+        startPendingTransfers();
+        if (sweepRequested.exchange(false)) {
+            abortCancelledTransfers();
+        }
+
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        CURLMsg* message = nullptr;
+        int remaining = 0;
+        while ((message = curl_multi_info_read(multi, &remaining)) != nullptr) {
+            if (message->msg == CURLMSG_DONE) {
+                finishTransfer(message->easy_handle, message->data.result);
+            }
+        }
+
+        curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+    }
+
+    // 退出前中止仍在进行和排队的请求
+    startPendingTransfers();
+    std::vector<CURL*> remainingHandles;
+    for (const auto& entry : active) {
+        remainingHandles.push_back(entry.first);
+    }
+    for (CURL* curl : remainingHandles) {
+        finishTransfer(curl, CURLE_ABORTED_BY_CALLBACK);
+    }
+}
+
+} // namespace IntelliSearch
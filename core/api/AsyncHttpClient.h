@@ -0,0 +1,121 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 基于 curl_multi 的事件驱动 HTTP 客户端，由单个 I/O 线程复用所有进行中的请求，
+ *              调用方通过 future 或完成回调获取结果，不再为每个请求阻塞一个线程
+ */
+
+#ifndef INTELLISEARCH_ASYNCHTTPCLIENT_H
+#define INTELLISEARCH_ASYNCHTTPCLIENT_H
+
+#include "HttpConnectionPool.h"
+#include <curl/curl.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace IntelliSearch {
+
+struct HttpRequest {
+    std::string url;
+    std::vector<std::string> headers;
+    std::string method = "POST"; // "POST" 或 "GET"
+    std::string body;            // POST 请求体
+    long timeoutMs = 30000;
+    bool acceptCompressed = false;
+    // 非空时每收到一段响应数据回调一次（在 I/O 线程中执行，不可阻塞），返回 false 中止传输
+    std::function<bool(const char* data, size_t size)> onData;
+    // 非空时由进度回调轮询，被置位后以 CURLE_ABORTED_BY_CALLBACK 中止传输
+    std::shared_ptr<std::atomic<bool>> cancelled;
+};
+
+struct HttpResponse {
+    CURLcode curlCode = CURLE_OK;
+    long statusCode = 0;
+    std::string body;            // 设置了 onData 时为空
+    std::string error;           // curl 错误描述
+
+    bool ok() const { return curlCode == CURLE_OK; }
+};
+
+// 请求完成回调，在 I/O 线程中执行
+using HttpCompletion = std::function<void(HttpResponse response)>;
+
+class AsyncHttpClient {
+public:
+    static AsyncHttpClient* getInstance();
+    ~AsyncHttpClient();
+
+    // 提交请求，返回的 future 在请求完成（含失败）时就绪
+    std::future<HttpResponse> send(HttpRequest request);
+
+    // 提交请求，完成后在 I/O 线程中调用 onComplete
+    void send(HttpRequest request, HttpCompletion onComplete);
+
+    // 唤醒 I/O 线程，立即中止取消标志已被置位的传输
+    void wakeup();
+
+    // 当前排队及进行中的请求数
+    size_t inFlightCount() const { return inFlight.load(); }
+
+private:
+    AsyncHttpClient();
+
+    AsyncHttpClient(const AsyncHttpClient&) = delete;
+    AsyncHttpClient& operator=(const AsyncHttpClient&) = delete;
+
+    // 单个请求的传输状态，生命周期从 send 到完成回调
+    struct Transfer {
+        Transfer(HttpRequest request, HttpCompletion onComplete, HttpConnectionPool::Handle handle)
+            : request(std::move(request)), onComplete(std::move(onComplete)), handle(std::move(handle)) {}
+
+        HttpRequest request;
+        HttpCompletion onComplete;
+        HttpConnectionPool::Handle handle;
+        curl_slist* headers = nullptr;
+        HttpResponse response;
+        char errorBuffer[CURL_ERROR_SIZE] = {0};
+    };
+
+    // I/O 线程主循环
+    void run();
+
+    // 将排队的请求加入 multi 句柄
+    void startPendingTransfers();
+
+    // 处理已完成的传输并回调
+    void finishTransfer(CURL* curl, CURLcode result);
+
+    // 以 CURLE_ABORTED_BY_CALLBACK 结束所有已被取消的传输
+    void abortCancelledTransfers();
+
+    static size_t writeCallback(void* contents, size_t size, size_t nmemb, void* userp);
+    static int progressCallback(void* userp, curl_off_t, curl_off_t, curl_off_t, curl_off_t);
+
+    static std::unique_ptr<AsyncHttpClient> instance;
+    static std::mutex instanceMutex;
+
+    CURLM* multi;
+    std::thread ioThread;
+    std::atomic<bool> stopping{false};
+    std::atomic<size_t> inFlight{0};
+    std::atomic<bool> sweepRequested{false};   // wakeup() 置位，I/O 线程据此检查取消标志
+
+    std::mutex queueMutex;
+    std::deque<std::unique_ptr<Transfer>> pending;
+
+    // 仅由 I/O 线程访问
+    std::unordered_map<CURL*, std::unique_ptr<Transfer>> active;
+};
+
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_ASYNCHTTPCLIENT_H
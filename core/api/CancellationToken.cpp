@@ -0,0 +1,102 @@
+#include "CancellationToken.h"
+
+namespace IntelliSearch {
+
+CancellationToken::CancellationToken() : cancelledFlag(std::make_shared<std::atomic<bool>>(false)) {}
+
+CancellationToken::~CancellationToken() {
+    if (parentSubscription != 0) {
+        if (auto token = parent.lock()) {
+            token->unsubscribe(parentSubscription);
+        }
+    }
+}
+
+/*
+ * Summary: 创建子令牌
+ * Parameters:
+ *   const std::shared_ptr<CancellationToken>& parent - 父令牌，可为空
+ * Return: std::shared_ptr<CancellationToken> - 父令牌取消时随之取消的新令牌
+ * Description: 父令牌只持有子令牌的弱引用，子令牌析构时注销登记在父令牌上的回调；
+ *              父令牌已取消时子令牌创建后即为已取消。
+ *              对冲请求用它让单个尝试既能被落败取消，也能随整个搜索取消
+ */
+std::shared_ptr<CancellationToken> CancellationToken::linkedTo(const std::shared_ptr<CancellationToken>& parent) {
+    auto child = std::make_shared<CancellationToken>();
+    if (parent) {
+        std::weak_ptr<CancellationToken> weakChild = child;
+        child->parent = parent;
+        child->parentSubscription = parent->subscribe([weakChild]() {
+            if (auto token = weakChild.lock()) {
+                token->cancel();
+            }
+        });
+    }
+    return child;
+}
+
+void CancellationToken::cancel() {
+    std::map<uint64_t, Callback> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cancelledFlag->exchange(true)) {
+            return;
+        }
+        pending.swap(callbacks);
+    }
+    cancelledCondition.notify_all();
+    // 回调在锁外执行，可以再访问本令牌
+    for (auto& entry : pending) {
+        entry.second();
+    }
+}
+
+void CancellationToken::throwIfCancelled(const std::string& what) const {
+    if (isCancelled()) {
+        throw RequestCancelled(what + " cancelled");
+    }
+}
+
+uint64_t CancellationToken::subscribe(Callback callback) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!cancelledFlag->load()) {
+            uint64_t id = nextId++;
+            callbacks.emplace(id, std::move(callback));
+            return id;
+        }
+    }
+    callback();
+    return 0;
+}
+
+void CancellationToken::unsubscribe(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    callbacks.erase(id);
+}
+
+size_t CancellationToken::subscriptionCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return callbacks.size();
+}
+
+bool CancellationToken::waitFor(std::chrono::milliseconds duration) {
+    std::unique_lock<std::mutex> lock(mutex);
+    return cancelledCondition.wait_for(lock, duration, [this]() { return cancelledFlag->load(); });
+}
+
+CancellationSubscription::CancellationSubscription(std::shared_ptr<CancellationToken> token,
+                                                   CancellationToken::Callback callback)
+    : token(std::move(token)) {
+    if (this->token) {
+        id = this->token->subscribe(std::move(callback));
+    }
+}
+
+CancellationSubscription::~CancellationSubscription() {
+    if (token && id != 0) {
+        token->unsubscribe(id);
+    }
+}
+
+} // namespace IntelliSearch
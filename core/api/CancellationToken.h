@@ -0,0 +1,96 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 协作式取消令牌。由发起搜索的一方创建，沿意图解析、网页搜索与结果分析逐层传递；
+ *              取消时立即执行已登记的回调（撤回限流排队、唤醒 I/O 线程中止传输），
+ *              各层在阻塞点检查令牌并抛出 RequestCancelled
+ */
+
+#ifndef INTELLISEARCH_CANCELLATIONTOKEN_H
+#define INTELLISEARCH_CANCELLATIONTOKEN_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace IntelliSearch {
+
+// 请求被调用方主动取消
+class RequestCancelled : public std::runtime_error {
+public:
+    explicit RequestCancelled(const std::string& message) : std::runtime_error(message) {}
+};
+
+class CancellationToken {
+public:
+    using Callback = std::function<void()>;
+
+    CancellationToken();
+    ~CancellationToken();
+
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+
+    // 创建随 parent 一同取消的子令牌，子令牌也可单独取消；parent 为空时等同于新令牌。
+    // 子令牌析构时从 parent 注销，长期存在的 parent 不会积累已失效的回调
+    static std::shared_ptr<CancellationToken> linkedTo(const std::shared_ptr<CancellationToken>& parent);
+
+    // 置位并执行所有已登记的回调，重复调用无效果
+    void cancel();
+
+    bool isCancelled() const { return cancelledFlag->load(); }
+
+    // 已取消时抛出 RequestCancelled
+    void throwIfCancelled(const std::string& what) const;
+
+    // 登记取消回调并返回编号；已取消时在当前线程立即执行并返回 0。
+    // 回调可能在任意线程执行，只能按值捕获
+    uint64_t subscribe(Callback callback);
+    void unsubscribe(uint64_t id);
+
+    // 最多等待 duration，期间被取消时提前返回 true
+    bool waitFor(std::chrono::milliseconds duration);
+
+    // 供 HttpRequest 的进度回调轮询的标志
+    std::shared_ptr<std::atomic<bool>> flag() const { return cancelledFlag; }
+
+    // 尚未执行的已登记回调数
+    size_t subscriptionCount();
+
+private:
+    std::shared_ptr<std::atomic<bool>> cancelledFlag;
+    std::mutex mutex;
+    std::condition_variable cancelledCondition;
+    std::map<uint64_t, Callback> callbacks;
+    uint64_t nextId = 1;
+
+    // linkedTo 创建的子令牌在父令牌上登记的回调，析构时注销
+    std::weak_ptr<CancellationToken> parent;
+    uint64_t parentSubscription = 0;
+};
+
+// 作用域内有效的取消回调，析构时注销；token 为空时不做任何事
+class CancellationSubscription {
+public:
+    CancellationSubscription(std::shared_ptr<CancellationToken> token, CancellationToken::Callback callback);
+    ~CancellationSubscription();
+
+    CancellationSubscription(const CancellationSubscription&) = delete;
+    CancellationSubscription& operator=(const CancellationSubscription&) = delete;
+
+private:
+    std::shared_ptr<CancellationToken> token;
+    uint64_t id = 0;
+};
+
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_CANCELLATIONTOKEN_H
@@ -0,0 +1,354 @@
+#include "CircuitBreaker.h"
+#include "AsyncHttpClient.h"
+#include "../log/Logger.h"
+#include "../config/ConfigManager.h"
+#include <algorithm>
+#include <vector>
+
+namespace IntelliSearch {
+
+CircuitBreaker::CircuitBreaker(std::string name, CircuitBreakerConfig config)
+    : name(std::move(name)), config(config) {}
+
+bool CircuitBreaker::tryAcquire() {
+    if (!config.enabled) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    switch (state) {
+    case CircuitState::Closed:
+        return true;
+    case CircuitState::Open:
+        if (timedHalfOpenDueLocked(Clock::now())) {
+            INFOLOG("Circuit {} half-open, allowing a trial request", name);
+            halfOpenLocked();
+            trialInFlight = true;
+            return true;
+        }
+        break;
+    case CircuitState::HalfOpen:
+        if (!trialInFlight) {
+            trialInFlight = true;
+            return true;
+        }
+        break;
+    }
+    ++stats.rejected;
+    return false;
+}
+
+bool CircuitBreaker::isCallPermitted() {
+    if (!config.enabled) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    switch (state) {
+    case CircuitState::Closed:
+        return true;
+    case CircuitState::Open:
+        return timedHalfOpenDueLocked(Clock::now());
+    case CircuitState::HalfOpen:
+        return !trialInFlight;
+    }
+    return true;
+}
+
+void CircuitBreaker::onSuccess() {
+    if (!config.enabled) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (state == CircuitState::HalfOpen) {
+        INFOLOG("Circuit {} closed after a successful trial request", name);
+        closeLocked();
+        return;
+    }
+    if (state == CircuitState::Closed) {
+        window.push_back(false);
+        if (window.size() > config.windowSize) {
+            windowFailures -= window.front() ? 1 : 0;
+            window.pop_front();
+        }
+    }
+}
+
+/*
+ * Summary: 记录一次失败
+ * Parameters:
+ *   bool timeout - 是否为超时
+ * Description: 关闭状态下失败计入滑动窗口，窗口内失败数达到阈值时断开；半开状态的试探请求失败时立即再次断开。
+ *              断开期间迟到的结果不再计入
+ */
+void CircuitBreaker::onFailure(bool timeout) {
+    if (!config.enabled) {
+        return;
+    }
+    bool opened = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++stats.failures;
+        stats.timeouts += timeout ? 1 : 0;
+        if (state == CircuitState::HalfOpen) {
+            WARNLOG("Circuit {} trial request failed", name);
+            openLocked(Clock::now());
+            opened = true;
+        } else if (state == CircuitState::Closed) {
+            window.push_back(true);
+            ++windowFailures;
+            if (window.size() > config.windowSize) {
+                windowFailures -= window.front() ? 1 : 0;
+                window.pop_front();
+            }
+            if (windowFailures >= config.failureThreshold) {
+                WARNLOG("Circuit {} opened: {} of the last {} requests failed", name, windowFailures, window.size());
+                openLocked(Clock::now());
+                opened = true;
+            }
+        }
+    }
+    if (opened) {
+        CircuitBreakerRegistry::getInstance()->wakeup();
+    }
+}
+
+void CircuitBreaker::onAbandon() {
+    if (!config.enabled) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (state == CircuitState::HalfOpen) {
+        trialInFlight = false;
+    }
+}
+
+void CircuitBreaker::setProbe(Probe newProbe) {
+    std::lock_guard<std::mutex> lock(mutex);
+    probe = std::move(newProbe);
+}
+
+void CircuitBreaker::openLocked(Clock::time_point now) {
+    if (state != CircuitState::Open) {
+        ++stats.opened;
+    }
+    std::chrono::milliseconds duration = std::min<std::chrono::milliseconds>(
+        config.openDuration * (1LL << std::min(consecutiveOpens, 16)), config.maxOpenDuration);
+    ++consecutiveOpens;
+
+    state = CircuitState::Open;
+    openUntil = now + duration;
+    trialInFlight = false;
+    window.clear();
+    windowFailures = 0;
+}
+
+bool CircuitBreaker::timedHalfOpenDueLocked(Clock::time_point now) const {
+    return now >= openUntil && (!probe || failedProbes >= config.maxFailedProbes);
+}
+
+// 进入半开：保留连续断开次数，试探请求失败时断开时长继续加倍
+void CircuitBreaker::halfOpenLocked() {
+    state = CircuitState::HalfOpen;
+    trialInFlight = false;
+}
+
+void CircuitBreaker::closeLocked() {
+    state = CircuitState::Closed;
+    consecutiveOpens = 0;
+    failedProbes = 0;
+    trialInFlight = false;
+    window.clear();
+    windowFailures = 0;
+}
+
+/*
+ * Summary: 到期时执行后台探测
+ * Parameters:
+ *   Clock::time_point now - 当前时间
+ * Return: Clock::time_point - 下一次探测时间
+ * Description: 探测在锁外执行；成功只说明服务商可以连通，熔断器进入半开，由下一个真实请求决定是否关闭，
+ *              连续断开次数也只在真实请求成功后清零；失败则按加倍后的时长继续断开。
+ *              连续失败达到 maxFailedProbes 次后不再探测，改为断开时间结束时由真实请求试探，直到熔断器关闭
+ */
+CircuitBreaker::Clock::time_point CircuitBreaker::probeIfDue(Clock::time_point now) {
+    Probe currentProbe;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (state != CircuitState::Open || !probe || probing || failedProbes >= config.maxFailedProbes) {
+            return Clock::time_point::max();
+        }
+        if (now < openUntil) {
+            return openUntil;
+        }
+        probing = true;
+        currentProbe = probe;
+    }
+
+    bool healthy = false;
+    try {
+        healthy = currentProbe();
+    } catch (const std::exception& e) {
+        WARNLOG("Circuit {} probe threw: {}", name, e.what());
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    probing = false;
+    ++stats.probes;
+    if (state != CircuitState::Open) {
+        return Clock::time_point::max();
+    }
+    if (healthy) {
+        INFOLOG("Circuit {} half-open after a successful probe, allowing a trial request", name);
+        halfOpenLocked();
+        return Clock::time_point::max();
+    }
+    ++stats.probeFailures;
+    ++failedProbes;
+    openLocked(Clock::now());
+    if (failedProbes == config.maxFailedProbes) {
+        WARNLOG("Circuit {} probe failed {} times in a row, falling back to timed half-open", name, failedProbes);
+    }
+    DEBUGLOG("Circuit {} probe failed, next probe in {} ms", name,
+             std::chrono::duration_cast<std::chrono::milliseconds>(openUntil - Clock::now()).count());
+    return openUntil;
+}
+
+CircuitBreakerStats CircuitBreaker::getStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    CircuitBreakerStats result = stats;
+    result.state = state;
+    result.recentFailures = windowFailures;
+    return result;
+}
+
+std::unique_ptr<CircuitBreakerRegistry> CircuitBreakerRegistry::instance = nullptr;
+std::mutex CircuitBreakerRegistry::instanceMutex;
+
+CircuitBreakerRegistry* CircuitBreakerRegistry::getInstance() {
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    if (!instance) {
+        instance = std::unique_ptr<CircuitBreakerRegistry>(new CircuitBreakerRegistry());
+    }
+    return instance.get();
+}
+
+/*
+ * Summary: 读取 circuit_breaker 配置并启动探测线程
+ */
+CircuitBreakerRegistry::CircuitBreakerRegistry() {
+    auto breakerConfig = ConfigManager::getInstance()->getSectionConfig("circuit_breaker");
+    config.enabled = breakerConfig.value("enabled", true);
+    config.windowSize = std::max<size_t>(breakerConfig.value("window_size", static_cast<size_t>(10)), 1);
+    config.failureThreshold = std::max<size_t>(breakerConfig.value("failure_threshold", static_cast<size_t>(5)), 1);
+    config.openDuration = std::chrono::milliseconds(breakerConfig.value("open_ms", 30000));
+    config.maxOpenDuration = std::chrono::milliseconds(breakerConfig.value("max_open_ms", 300000));
+    config.probeTimeout = std::chrono::milliseconds(breakerConfig.value("probe_timeout_ms", 5000));
+    config.maxFailedProbes = breakerConfig.value("max_failed_probes", static_cast<size_t>(3));
+    probeThread = std::thread(&CircuitBreakerRegistry::run, this);
+}
+
+CircuitBreakerRegistry::~CircuitBreakerRegistry() {
+    {
+        std::lock_guard<std::mutex> lock(probeMutex);
+        stopping = true;
+    }
+    probeCondition.notify_all();
+    if (probeThread.joinable()) {
+        probeThread.join();
+    }
+}
+
+CircuitBreaker* CircuitBreakerRegistry::get(const std::string& name) {
+    std::lock_guard<std::mutex> lock(breakersMutex);
+    auto& breaker = breakers[name];
+    if (!breaker) {
+        breaker = std::make_unique<CircuitBreaker>(name, config);
+    }
+    return breaker.get();
+}
+
+void CircuitBreakerRegistry::registerHttpProbe(const std::string& name, const std::string& url,
+                                               const std::vector<std::string>& headers) {
+    long timeoutMs = static_cast<long>(config.probeTimeout.count());
+    get(name)->setProbe([name, url, headers, timeoutMs]() {
+        HttpRequest request;
+        request.url = url;
+        request.method = "GET";
+        request.headers = headers;
+        request.timeoutMs = timeoutMs;
+        HttpResponse response = AsyncHttpClient::getInstance()->send(std::move(request)).get();
+        DEBUGLOG("Circuit {} probe {}: curl {}, status {}", name, url, static_cast<int>(response.curlCode),
+                 response.statusCode);
+        return response.ok() && isHealthyProbeStatus(response.statusCode);
+    });
+}
+
+bool CircuitBreakerRegistry::isHealthyProbeStatus(long statusCode) {
+    if (statusCode <= 0 || statusCode >= 500) {
+        return false;
+    }
+    return statusCode != 401 && statusCode != 403 && statusCode != 404 && statusCode != 405 && statusCode != 429;
+}
+
+void CircuitBreakerRegistry::wakeup() {
+    {
+        std::lock_guard<std::mutex> lock(probeMutex);
+        pendingWakeup = true;
+    }
+    probeCondition.notify_one();
+}
+
+std::map<std::string, CircuitBreakerStats> CircuitBreakerRegistry::getAllStats() {
+    std::lock_guard<std::mutex> lock(breakersMutex);
+    std::map<std::string, CircuitBreakerStats> result;
+    for (const auto& [name, breaker] : breakers) {
+        result[name] = breaker->getStats();
+    }
+    return result;
+}
+
+const char* CircuitBreakerRegistry::stateName(CircuitState state) {
+    switch (state) {
+    case CircuitState::Closed:
+        return "closed";
+    case CircuitState::Open:
+        return "open";
+    case CircuitState::HalfOpen:
+        return "half_open";
+    }
+    return "unknown";
+}
+
+/*
+ * Summary: 探测线程主循环
+ * Description: 只有断开且设置了探测的熔断器才会被探测，全部关闭时线程一直休眠到下一次断开被唤醒；
+ *              探测逐个执行，每个最多耗时 probe_timeout_ms
+ */
+void CircuitBreakerRegistry::run() {
+    std::unique_lock<std::mutex> lock(probeMutex);
+    while (!stopping) {
+        pendingWakeup = false;
+        lock.unlock();
+
+        std::vector<CircuitBreaker*> snapshot;
+        {
+            std::lock_guard<std::mutex> breakersLock(breakersMutex);
+            for (const auto& entry : breakers) {
+                snapshot.push_back(entry.second.get());
+            }
+        }
+        auto next = CircuitBreaker::Clock::time_point::max();
+        for (CircuitBreaker* breaker : snapshot) {
+            next = std::min(next, breaker->probeIfDue(CircuitBreaker::Clock::now()));
+        }
+
+        lock.lock();
+        auto woken = [this]() { return stopping || pendingWakeup; };
+        if (next == CircuitBreaker::Clock::time_point::max()) {
+            probeCondition.wait(lock, woken);
+        } else {
+            probeCondition.wait_until(lock, next, woken);
+        }
+    }
+}
+
+} // namespace IntelliSearch
@@ -0,0 +1,162 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 按服务商划分的熔断器。最近若干次请求中失败（含超时）过多时断开，断开期间请求立即失败；
+ *              后台线程以轻量的 GET 请求探测服务商，探测成功后进入半开；没有探测地址的服务商，
+ *              以及探测连续失败 max_failed_probes 次的服务商，在断开时间结束后直接进入半开。
+ *              半开时放行一个试探请求，成功则恢复，失败则以更长的时间再次断开
+ */
+
+#ifndef INTELLISEARCH_CIRCUITBREAKER_H
+#define INTELLISEARCH_CIRCUITBREAKER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace IntelliSearch {
+
+enum class CircuitState { Closed, Open, HalfOpen };
+
+// 熔断器断开时请求被立即拒绝
+class CircuitOpenError : public std::runtime_error {
+public:
+    explicit CircuitOpenError(const std::string& message) : std::runtime_error(message) {}
+};
+
+// 熔断参数（circuit_breaker 配置节）
+struct CircuitBreakerConfig {
+    bool enabled = true;
+    size_t windowSize = 10;                              // 统计最近的请求数
+    size_t failureThreshold = 5;                         // 窗口内失败次数达到该值时断开
+    std::chrono::milliseconds openDuration{30000};       // 首次断开时长，连续失败后逐次加倍
+    std::chrono::milliseconds maxOpenDuration{300000};
+    std::chrono::milliseconds probeTimeout{5000};
+    size_t maxFailedProbes = 3;                          // 探测连续失败该次数后改为按时间进入半开
+};
+
+// 熔断统计
+struct CircuitBreakerStats {
+    CircuitState state = CircuitState::Closed;
+    uint64_t failures = 0;
+    uint64_t timeouts = 0;
+    uint64_t opened = 0;          // 断开次数
+    uint64_t rejected = 0;        // 断开期间被立即拒绝的请求
+    uint64_t probes = 0;
+    uint64_t probeFailures = 0;
+    size_t recentFailures = 0;    // 当前窗口内的失败数
+};
+
+class CircuitBreaker {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Probe = std::function<bool()>;
+
+    CircuitBreaker(std::string name, CircuitBreakerConfig config);
+
+    // 请求前调用：关闭状态放行；半开状态同时只放行一个试探请求；断开状态拒绝。
+    // 返回 true 时请求结束后必须调用 onSuccess、onFailure 或 onAbandon 之一
+    bool tryAcquire();
+
+    // 是否可能放行请求（不占用试探名额），用于选择服务商
+    bool isCallPermitted();
+
+    void onSuccess();
+    void onFailure(bool timeout);
+
+    // 请求因取消或本地限流未真正发出，不计入统计
+    void onAbandon();
+
+    // 设置后台探测；设置后断开状态在探测成功后进入半开。探测连续失败 maxFailedProbes 次后停止探测，
+    // 恢复按时间进入半开，以免探测地址本身不可用（如 404/405）时熔断器永远断开
+    void setProbe(Probe probe);
+
+    // 由探测线程调用：断开且到达探测时间时执行探测，返回下一次探测时间（无需探测时为 time_point::max）
+    Clock::time_point probeIfDue(Clock::time_point now);
+
+    CircuitBreakerStats getStats();
+    const std::string& getName() const { return name; }
+
+private:
+    // 在持有锁时断开，断开时长随连续断开次数加倍
+    void openLocked(Clock::time_point now);
+    void closeLocked();
+    void halfOpenLocked();
+
+    // 断开状态下是否已可按时间进入半开
+    bool timedHalfOpenDueLocked(Clock::time_point now) const;
+
+    std::string name;
+    CircuitBreakerConfig config;
+
+    std::mutex mutex;
+    CircuitState state = CircuitState::Closed;
+    std::deque<bool> window;          // 最近的请求结果，true 表示失败
+    size_t windowFailures = 0;
+    Clock::time_point openUntil;
+    int consecutiveOpens = 0;
+    bool trialInFlight = false;
+    bool probing = false;
+    size_t failedProbes = 0;          // 本次断开以来连续失败的探测数，关闭时清零
+    Probe probe;
+    CircuitBreakerStats stats;
+};
+
+class CircuitBreakerRegistry {
+public:
+    static CircuitBreakerRegistry* getInstance();
+    ~CircuitBreakerRegistry();
+
+    // 获取熔断器，不存在时按配置创建；名称形如 "ai/Kimi"、"search/Bocha"
+    CircuitBreaker* get(const std::string& name);
+
+    // 为熔断器设置 HTTP 探测：带上指定请求头 GET 探测地址，在超时内收到 isHealthyProbeStatus 认可的响应即视为可以试探
+    void registerHttpProbe(const std::string& name, const std::string& url,
+                           const std::vector<std::string>& headers = {});
+
+    // 熔断器断开后唤醒探测线程
+    void wakeup();
+
+    std::map<std::string, CircuitBreakerStats> getAllStats();
+
+    static const char* stateName(CircuitState state);
+
+    // 探测响应的状态码是否说明服务可用：5xx、429 以及鉴权失败（401/403）、地址不存在或不接受 GET（404/405）都不算，
+    // 否则密钥被拒或探测地址错误时探测也会“成功”，只能说明主机可达
+    static bool isHealthyProbeStatus(long statusCode);
+
+private:
+    CircuitBreakerRegistry();
+    CircuitBreakerRegistry(const CircuitBreakerRegistry&) = delete;
+    CircuitBreakerRegistry& operator=(const CircuitBreakerRegistry&) = delete;
+
+    // 探测线程：在最早的探测时间唤醒，对到期的熔断器逐个探测
+    void run();
+
+    static std::unique_ptr<CircuitBreakerRegistry> instance;
+    static std::mutex instanceMutex;
+
+    CircuitBreakerConfig config;
+    std::mutex breakersMutex;
+    std::map<std::string, std::unique_ptr<CircuitBreaker>> breakers;
+
+    std::mutex probeMutex;
+    std::condition_variable probeCondition;
+    bool stopping = false;
+    bool pendingWakeup = false;
+    std::thread probeThread;
+};
+
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_CIRCUITBREAKER_H
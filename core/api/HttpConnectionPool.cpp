@@ -0,0 +1,112 @@
+#include "HttpConnectionPool.h"
+#include "../log/Logger.h"
+#include "../config/ConfigManager.h"
+#include <stdexcept>
+
+namespace IntelliSearch {
+
+HttpConnectionPool* HttpConnectionPool::instance = nullptr;
+std::mutex HttpConnectionPool::instanceMutex;
+
+HttpConnectionPool* HttpConnectionPool::getInstance() {
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    if (instance == nullptr) {
+        instance = new HttpConnectionPool();
+    }
+    return instance;
+}
+
+/*
+ * Summary: 连接池构造函数
+ * Description: 读取 http_pool 配置并创建共享句柄；共享句柄在进程退出前始终有效，
+ *              因此实例与 SearchServiceManager 一样不做释放
+ */
+HttpConnectionPool::HttpConnectionPool() {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    auto poolConfig = ConfigManager::getInstance()->getSectionConfig("http_pool");
+    maxIdleHandles = poolConfig.value("max_idle_handles", 16);
+    keepAliveIdleSeconds = poolConfig.value("tcp_keepidle_s", 60L);
+
+    share = curl_share_init();
+    if (!share) {
+        ERRORLOG("Failed to initialize CURL share handle");
+        throw std::runtime_error("CURL share initialization failed");
+    }
+    curl_share_setopt(share, CURLSHOPT_LOCKFUNC, &HttpConnectionPool::lockShare);
+    curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, &HttpConnectionPool::unlockShare);
+    curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+
+    INFOLOG("HttpConnectionPool initialized, max idle handles: {}", maxIdleHandles);
+}
+
+void HttpConnectionPool::lockShare(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+    auto* pool = static_cast<HttpConnectionPool*>(userptr);
+    pool->shareLocks[static_cast<size_t>(data)].lock();
+}
+
+void HttpConnectionPool::unlockShare(CURL*, curl_lock_data data, void* userptr) {
+    auto* pool = static_cast<HttpConnectionPool*>(userptr);
+    pool->shareLocks[static_cast<size_t>(data)].unlock();
+}
+
+/*
+ * Summary: 设置句柄的共享缓存与长连接参数
+ * Parameters:
+ *   CURL* curl - 待设置的句柄
+ * Description: curl_easy_reset 会清除这些参数，因此每次租借前都需要重新设置
+ */
+void HttpConnectionPool::applyDefaults(CURL* curl) {
+    curl_easy_setopt(curl, CURLOPT_SHARE, share);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPIDLE, keepAliveIdleSeconds);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPINTVL, 30L);
+}
+
+HttpConnectionPool::Handle HttpConnectionPool::acquire() {
+    CURL* curl = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (!idleHandles.empty()) {
+            curl = idleHandles.back();
+            idleHandles.pop_back();
+        }
+    }
+
+    if (!curl) {
+        curl = curl_easy_init();
+        if (!curl) {
+            ERRORLOG("Failed to initialize CURL");
+            throw std::runtime_error("Failed to initialize CURL");
+        }
+        DEBUGLOG("HttpConnectionPool created new CURL handle");
+    }
+
+    applyDefaults(curl);
+    return Handle(this, curl);
+}
+
+void HttpConnectionPool::release(CURL* curl) {
+    // 重置请求参数，句柄内的活动连接与缓存会被保留
+    curl_easy_reset(curl);
+
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (idleHandles.size() < maxIdleHandles) {
+            idleHandles.push_back(curl);
+            return;
+        }
+    }
+    curl_easy_cleanup(curl);
+}
+
+size_t HttpConnectionPool::idleCount() {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return idleHandles.size();
+}
+
+} // namespace IntelliSearch
@@ -0,0 +1,78 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 进程级共享的 CURL 连接池，复用长连接的 easy 句柄，
+ *              并通过 CURLSH 在所有句柄间共享 DNS 缓存、TLS 会话与连接缓存
+ */
+
+#ifndef INTELLISEARCH_HTTPCONNECTIONPOOL_H
+#define INTELLISEARCH_HTTPCONNECTIONPOOL_H
+
+#include <curl/curl.h>
+#include <array>
+#include <mutex>
+#include <vector>
+
+namespace IntelliSearch {
+
+class HttpConnectionPool {
+public:
+    // 租借的句柄，析构时自动归还连接池
+    class Handle {
+    public:
+        Handle(HttpConnectionPool* pool, CURL* curl) : pool(pool), curl(curl) {}
+        ~Handle() { if (pool && curl) pool->release(curl); }
+
+        Handle(Handle&& other) noexcept : pool(other.pool), curl(other.curl) { other.curl = nullptr; }
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+        Handle& operator=(Handle&&) = delete;
+
+        CURL* get() const { return curl; }
+
+    private:
+        HttpConnectionPool* pool;
+        CURL* curl;
+    };
+
+    static HttpConnectionPool* getInstance();
+
+    // 从池中租借一个已设置默认参数的句柄，池空时新建
+    Handle acquire();
+
+    // 归还句柄：重置请求参数但保留其中的活动连接，超出空闲上限时直接释放
+    void release(CURL* curl);
+
+    // 为外部持有的句柄挂载共享缓存与长连接参数
+    void applyDefaults(CURL* curl);
+
+    // 当前空闲句柄数
+    size_t idleCount();
+
+private:
+    HttpConnectionPool();
+    ~HttpConnectionPool() = default;
+
+    HttpConnectionPool(const HttpConnectionPool&) = delete;
+    HttpConnectionPool& operator=(const HttpConnectionPool&) = delete;
+
+    // CURLSH 的加锁回调，每类共享数据使用独立的互斥锁
+    static void lockShare(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void unlockShare(CURL* handle, curl_lock_data data, void* userptr);
+
+    static HttpConnectionPool* instance;
+    static std::mutex instanceMutex;
+
+    std::vector<CURL*> idleHandles;
+    std::mutex poolMutex;
+    size_t maxIdleHandles;
+    long keepAliveIdleSeconds;
+
+    CURLSH* share;
+    std::array<std::mutex, CURL_LOCK_DATA_LAST> shareLocks;
+};
+
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_HTTPCONNECTIONPOOL_H
@@ -0,0 +1,185 @@
+#include "IntentCache.h"
+#include "../log/Logger.h"
+#include "../utils/TextUtils.h"
+#include <algorithm>
+
+namespace IntelliSearch {
+
+namespace {
+
+/*
+ * Summary: 提取归一化输入中的数字串与拉丁词
+ * Parameters:
+ *   const std::string& normalized - normalizeQuery 的结果（已转小写、全角转半角）
+ * Return: std::vector<std::string> - 排序后的连续 ASCII 字母数字片段
+ * Description: "2023年" 与 "2024年" 只差一个二元组，长输入的相似度仍高于阈值，
+ *              这些片段不同即视为不同的查询
+ */
+std::vector<std::string> extractAnchors(const std::string& normalized) {
+    std::vector<std::string> anchors;
+    std::string current;
+    for (char c : normalized) {
+        if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z')) {
+            current.push_back(c);
+        } else if (!current.empty()) {
+            anchors.push_back(std::move(current));
+            current.clear();
+        }
+    }
+    if (!current.empty()) {
+        anchors.push_back(std::move(current));
+    }
+    std::sort(anchors.begin(), anchors.end());
+    return anchors;
+}
+
+} // namespace
+
+/*
+ * Summary: IntentCache构造函数
+ * Parameters:
+ *   size_t capacity - 最大条目数，超出时淘汰最久未使用的条目
+ *   std::chrono::seconds ttl - 条目有效期
+ *   int maxHammingDistance - 近似匹配允许的最大指纹汉明距离
+ *   double similarityThreshold - 近似候选的字符二元组相似度下限
+ */
+IntentCache::IntentCache(size_t capacity, std::chrono::seconds ttl, int maxHammingDistance,
+                         double similarityThreshold)
+    : capacity(std::max<size_t>(capacity, 1)), ttl(ttl), maxHammingDistance(maxHammingDistance),
+      similarityThreshold(similarityThreshold) {}
+
+uint32_t IntentCache::bandKey(uint64_t fingerprint, int band) {
+    uint64_t mask = (1ULL << kBandBits) - 1;
+    return (static_cast<uint32_t>(band) << kBandBits) |
+           static_cast<uint32_t>((fingerprint >> (band * kBandBits)) & mask);
+}
+
+void IntentCache::touch(std::list<Entry>::iterator entry) {
+    entries.splice(entries.begin(), entries, entry);
+}
+
+void IntentCache::erase(std::list<Entry>::iterator entry) {
+    for (int band = 0; band < kBandCount; ++band) {
+        auto it = bands.find(bandKey(entry->fingerprint, band));
+        if (it == bands.end()) {
+            continue;
+        }
+        auto& ids = it->second;
+        ids.erase(std::remove(ids.begin(), ids.end(), entry->id), ids.end());
+        if (ids.empty()) {
+            bands.erase(it);
+        }
+    }
+    byNormalized.erase(entry->normalized);
+    byId.erase(entry->id);
+    entries.erase(entry);
+}
+
+/*
+ * Summary: 查找意图缓存
+ * Parameters:
+ *   const std::string& userInput - 用户原始输入
+ *   nlohmann::json& result - 命中时写入缓存的意图结果
+ * Return: bool - 是否命中
+ * Description: 精确匹配归一化输入；未命中时取与输入指纹共享任一分段的条目作为候选，
+ *              按汉明距离筛选后要求数字与拉丁词完全相同，再用二元组相似度确认，选择相似度最高的候选
+ */
+bool IntentCache::lookup(const std::string& userInput, nlohmann::json& result) {
+    std::string normalized = TextUtils::normalizeQuery(userInput);
+    std::lock_guard<std::mutex> lock(mutex);
+    ++stats.lookups;
+    auto now = Clock::now();
+
+    auto exact = byNormalized.find(normalized);
+    if (exact != byNormalized.end()) {
+        auto entry = byId[exact->second];
+        if (now - entry->storedAt < ttl) {
+            touch(entry);
+            ++stats.exactHits;
+            stats.savedLatencyMs += entry->latencyMs;
+            result = entry->result;
+            return true;
+        }
+        erase(entry);
+    }
+
+    uint64_t fingerprint = TextUtils::simHash(normalized);
+    auto inputBigrams = TextUtils::charBigrams(normalized);
+    auto inputAnchors = extractAnchors(normalized);
+    std::vector<uint64_t> candidates;
+    for (int band = 0; band < kBandCount; ++band) {
+        auto it = bands.find(bandKey(fingerprint, band));
+        if (it != bands.end()) {
+            candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    std::list<Entry>::iterator best = entries.end();
+    double bestSimilarity = 0.0;
+    for (uint64_t id : candidates) {
+        auto entry = byId[id];
+        if (now - entry->storedAt >= ttl ||
+            TextUtils::hammingDistance(fingerprint, entry->fingerprint) > maxHammingDistance) {
+            continue;
+        }
+        if (entry->anchors != inputAnchors) {
+            ++stats.collisions;
+            continue;
+        }
+        double similarity = TextUtils::jaccardSimilarity(inputBigrams, TextUtils::charBigrams(entry->normalized));
+        if (similarity < similarityThreshold) {
+            ++stats.collisions;
+            continue;
+        }
+        if (similarity > bestSimilarity) {
+            bestSimilarity = similarity;
+            best = entry;
+        }
+    }
+
+    if (best == entries.end()) {
+        ++stats.misses;
+        return false;
+    }
+
+    touch(best);
+    ++stats.nearHits;
+    stats.savedLatencyMs += best->latencyMs;
+    DEBUGLOG("Intent cache near hit: '{}' ~ '{}' (similarity {:.3f})", normalized, best->normalized, bestSimilarity);
+    result = best->result;
+    return true;
+}
+
+void IntentCache::store(const std::string& userInput, const nlohmann::json& result, double latencyMs) {
+    std::string normalized = TextUtils::normalizeQuery(userInput);
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto existing = byNormalized.find(normalized);
+    if (existing != byNormalized.end()) {
+        erase(byId[existing->second]);
+    }
+
+    uint64_t id = nextId++;
+    uint64_t fingerprint = TextUtils::simHash(normalized);
+    entries.push_front(Entry{id, normalized, fingerprint, extractAnchors(normalized), result, latencyMs, Clock::now()});
+    byId.emplace(id, entries.begin());
+    byNormalized.emplace(normalized, id);
+    for (int band = 0; band < kBandCount; ++band) {
+        bands[bandKey(fingerprint, band)].push_back(id);
+    }
+
+    while (entries.size() > capacity) {
+        erase(std::prev(entries.end()));
+    }
+}
+
+IntentCacheStats IntentCache::getStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    IntentCacheStats snapshot = stats;
+    snapshot.size = entries.size();
+    return snapshot;
+}
+
+} // namespace IntelliSearch
@@ -0,0 +1,85 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 意图解析结果缓存。先按归一化输入精确匹配，再通过 SimHash 指纹查找近似输入，
+ *              近似候选需通过字符二元组相似度校验后才复用，避免指纹碰撞返回错误的意图；
+ *              数字与拉丁词还须完全一致，只差年份、型号等的长输入不会共用改写后的查询
+ */
+
+#ifndef INTELLISEARCH_INTENTCACHE_H
+#define INTELLISEARCH_INTENTCACHE_H
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace IntelliSearch {
+
+// 意图缓存统计
+struct IntentCacheStats {
+    uint64_t lookups = 0;
+    uint64_t exactHits = 0;
+    uint64_t nearHits = 0;        // 通过 SimHash 命中的近似输入
+    uint64_t misses = 0;
+    uint64_t collisions = 0;      // 指纹距离足够近但相似度或数字、拉丁词校验未通过的候选数
+    double savedLatencyMs = 0.0;  // 命中节省的 LLM 调用耗时（按原调用耗时累计）
+    size_t size = 0;
+};
+
+class IntentCache {
+public:
+    IntentCache(size_t capacity, std::chrono::seconds ttl, int maxHammingDistance, double similarityThreshold);
+
+    // 查找输入对应的意图结果，命中时写入 result
+    bool lookup(const std::string& userInput, nlohmann::json& result);
+
+    // 写入意图结果及其 LLM 调用耗时
+    void store(const std::string& userInput, const nlohmann::json& result, double latencyMs);
+
+    IntentCacheStats getStats();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        uint64_t id;
+        std::string normalized;
+        uint64_t fingerprint;
+        std::vector<std::string> anchors;   // 排序后的数字与拉丁词，近似匹配要求完全相同
+        nlohmann::json result;
+        double latencyMs;
+        Clock::time_point storedAt;
+    };
+
+    // 指纹分为 8 段，每段 8 位，与输入至少有一段完全相同的条目作为候选。
+    // 短查询的特征少，近似输入的指纹距离通常在 8~12 位，分段过长会漏掉这些候选
+    static constexpr int kBandCount = 8;
+    static constexpr int kBandBits = 64 / kBandCount;
+    static uint32_t bandKey(uint64_t fingerprint, int band);
+
+    void touch(std::list<Entry>::iterator entry);
+    void erase(std::list<Entry>::iterator entry);
+
+    std::mutex mutex;
+    std::list<Entry> entries;                                      // 头部为最近使用
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> byId;
+    std::unordered_map<std::string, uint64_t> byNormalized;
+    std::unordered_map<uint32_t, std::vector<uint64_t>> bands;
+    uint64_t nextId = 0;
+
+    size_t capacity;
+    std::chrono::seconds ttl;
+    int maxHammingDistance;
+    double similarityThreshold;
+    IntentCacheStats stats;
+};
+
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_INTENTCACHE_H
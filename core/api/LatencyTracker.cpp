@@ -0,0 +1,55 @@
+#include "LatencyTracker.h"
+#include <algorithm>
+#include <cmath>
+
+namespace IntelliSearch {
+
+LatencyTracker::LatencyTracker(size_t windowSize) : windowSize(std::max<size_t>(windowSize, 1)) {}
+
+void LatencyTracker::record(const std::string& provider, double latencyMs) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Window& window = windows[provider];
+    if (window.samples.size() < windowSize) {
+        window.samples.push_back(latencyMs);
+    } else {
+        window.samples[window.next] = latencyMs;
+    }
+    window.next = (window.next + 1) % windowSize;
+}
+
+/*
+ * Summary: 计算耗时分位数
+ * Parameters:
+ *   const std::string& provider - 服务商名称
+ *   double percentile - 分位数，取值 0~1
+ *   size_t minSamples - 最少样本数
+ *   double& value - 输出，分位数对应的耗时（毫秒）
+ * Return: bool - 样本是否足够
+ * Description: 窗口较小，复制后用 nth_element 选取，不维护有序结构
+ */
+bool LatencyTracker::percentile(const std::string& provider, double percentile, size_t minSamples, double& value) {
+    std::vector<double> samples;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = windows.find(provider);
+        if (it == windows.end() || it->second.samples.size() < std::max<size_t>(minSamples, 1)) {
+            return false;
+        }
+        samples = it->second.samples;
+    }
+
+    double clamped = std::min(std::max(percentile, 0.0), 1.0);
+    size_t rank = static_cast<size_t>(std::ceil(clamped * samples.size()));
+    size_t index = rank > 0 ? rank - 1 : 0;
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    value = samples[index];
+    return true;
+}
+
+size_t LatencyTracker::sampleCount(const std::string& provider) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = windows.find(provider);
+    return it != windows.end() ? it->second.samples.size() : 0;
+}
+
+} // namespace IntelliSearch
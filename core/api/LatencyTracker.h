@@ -0,0 +1,45 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 按服务商记录最近的 LLM 调用耗时，用滑动窗口估算分位数，
+ *              作为对冲请求的触发阈值
+ */
+
+#ifndef INTELLISEARCH_LATENCYTRACKER_H
+#define INTELLISEARCH_LATENCYTRACKER_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace IntelliSearch {
+
+class LatencyTracker {
+public:
+    explicit LatencyTracker(size_t windowSize = 200);
+
+    // 记录一次调用耗时，窗口写满后覆盖最旧的样本
+    void record(const std::string& provider, double latencyMs);
+
+    // 计算耗时分位数（percentile 取值 0~1），样本数少于 minSamples 时返回 false
+    bool percentile(const std::string& provider, double percentile, size_t minSamples, double& value);
+
+    // 当前窗口内的样本数
+    size_t sampleCount(const std::string& provider);
+
+private:
+    struct Window {
+        std::vector<double> samples;
+        size_t next = 0;
+    };
+
+    size_t windowSize;
+    std::mutex mutex;
+    std::map<std::string, Window> windows;
+};
+
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_LATENCYTRACKER_H
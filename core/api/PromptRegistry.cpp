@@ -0,0 +1,183 @@
+#include "PromptRegistry.h"
+#include "../log/Logger.h"
+#include "../config/ConfigManager.h"
+#include <fstream>
+#include <stdexcept>
+
+namespace IntelliSearch {
+
+PromptRegistry* PromptRegistry::instance = nullptr;
+std::mutex PromptRegistry::instanceMutex;
+
+PromptRegistry* PromptRegistry::getInstance() {
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    if (instance == nullptr) {
+        instance = new PromptRegistry();
+    }
+    return instance;
+}
+
+/*
+ * Summary: 注册表构造函数
+ * Description: 读取 prompt_registry 配置；与连接池一样在进程生命周期内不做释放
+ */
+PromptRegistry::PromptRegistry() {
+    auto registryConfig = ConfigManager::getInstance()->getSectionConfig("prompt_registry");
+    reloadCheckInterval = std::chrono::milliseconds(registryConfig.value("reload_check_interval_ms", 1000));
+}
+
+/*
+ * Summary: 预加载所有服务商的提示文件
+ * Parameters: 无
+ * Return: void
+ * Description: 遍历 api_providers 下各服务商的 prompts 配置，同一路径只加载一次。
+ *              启动时即可发现缺失或格式错误的提示文件，而不是等到第一次请求
+ */
+void PromptRegistry::preloadAll() {
+    auto providers = ConfigManager::getInstance()->getSectionConfig("api_providers");
+    size_t loaded = 0;
+    for (const auto& [provider, providerConfig] : providers.items()) {
+        if (!providerConfig.contains("prompts")) {
+            continue;
+        }
+        std::vector<std::string> paths;
+        const auto& prompts = providerConfig["prompts"];
+        if (prompts.is_string()) {
+            paths.push_back(prompts.get<std::string>());
+        } else if (prompts.is_object()) {
+            for (const auto& [promptType, path] : prompts.items()) {
+                if (path.is_string()) {
+                    paths.push_back(path.get<std::string>());
+                }
+            }
+        }
+        for (const auto& path : paths) {
+            try {
+                get(path);
+                ++loaded;
+            } catch (const std::exception& e) {
+                WARNLOG("Failed to preload prompts for {}: {}", provider, e.what());
+            }
+        }
+    }
+    std::lock_guard<std::mutex> lock(entriesMutex);
+    INFOLOG("PromptRegistry preloaded {} prompt files ({} distinct)", loaded, entries.size());
+}
+
+/*
+ * Summary: 获取提示模板
+ * Parameters:
+ *   const std::string& promptsFilePath - 配置中的提示文件路径
+ * Return: std::shared_ptr<const PromptTemplate> - 预渲染的模板，调用方可在锁外长期持有
+ * Description: 每个路径只解析一次文件位置；距上次检查超过 reloadCheckInterval 时比较文件修改时间，
+ *              变化后重新加载。重新加载失败时保留旧模板继续使用
+ */
+std::shared_ptr<const PromptTemplate> PromptRegistry::get(const std::string& promptsFilePath) {
+    std::lock_guard<std::mutex> lock(entriesMutex);
+    auto now = Clock::now();
+
+    auto it = entries.find(promptsFilePath);
+    if (it == entries.end()) {
+        Entry entry;
+        entry.resolvedPath = resolvePath(promptsFilePath);
+        entry.modifiedTime = std::filesystem::last_write_time(entry.resolvedPath);
+        entry.prompt = loadTemplate(entry.resolvedPath);
+        entry.lastChecked = now;
+        INFOLOG("Loaded prompts file: {}", entry.resolvedPath.string());
+        return entries.emplace(promptsFilePath, std::move(entry)).first->second.prompt;
+    }
+
+    Entry& entry = it->second;
+    if (now - entry.lastChecked < reloadCheckInterval) {
+        return entry.prompt;
+    }
+    entry.lastChecked = now;
+
+    std::error_code ec;
+    auto modifiedTime = std::filesystem::last_write_time(entry.resolvedPath, ec);
+    if (ec || modifiedTime == entry.modifiedTime) {
+        return entry.prompt;
+    }
+    try {
+        entry.prompt = loadTemplate(entry.resolvedPath);
+        entry.modifiedTime = modifiedTime;
+        INFOLOG("Reloaded modified prompts file: {}", entry.resolvedPath.string());
+    } catch (const std::exception& e) {
+        WARNLOG("Failed to reload prompts file {}, keeping previous version: {}",
+                entry.resolvedPath.string(), e.what());
+    }
+    return entry.prompt;
+}
+
+/*
+ * Summary: 查找提示文件
+ * Parameters:
+ *   const std::string& promptsFilePath - 配置中的提示文件路径
+ * Return: std::filesystem::path - 第一个存在的候选路径
+ * Description: 依次尝试原始路径、配置目录，以及当前目录向上五层的 <dir>/<path> 与 <dir>/config/<文件名>。
+ *              所有候选都不存在时抛出异常并列出尝试过的路径
+ */
+std::filesystem::path PromptRegistry::resolvePath(const std::string& promptsFilePath) const {
+    std::filesystem::path currentPath = std::filesystem::current_path();
+    std::filesystem::path configDir =
+        std::filesystem::path(ConfigManager::getInstance()->getConfigPath()).parent_path();
+    std::string filename = std::filesystem::path(promptsFilePath).filename().string();
+
+    std::vector<std::filesystem::path> searchPaths = {
+        promptsFilePath,
+        configDir / promptsFilePath,
+        configDir / filename
+    };
+    std::filesystem::path tempPath = currentPath;
+    for (int i = 0; i < 5 && tempPath.has_parent_path(); ++i) {
+        searchPaths.push_back(tempPath / promptsFilePath);
+        searchPaths.push_back(tempPath / "config" / filename);
+        tempPath = tempPath.parent_path();
+    }
+
+    std::string triedPaths;
+    for (const auto& path : searchPaths) {
+        if (std::filesystem::is_regular_file(path)) {
+            return path;
+        }
+        triedPaths += "\n              " + path.string();
+    }
+    ERRORLOG("无法找到提示文件: {}, 尝试的路径: {}", promptsFilePath, triedPaths);
+    throw std::runtime_error("Failed to open prompts file: " + promptsFilePath + "\n尝试的路径: " + triedPaths);
+}
+
+/*
+ * Summary: 读取并渲染提示文件
+ * Parameters:
+ *   const std::filesystem::path& path - 提示文件路径
+ * Return: std::shared_ptr<const PromptTemplate> - 渲染后的模板
+ * Description: 要求包含 system、examples.input 与 examples.output 字段。
+ *              字符串形式的示例输入原样拼接，其余类型序列化为 JSON
+ */
+std::shared_ptr<const PromptTemplate> PromptRegistry::loadTemplate(const std::filesystem::path& path) const {
+    std::ifstream promptsFile(path);
+    if (!promptsFile.is_open()) {
+        throw std::runtime_error("Failed to open prompts file: " + path.string());
+    }
+    auto promptsJson = nlohmann::json::parse(promptsFile);
+
+    if (!promptsJson.contains("system") ||
+        !promptsJson.contains("examples") || !promptsJson["examples"].is_object() ||
+        !promptsJson["examples"].contains("input") || !promptsJson["examples"].contains("output")) {
+        throw std::runtime_error("Prompts file missing system/examples fields: " + path.string());
+    }
+
+    const auto& examples = promptsJson["examples"];
+    std::string exampleInput = examples["input"].is_string()
+        ? examples["input"].get<std::string>()
+        : examples["input"].dump();
+
+    auto prompt = std::make_shared<PromptTemplate>();
+    prompt->systemContent = promptsJson["system"].dump();
+    prompt->userPrefix = "示例输入：" + exampleInput +
+                         "\n示例输出：" + examples["output"].dump() +
+                         "\n\n实际输入：";
+    return prompt;
+}
+
+} // namespace IntelliSearch
@@ -0,0 +1,71 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 提示模板注册表。启动时加载并校验所有服务商的提示文件，预先渲染 system 与示例片段，
+ *              请求时直接复用；文件修改时间变化后才重新加载
+ */
+
+#ifndef INTELLISEARCH_PROMPTREGISTRY_H
+#define INTELLISEARCH_PROMPTREGISTRY_H
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace IntelliSearch {
+
+// 预渲染的提示模板
+struct PromptTemplate {
+    std::string systemContent;   // system 消息内容（system 字段序列化后的字符串）
+    std::string userPrefix;      // "示例输入：...\n示例输出：...\n\n实际输入："，其后直接拼接用户查询
+};
+
+class PromptRegistry {
+public:
+    static PromptRegistry* getInstance();
+
+    // 预加载配置中所有服务商的提示文件，单个文件失败只记录警告
+    void preloadAll();
+
+    // 获取提示模板，首次访问时加载；文件不存在或格式错误时抛出异常
+    std::shared_ptr<const PromptTemplate> get(const std::string& promptsFilePath);
+
+private:
+    PromptRegistry();
+    ~PromptRegistry() = default;
+
+    PromptRegistry(const PromptRegistry&) = delete;
+    PromptRegistry& operator=(const PromptRegistry&) = delete;
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::filesystem::path resolvedPath;
+        std::filesystem::file_time_type modifiedTime;
+        Clock::time_point lastChecked;
+        std::shared_ptr<const PromptTemplate> prompt;
+    };
+
+    // 在当前目录、配置目录及其上级目录中查找提示文件
+    std::filesystem::path resolvePath(const std::string& promptsFilePath) const;
+
+    // 读取、校验并渲染提示文件
+    std::shared_ptr<const PromptTemplate> loadTemplate(const std::filesystem::path& path) const;
+
+    static PromptRegistry* instance;
+    static std::mutex instanceMutex;
+
+    std::unordered_map<std::string, Entry> entries;
+    std::mutex entriesMutex;
+    std::chrono::milliseconds reloadCheckInterval;
+};
+
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_PROMPTREGISTRY_H
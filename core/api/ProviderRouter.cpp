@@ -0,0 +1,128 @@
+#include "ProviderRouter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace IntelliSearch {
+
+ProviderRouter::ProviderRouter(RoutingConfig config) : config(config), rng(std::random_device{}()) {}
+
+void ProviderRouter::decayLocked(Health& health, std::chrono::steady_clock::time_point now) {
+    if (health.errorRate <= 0.0 || config.decay.count() <= 0) {
+        health.errorUpdatedAt = now;
+        return;
+    }
+    double elapsed = std::chrono::duration<double, std::milli>(now - health.errorUpdatedAt).count();
+    health.errorRate *= std::exp2(-elapsed / static_cast<double>(config.decay.count()));
+    health.errorUpdatedAt = now;
+}
+
+double ProviderRouter::costLocked(Health& health, std::chrono::steady_clock::time_point now) {
+    decayLocked(health, now);
+    double latency = health.hasLatency ? health.latencyMs : config.initialLatencyMs;
+    return latency * (health.inFlight + 1) * (1.0 + config.errorPenalty * health.errorRate);
+}
+
+/*
+ * Summary: 选择服务商
+ * Parameters:
+ *   const std::vector<std::string>& candidates - 可用的服务商
+ * Return: std::string - 选中的服务商
+ * Description: 两次随机选择（power of two choices）：随机取两个不同的候选，返回代价较低者。
+ *              最差的服务商永远不会被选中，其余服务商按代价分摊负载，避免所有请求追逐同一个“最快”的服务商
+ */
+std::string ProviderRouter::pick(const std::vector<std::string>& candidates) {
+    if (candidates.empty()) {
+        return {};
+    }
+    if (candidates.size() == 1) {
+        return candidates.front();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::uniform_int_distribution<size_t> first(0, candidates.size() - 1);
+    std::uniform_int_distribution<size_t> second(0, candidates.size() - 2);
+    size_t a = first(rng);
+    size_t b = second(rng);
+    if (b >= a) {
+        ++b;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    double costA = costLocked(providers[candidates[a]], now);
+    double costB = costLocked(providers[candidates[b]], now);
+    return costA <= costB ? candidates[a] : candidates[b];
+}
+
+std::vector<std::string> ProviderRouter::rank(const std::vector<std::string>& candidates) {
+    std::vector<std::pair<double, std::string>> costs;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto now = std::chrono::steady_clock::now();
+        for (const auto& name : candidates) {
+            costs.emplace_back(costLocked(providers[name], now), name);
+        }
+    }
+    std::stable_sort(costs.begin(), costs.end(),
+                     [](const auto& left, const auto& right) { return left.first < right.first; });
+
+    std::vector<std::string> ranked;
+    ranked.reserve(costs.size());
+    for (auto& entry : costs) {
+        ranked.push_back(std::move(entry.second));
+    }
+    return ranked;
+}
+
+void ProviderRouter::onStart(const std::string& provider) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++providers[provider].inFlight;
+}
+
+void ProviderRouter::onFinish(const std::string& provider, double latencyMs, bool success) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Health& health = providers[provider];
+    health.inFlight = std::max(0, health.inFlight - 1);
+    ++health.requests;
+
+    // 失败请求的耗时同样计入：超时的服务商耗时估计随之升高
+    if (health.hasLatency) {
+        health.latencyMs += config.latencyAlpha * (latencyMs - health.latencyMs);
+    } else {
+        health.latencyMs = latencyMs;
+        health.hasLatency = true;
+    }
+
+    decayLocked(health, std::chrono::steady_clock::now());
+    health.errorRate += config.errorAlpha * ((success ? 0.0 : 1.0) - health.errorRate);
+    if (!success) {
+        ++health.failures;
+    }
+}
+
+void ProviderRouter::onCancel(const std::string& provider, double latencyMs) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Health& health = providers[provider];
+    health.inFlight = std::max(0, health.inFlight - 1);
+    // 被取消时已耗时是真实耗时的下界，只在其高于当前估计时上调
+    if (health.hasLatency && latencyMs > health.latencyMs) {
+        health.latencyMs += config.latencyAlpha * (latencyMs - health.latencyMs);
+    }
+}
+
+std::map<std::string, ProviderHealthStats> ProviderRouter::getStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto now = std::chrono::steady_clock::now();
+    std::map<std::string, ProviderHealthStats> result;
+    for (auto& [name, health] : providers) {
+        ProviderHealthStats& stats = result[name];
+        stats.cost = costLocked(health, now);
+        stats.requests = health.requests;
+        stats.failures = health.failures;
+        stats.latencyMs = health.hasLatency ? health.latencyMs : config.initialLatencyMs;
+        stats.errorRate = health.errorRate;
+        stats.inFlight = health.inFlight;
+    }
+    return result;
+}
+
+} // namespace IntelliSearch
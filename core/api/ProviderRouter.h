@@ -0,0 +1,91 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 按实时健康度在多个 LLM 服务商之间分配请求。每个服务商维护耗时与错误率的
+ *              指数加权移动平均（EWMA）及进行中的请求数，用“两次随机选择”挑选代价较低者，
+ *              使负载分散到健康的服务商上，而不是全部压在同一个上
+ */
+
+#ifndef INTELLISEARCH_PROVIDERROUTER_H
+#define INTELLISEARCH_PROVIDERROUTER_H
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace IntelliSearch {
+
+// 路由参数（routing 配置节）
+struct RoutingConfig {
+    bool enabled = true;                  // 关闭时固定使用 ai_service 指定的服务商
+    double initialLatencyMs = 2000.0;     // 尚无样本的服务商的初始耗时估计
+    double latencyAlpha = 0.3;            // 耗时 EWMA 的新样本权重
+    double errorAlpha = 0.2;              // 错误率 EWMA 的新样本权重
+    double errorPenalty = 4.0;            // 错误率对代价的放大系数
+    std::chrono::milliseconds decay{30000};  // 无新样本时错误率衰减一半所需的时间
+};
+
+// 单个服务商的路由统计
+struct ProviderHealthStats {
+    uint64_t requests = 0;
+    uint64_t failures = 0;
+    double latencyMs = 0.0;     // 耗时 EWMA
+    double errorRate = 0.0;     // 错误率 EWMA（已按时间衰减）
+    int inFlight = 0;
+    double cost = 0.0;
+};
+
+class ProviderRouter {
+public:
+    explicit ProviderRouter(RoutingConfig config = RoutingConfig());
+
+    // 从候选服务商中选择一个：随机取两个比较代价，只有一个候选时直接返回；候选为空时返回空字符串
+    std::string pick(const std::vector<std::string>& candidates);
+
+    // 按代价从低到高排序候选服务商
+    std::vector<std::string> rank(const std::vector<std::string>& candidates);
+
+    // 请求开始，计入进行中的请求数
+    void onStart(const std::string& provider);
+
+    // 请求结束，更新耗时与错误率
+    void onFinish(const std::string& provider, double latencyMs, bool success);
+
+    // 请求被调用方取消，只归还进行中的计数，不影响错误率
+    void onCancel(const std::string& provider, double latencyMs);
+
+    std::map<std::string, ProviderHealthStats> getStats();
+
+    const RoutingConfig& getConfig() const { return config; }
+
+private:
+    struct Health {
+        uint64_t requests = 0;
+        uint64_t failures = 0;
+        double latencyMs = 0.0;
+        bool hasLatency = false;
+        double errorRate = 0.0;
+        std::chrono::steady_clock::time_point errorUpdatedAt;
+        int inFlight = 0;
+    };
+
+    // 按经过的时间衰减错误率
+    void decayLocked(Health& health, std::chrono::steady_clock::time_point now);
+
+    // 预期代价：耗时 EWMA ×（进行中请求数 + 1）×（1 + 错误惩罚 × 错误率）
+    double costLocked(Health& health, std::chrono::steady_clock::time_point now);
+
+    RoutingConfig config;
+    std::mutex mutex;
+    std::map<std::string, Health> providers;
+    std::mt19937 rng;
+};
+
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_PROVIDERROUTER_H
@@ -0,0 +1,319 @@
+#include "RateLimiter.h"
+#include "../log/Logger.h"
+#include "../config/ConfigManager.h"
+#include <algorithm>
+#include <cctype>
+
+namespace IntelliSearch {
+
+namespace {
+
+std::string lowercase(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+double elapsedMs(RateLimiter::Clock::time_point from, RateLimiter::Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // namespace
+
+RateLimiter::RateLimiter(std::string name, RateLimits limits, RateLimiterRegistry* registry)
+    : name(std::move(name)), limits(limits), registry(registry) {
+    minuteCapacity = limits.burst > 0 ? limits.burst : limits.requestsPerMinute;
+    minuteTokens = minuteCapacity;
+    dayTokens = limits.requestsPerDay;
+    lastRefill = Clock::now();
+}
+
+/*
+ * Summary: 提交请求
+ * Parameters:
+ *   Grant onGrant - 获得许可时的回调
+ *   Reject onReject - 被拒绝时的回调
+ * Return: uint64_t - 排队编号，队列已满时为 0
+ * Description: 队列为空且令牌与并发许可充足时在当前线程立即授予；否则入队等待，
+ *              队列已满时立即拒绝。任何情况下都不会阻塞调用线程
+ */
+uint64_t RateLimiter::submit(Grant onGrant, Reject onReject) {
+    std::vector<Grant> granted;
+    std::vector<Reject> timedOut;
+    Clock::time_point next;
+    uint64_t ticket = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.size() >= limits.maxQueueLength) {
+            ++stats.rejected;
+            WARNLOG("Rate limiter {} queue full ({} waiting), rejecting request", name, queue.size());
+            // 回调在锁外执行
+            timedOut.push_back(std::move(onReject));
+            next = Clock::time_point::max();
+        } else {
+            auto now = Clock::now();
+            ticket = nextTicket++;
+            queue.push_back({ticket, std::move(onGrant), std::move(onReject), now});
+            next = dispatchLocked(now, granted, timedOut);
+            if (!queue.empty() && granted.empty()) {
+                DEBUGLOG("Rate limiter {} queued request ({} waiting)", name, queue.size());
+            }
+        }
+    }
+    finish(next, granted, timedOut);
+    return ticket;
+}
+
+/*
+ * Summary: 撤回排队中的请求
+ * Parameters:
+ *   uint64_t ticket - submit 返回的排队编号
+ * Return: bool - 是否从队列中移除；返回 false 时请求已获得许可或已被拒绝
+ * Description: 被取消的搜索立即让出排队位置，不再占用后续的令牌与并发许可
+ */
+bool RateLimiter::cancel(uint64_t ticket) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = queue.begin(); it != queue.end(); ++it) {
+        if (it->ticket == ticket) {
+            queue.erase(it);
+            ++stats.cancelled;
+            DEBUGLOG("Rate limiter {} withdrew cancelled request ({} waiting)", name, queue.size());
+            return true;
+        }
+    }
+    return false;
+}
+
+void RateLimiter::release() {
+    std::vector<Grant> granted;
+    std::vector<Reject> timedOut;
+    Clock::time_point next;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        inFlight = std::max(0, inFlight - 1);
+        next = dispatchLocked(Clock::now(), granted, timedOut);
+    }
+    finish(next, granted, timedOut);
+}
+
+RateLimiter::Clock::time_point RateLimiter::dispatch() {
+    std::vector<Grant> granted;
+    std::vector<Reject> timedOut;
+    Clock::time_point next;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        next = dispatchLocked(Clock::now(), granted, timedOut);
+    }
+    finish(next, granted, timedOut);
+    return next;
+}
+
+void RateLimiter::refill(Clock::time_point now) {
+    double seconds = std::chrono::duration<double>(now - lastRefill).count();
+    lastRefill = now;
+    if (limits.requestsPerMinute > 0) {
+        minuteTokens = std::min(minuteCapacity, minuteTokens + seconds * limits.requestsPerMinute / 60.0);
+    }
+    if (limits.requestsPerDay > 0) {
+        dayTokens = std::min(limits.requestsPerDay, dayTokens + seconds * limits.requestsPerDay / 86400.0);
+    }
+}
+
+/*
+ * Summary: 按 FIFO 顺序派发请求
+ * Parameters:
+ *   Clock::time_point now - 当前时间
+ *   std::vector<Grant>& granted - 输出，获得许可的回调
+ *   std::vector<Reject>& timedOut - 输出，排队超时的回调
+ * Return: Clock::time_point - 下一次需要检查的时间：令牌补足或队首超时的较早者；
+ *                             仅受并发限制时由 release 触发，返回队首超时时间
+ */
+RateLimiter::Clock::time_point RateLimiter::dispatchLocked(Clock::time_point now, std::vector<Grant>& granted,
+                                                           std::vector<Reject>& timedOut) {
+    refill(now);
+    while (!queue.empty()) {
+        Waiter& front = queue.front();
+        if (now - front.enqueuedAt >= limits.maxQueueTime) {
+            ++stats.timedOut;
+            timedOut.push_back(std::move(front.onReject));
+            queue.pop_front();
+            continue;
+        }
+
+        Clock::time_point deadline = front.enqueuedAt + limits.maxQueueTime;
+        if (limits.maxConcurrent > 0 && inFlight >= limits.maxConcurrent) {
+            return deadline;
+        }
+
+        // 两个桶都需要至少一个令牌，计算缺口补足所需的时间
+        double waitSeconds = 0.0;
+        if (limits.requestsPerMinute > 0 && minuteTokens < 1.0) {
+            waitSeconds = std::max(waitSeconds, (1.0 - minuteTokens) * 60.0 / limits.requestsPerMinute);
+        }
+        if (limits.requestsPerDay > 0 && dayTokens < 1.0) {
+            waitSeconds = std::max(waitSeconds, (1.0 - dayTokens) * 86400.0 / limits.requestsPerDay);
+        }
+        if (waitSeconds > 0.0) {
+            auto refillAt = now + std::chrono::duration_cast<Clock::duration>(
+                                      std::chrono::duration<double>(waitSeconds));
+            return std::min(refillAt, deadline);
+        }
+
+        if (limits.requestsPerMinute > 0) {
+            minuteTokens -= 1.0;
+        }
+        if (limits.requestsPerDay > 0) {
+            dayTokens -= 1.0;
+        }
+        ++inFlight;
+        ++stats.granted;
+        double queueMs = elapsedMs(front.enqueuedAt, now);
+        if (queueMs > 0.0) {
+            ++stats.delayed;
+        }
+        stats.totalQueueMs += queueMs;
+        stats.maxQueueMs = std::max(stats.maxQueueMs, queueMs);
+        granted.push_back(std::move(front.onGrant));
+        queue.pop_front();
+    }
+    return Clock::time_point::max();
+}
+
+void RateLimiter::finish(Clock::time_point next, std::vector<Grant>& granted, std::vector<Reject>& timedOut) {
+    for (auto& onReject : timedOut) {
+        if (onReject) {
+            onReject("Rate limit exceeded for " + name);
+        }
+    }
+    for (auto& onGrant : granted) {
+        onGrant();
+    }
+    if (next != Clock::time_point::max()) {
+        registry->schedule(this, next);
+    }
+}
+
+RateLimiterStats RateLimiter::getStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    RateLimiterStats result = stats;
+    result.queued = queue.size();
+    result.inFlight = static_cast<size_t>(inFlight);
+    return result;
+}
+
+std::unique_ptr<RateLimiterRegistry> RateLimiterRegistry::instance = nullptr;
+std::mutex RateLimiterRegistry::instanceMutex;
+
+RateLimiterRegistry* RateLimiterRegistry::getInstance() {
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    if (!instance) {
+        instance = std::unique_ptr<RateLimiterRegistry>(new RateLimiterRegistry());
+    }
+    return instance.get();
+}
+
+/*
+ * Summary: 根据 api_providers.<服务商>.rate_limits 创建限流器并启动调度线程
+ * Description: 每分钟上限取 requests_per_minute，缺少该键时才使用旧配置的 max_requests_per_minute；
+ *              max_queue_length 与 max_queue_ms 控制排队上限
+ */
+RateLimiterRegistry::RateLimiterRegistry() {
+    auto providers = ConfigManager::getInstance()->getSectionConfig("api_providers");
+    for (const auto& [provider, providerConfig] : providers.items()) {
+        if (!providerConfig.is_object() || !providerConfig.contains("rate_limits")) {
+            continue;
+        }
+        const auto& rateConfig = providerConfig["rate_limits"];
+        RateLimits limits;
+        limits.requestsPerMinute = rateConfig.contains("requests_per_minute")
+            ? rateConfig.value("requests_per_minute", 0.0)
+            : rateConfig.value("max_requests_per_minute", 0.0);
+        limits.requestsPerDay = rateConfig.value("requests_per_day", 0.0);
+        limits.burst = rateConfig.value("burst", 0.0);
+        limits.maxConcurrent = rateConfig.value("max_concurrent_requests", 0);
+        limits.maxQueueLength = rateConfig.value("max_queue_length", static_cast<size_t>(64));
+        limits.maxQueueTime = std::chrono::milliseconds(rateConfig.value("max_queue_ms", 30000));
+
+        std::string key = lowercase(provider);
+        limiters[key] = std::make_unique<RateLimiter>(key, limits, this);
+        INFOLOG("Rate limiter for {}: {} req/min, {} req/day, {} concurrent",
+                key, limits.requestsPerMinute, limits.requestsPerDay, limits.maxConcurrent);
+    }
+    timerThread = std::thread(&RateLimiterRegistry::run, this);
+}
+
+RateLimiterRegistry::~RateLimiterRegistry() {
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        stopping = true;
+    }
+    timerCondition.notify_all();
+    if (timerThread.joinable()) {
+        timerThread.join();
+    }
+}
+
+RateLimiter* RateLimiterRegistry::get(const std::string& provider) {
+    auto it = limiters.find(lowercase(provider));
+    return it != limiters.end() ? it->second.get() : nullptr;
+}
+
+std::map<std::string, RateLimiterStats> RateLimiterRegistry::getAllStats() {
+    std::map<std::string, RateLimiterStats> result;
+    for (const auto& [key, limiter] : limiters) {
+        result[key] = limiter->getStats();
+    }
+    return result;
+}
+
+void RateLimiterRegistry::schedule(RateLimiter* limiter, RateLimiter::Clock::time_point when) {
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        auto existing = scheduled.find(limiter);
+        if (existing != scheduled.end()) {
+            if (existing->second <= when) {
+                return;
+            }
+            auto range = timers.equal_range(existing->second);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second == limiter) {
+                    timers.erase(it);
+                    break;
+                }
+            }
+        }
+        scheduled[limiter] = when;
+        timers.emplace(when, limiter);
+    }
+    timerCondition.notify_one();
+}
+
+/*
+ * Summary: 调度线程主循环
+ * Description: 所有限流器共用这一个线程，每个限流器最多登记一个唤醒时间；
+ *              dispatch 返回新的检查时间时会重新登记
+ */
+void RateLimiterRegistry::run() {
+    std::unique_lock<std::mutex> lock(timerMutex);
+    while (!stopping) {
+        if (timers.empty()) {
+            timerCondition.wait(lock);
+            continue;
+        }
+        auto earliest = timers.begin()->first;
+        if (RateLimiter::Clock::now() < earliest) {
+            timerCondition.wait_until(lock, earliest);
+            continue;
+        }
+        RateLimiter* limiter = timers.begin()->second;
+        timers.erase(timers.begin());
+        scheduled.erase(limiter);
+
+        // dispatch 可能再次调用 schedule，需在锁外执行
+        lock.unlock();
+        limiter->dispatch();
+        lock.lock();
+    }
+}
+
+} // namespace IntelliSearch
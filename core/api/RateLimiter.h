@@ -0,0 +1,153 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 按服务商划分的令牌桶限流器，同时限制并发请求数。超出速率的请求进入队列，
+ *              由共享的调度线程在令牌补充后派发，调用线程不会因限流而休眠
+ */
+
+#ifndef INTELLISEARCH_RATELIMITER_H
+#define INTELLISEARCH_RATELIMITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace IntelliSearch {
+
+// 请求因队列已满或排队超时被限流器拒绝
+class RateLimitExceeded : public std::runtime_error {
+public:
+    explicit RateLimitExceeded(const std::string& message) : std::runtime_error(message) {}
+};
+
+// 单个服务商的限流参数，取值 <= 0 表示不限制
+struct RateLimits {
+    double requestsPerMinute = 0;
+    double requestsPerDay = 0;
+    double burst = 0;                       // 分钟桶容量，<= 0 时等于 requestsPerMinute
+    int maxConcurrent = 0;
+    size_t maxQueueLength = 64;
+    std::chrono::milliseconds maxQueueTime{30000};
+};
+
+// 限流统计
+struct RateLimiterStats {
+    uint64_t granted = 0;
+    uint64_t rejected = 0;        // 队列已满时直接拒绝
+    uint64_t timedOut = 0;        // 排队超过 maxQueueTime
+    uint64_t delayed = 0;         // 需要排队才获得许可的请求数
+    uint64_t cancelled = 0;       // 排队期间被调用方撤回
+    size_t queued = 0;            // 当前排队数
+    size_t inFlight = 0;          // 当前持有许可的请求数
+    double totalQueueMs = 0.0;
+    double maxQueueMs = 0.0;
+};
+
+class RateLimiterRegistry;
+
+class RateLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Grant = std::function<void()>;
+    using Reject = std::function<void(const std::string& reason)>;
+
+    RateLimiter(std::string name, RateLimits limits, RateLimiterRegistry* registry);
+
+    // 提交请求。获得许可时调用 onGrant（在调用线程或调度线程中执行，不可阻塞），
+    // 请求结束后必须调用 release()；被拒绝时调用 onReject。
+    // 返回排队编号，可用于 cancel；队列已满被立即拒绝时返回 0
+    uint64_t submit(Grant onGrant, Reject onReject);
+
+    // 撤回仍在排队的请求，两个回调都不会再被调用；已获得许可或不在队列中时返回 false
+    bool cancel(uint64_t ticket);
+
+    // 归还并发许可，并尝试派发排队的请求
+    void release();
+
+    // 派发已满足条件的请求并处理超时，返回下一次需要检查的时间
+    Clock::time_point dispatch();
+
+    RateLimiterStats getStats();
+    const std::string& getName() const { return name; }
+
+private:
+    struct Waiter {
+        uint64_t ticket;
+        Grant onGrant;
+        Reject onReject;
+        Clock::time_point enqueuedAt;
+    };
+
+    // 按经过的时间补充令牌
+    void refill(Clock::time_point now);
+
+    // 在持有锁时整理队列，可执行与需拒绝的回调移出到参数中，在锁外执行
+    Clock::time_point dispatchLocked(Clock::time_point now, std::vector<Grant>& granted,
+                                     std::vector<Reject>& timedOut);
+
+    // 在锁外执行回调并向调度线程登记下一次检查时间
+    void finish(Clock::time_point next, std::vector<Grant>& granted, std::vector<Reject>& timedOut);
+
+    std::string name;
+    RateLimits limits;
+    RateLimiterRegistry* registry;
+
+    std::mutex mutex;
+    std::deque<Waiter> queue;
+    double minuteTokens;
+    double dayTokens;
+    double minuteCapacity;
+    Clock::time_point lastRefill;
+    int inFlight = 0;
+    uint64_t nextTicket = 1;
+    RateLimiterStats stats;
+};
+
+class RateLimiterRegistry {
+public:
+    static RateLimiterRegistry* getInstance();
+    ~RateLimiterRegistry();
+
+    // 获取服务商的限流器（键不区分大小写），未配置 rate_limits 时返回 nullptr
+    RateLimiter* get(const std::string& provider);
+
+    // 所有限流器的统计，键为服务商名
+    std::map<std::string, RateLimiterStats> getAllStats();
+
+    // 登记限流器在指定时间需要再次检查
+    void schedule(RateLimiter* limiter, RateLimiter::Clock::time_point when);
+
+private:
+    RateLimiterRegistry();
+    RateLimiterRegistry(const RateLimiterRegistry&) = delete;
+    RateLimiterRegistry& operator=(const RateLimiterRegistry&) = delete;
+
+    // 调度线程：在最早的登记时间唤醒对应的限流器
+    void run();
+
+    static std::unique_ptr<RateLimiterRegistry> instance;
+    static std::mutex instanceMutex;
+
+    std::map<std::string, std::unique_ptr<RateLimiter>> limiters;  // 创建后不再修改
+
+    std::mutex timerMutex;
+    std::condition_variable timerCondition;
+    std::multimap<RateLimiter::Clock::time_point, RateLimiter*> timers;
+    std::map<RateLimiter*, RateLimiter::Clock::time_point> scheduled;  // 每个限流器只保留最早的一次登记
+    bool stopping = false;
+    std::thread timerThread;
+};
+
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_RATELIMITER_H
@@ -0,0 +1,111 @@
+#include "SearchResultMerger.h"
+#include "../log/Logger.h"
+#include "../utils/TextUtils.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace IntelliSearch {
+
+namespace {
+
+// 合并过程中的候选结果
+struct ScoredPage {
+    WebPageResult page;
+    double score;
+    std::unordered_set<uint64_t> snippetBigrams;
+};
+
+} // namespace
+
+/*
+ * Summary: 合并多个搜索服务的结果
+ * Parameters:
+ *   const std::vector<ProviderSearchResults>& providerResults - 各服务的结果与权重
+ *   const MergeOptions& options - 合并参数
+ * Return: SearchResults - 去重并按得分降序排列的结果
+ * Description: 每个服务只取排名前 maxResultsPerProvider 条参与合并。
+ *              weighted_score 策略下每条结果得分为 权重 / (排名 + 1)。URL 归一化后相同、
+ *              或摘要相似度达到阈值的结果视为同一条，得分累加（多个服务都返回的结果排名更靠前），
+ *              保留信息更完整的摘要
+ */
+SearchResults SearchResultMerger::merge(const std::vector<ProviderSearchResults>& providerResults,
+                                        const MergeOptions& options) {
+    if (options.strategy != "weighted_score") {
+        WARNLOG("Unknown result merge strategy '{}', falling back to weighted_score", options.strategy);
+    }
+
+    SearchResults merged;
+    merged.hasFilteredResults = false;
+
+    std::vector<ScoredPage> candidates;
+    std::unordered_map<std::string, size_t> urlIndex;
+    std::unordered_set<std::string> imageUrls;
+    size_t duplicateCount = 0;
+
+    for (const auto& provider : providerResults) {
+        merged.hasFilteredResults = merged.hasFilteredResults || provider.results.hasFilteredResults;
+
+        const auto& pages = provider.results.webPages;
+        size_t pageCount = std::min(pages.size(), options.maxResultsPerProvider);
+        for (size_t rank = 0; rank < pageCount; ++rank) {
+            const auto& page = pages[rank];
+            double score = provider.weight / static_cast<double>(rank + 1);
+            std::string urlKey = TextUtils::normalizeUrl(page.url);
+            auto bigrams = TextUtils::charBigrams(TextUtils::normalizeQuery(page.snippet));
+
+            // 先按 URL 查找重复，再按摘要相似度查找近似重复
+            size_t duplicateOf = candidates.size();
+            auto it = urlKey.empty() ? urlIndex.end() : urlIndex.find(urlKey);
+            if (it != urlIndex.end()) {
+                duplicateOf = it->second;
+            } else if (!bigrams.empty()) {
+                for (size_t i = 0; i < candidates.size(); ++i) {
+                    if (!candidates[i].snippetBigrams.empty() &&
+                        TextUtils::jaccardSimilarity(bigrams, candidates[i].snippetBigrams) >=
+                            options.snippetSimilarityThreshold) {
+                        duplicateOf = i;
+                        break;
+                    }
+                }
+            }
+
+            if (duplicateOf < candidates.size()) {
+                auto& existing = candidates[duplicateOf];
+                existing.score += score;
+                if (page.snippet.size() > existing.page.snippet.size()) {
+                    existing.page.snippet = page.snippet;
+                    existing.snippetBigrams = std::move(bigrams);
+                }
+                if (existing.page.siteName.empty()) existing.page.siteName = page.siteName;
+                if (existing.page.date.empty()) existing.page.date = page.date;
+                ++duplicateCount;
+                continue;
+            }
+
+            if (!urlKey.empty()) {
+                urlIndex.emplace(urlKey, candidates.size());
+            }
+            candidates.push_back({page, score, std::move(bigrams)});
+        }
+
+        for (const auto& image : provider.results.images) {
+            if (imageUrls.insert(image.contentUrl).second) {
+                merged.images.push_back(image);
+            }
+        }
+    }
+
+    // 稳定排序保证同分时保留服务顺序与原始排名
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const ScoredPage& lhs, const ScoredPage& rhs) { return lhs.score > rhs.score; });
+    for (size_t i = 0; i < candidates.size() && i < options.maxResults; ++i) {
+        merged.webPages.push_back(std::move(candidates[i].page));
+    }
+
+    INFOLOG("Merged results from {} providers: {} unique pages, {} duplicates removed, {} kept",
+            providerResults.size(), candidates.size(), duplicateCount, merged.webPages.size());
+    return merged;
+}
+
+} // namespace IntelliSearch
@@ -0,0 +1,40 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 多搜索服务结果合并，按 URL 与摘要相似度去重后按加权得分排序
+ */
+
+#ifndef INTELLISEARCH_SEARCHRESULTMERGER_H
+#define INTELLISEARCH_SEARCHRESULTMERGER_H
+
+#include "SearchService/SearchService.h"
+#include <string>
+#include <vector>
+
+namespace IntelliSearch {
+
+// 单个搜索服务的返回结果及其权重
+struct ProviderSearchResults {
+    std::string provider;
+    double weight;
+    SearchResults results;
+};
+
+struct MergeOptions {
+    std::string strategy = "weighted_score";
+    size_t maxResultsPerProvider = 10;       // 每个服务参与合并的结果数（按其原始排名截取）
+    size_t maxResults = 10;                  // 合并后保留的网页结果数
+    double snippetSimilarityThreshold = 0.8; // 摘要二元组相似度不低于该值视为重复
+};
+
+class SearchResultMerger {
+public:
+    // 合并多个搜索服务的结果，返回去重排序后的 SearchResults
+    static SearchResults merge(const std::vector<ProviderSearchResults>& providerResults,
+                               const MergeOptions& options);
+};
+
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_SEARCHRESULTMERGER_H
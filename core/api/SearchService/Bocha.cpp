@@ -1,4 +1,5 @@
 #include "Bocha.h"
+#include "SearchResultDecoder.h"
 #include "../../log/Logger.h"
 #include "../../config/ConfigManager.h"
 #include <curl/curl.h>
@@ -14,6 +15,7 @@ Bocha::Bocha() {
     baseUrl = config->getApiProviderConfig("bocha")["base_url"].get<std::string>();
     maxResults = config->getApiProviderConfig("bocha")["max_results"].get<int>();
     timeoutMs = config->getApiProviderConfig("bocha")["timeout_ms"].get<int>();
+    freshness = config->getApiProviderConfig("bocha").value("freshness", std::string("oneYear"));
     
     if (apiKey.empty()) {
         WARNLOG("Bocha API key not found in configuration");
@@ -34,17 +36,10 @@ Bocha::Bocha() {
 
 Bocha::~Bocha() = default;
 
-// 静态回调函数用于接收响应数据
-static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
-    userp->append((char*)contents, size * nmemb);
-    return size * nmemb;
-}
-
 nlohmann::json Bocha::performSearch(const std::string& intentResult) {
     try {
         // 从 intentResult 中正确提取 query 字段
         std::string query = intentResult;
-        std::string freshness = "oneYear";  // 默认值
         bool summary = false;
         int count = 10;
 
@@ -67,68 +62,101 @@ nlohmann::json Bocha::search(const std::string& query,
                               const std::string& freshness,
                               bool summary,
                               int count) {
-    
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        throw std::runtime_error("Failed to initialize CURL");
+    return nlohmann::json::parse(requestSearch(query, freshness, summary, count));
+}
+
+/*
+ * Summary: 执行搜索并直接解码为结构化结果
+ * Parameters:
+ *   const std::string& query - 搜索查询字符串
+ *   const std::shared_ptr<CancellationToken>& cancellation - 可选，取消时中止请求
+ * Return: SearchResults - 网页与图片结果；响应缺少 data 对象时抛出异常
+ */
+SearchResults Bocha::fetchResults(const std::string& query, const std::shared_ptr<CancellationToken>& cancellation) {
+    try {
+        return fetchResultsAsync(query, cancellation).get();
+    } catch (const RequestCancelled&) {
+        throw;
+    } catch (const std::exception& e) {
+        ERRORLOG("Search failed: {}", e.what());
+        throw;
     }
-    
-    std::string readBuffer;
-    struct curl_slist* headers = NULL;
+}
 
+/*
+ * Summary: 发起搜索后立即返回
+ * Parameters:
+ *   const std::string& query - 搜索查询字符串
+ *   const std::shared_ptr<CancellationToken>& cancellation - 可选，取消时中止请求
+ * Return: std::future<SearchResults> - 响应在 I/O 线程中直接解码为网页与图片结果
+ */
+std::future<SearchResults> Bocha::fetchResultsAsync(const std::string& query,
+                                                    const std::shared_ptr<CancellationToken>& cancellation) {
+    static const SearchResultSchema schema = {
+        {"data", "webPages", "value", "*"},
+        {
+            {"name", &WebPageResult::title},
+            {"url", &WebPageResult::url},
+            {"snippet", &WebPageResult::snippet},
+            {"siteName", &WebPageResult::siteName},
+            {"dateLastCrawled", &WebPageResult::date}
+        },
+        {"data", "images", "value", "*"},
+        {
+            {"thumbnailUrl", &ImageResult::thumbnailUrl},
+            {"contentUrl", &ImageResult::contentUrl}
+        },
+        {"data", "webPages", "someResultsRemoved"},
+        "data"
+    };
+
+    INFOLOG("Performing Bocha search for query: {}", query);
+    return performRequestAsync(baseUrl + "/web-search", "Authorization: Bearer " + apiKey,
+                               buildRequestBody(query, freshness, false, 10), timeoutMs, cancellation,
+                               [](const std::string& body) {
+                                   auto results = SearchResultDecoder::decode(body, schema);
+                                   INFOLOG("Processed {} web results and {} image results",
+                                           results.webPages.size(), results.images.size());
+                                   if (results.hasFilteredResults) {
+                                       WARNLOG("Partial results filtered by search provider");
+                                   }
+                                   return results;
+                               });
+}
+
+std::string Bocha::buildRequestBody(const std::string& query, const std::string& freshness, bool summary,
+                                    int count) const {
+    nlohmann::json requestBody = {
+        {"query", query},
+        {"freshness", freshness},
+        {"summary", summary},
+        {"count", count}
+    };
+    return requestBody.dump();
+}
+
+std::string Bocha::requestSearch(const std::string& query,
+                                 const std::string& freshness,
+                                 bool summary,
+                                 int count,
+                                 const std::shared_ptr<CancellationToken>& cancellation) {
     try {
         // 准备请求体
         INFOLOG("Performing Bocha search for query: {}", query);
-        nlohmann::json requestBody = {  
-            {"query", query},
-            {"freshness", freshness},
-            {"summary", summary},
-            {"count", count}
-        };
-        std::string jsonBody = requestBody.dump();
-
-        // 设置请求头
-        headers = curl_slist_append(headers, "Content-Type: application/json");
+        std::string jsonBody = buildRequestBody(query, freshness, summary, count);
+
+        // 使用连接池中的长连接句柄发送请求
         std::string authHeader = "Authorization: Bearer " + apiKey;
-        headers = curl_slist_append(headers, authHeader.c_str());
-        
-        // 配置 CURL
-        std::string url = baseUrl + "/web-search";
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, jsonBody.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeoutMs);
-
-        // 执行请求
-        CURLcode res = curl_easy_perform(curl);
-        
-        // 检查响应状态
-        long httpCode = 0;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
-        
-        // 清理
-        curl_easy_cleanup(curl);
-        
-        if (res != CURLE_OK) {
-            ERRORLOG("Curl request failed: {}", curl_easy_strerror(res));
-            throw std::runtime_error("Search API request failed");
-        }
-        
-        if (httpCode != 200) {
-            ERRORLOG("Bocha API request failed with status code: {} - {}", httpCode, readBuffer);
-            throw std::runtime_error("Search API request failed");
-        }
-        
+        std::string readBuffer = performRequest(baseUrl + "/web-search", authHeader, jsonBody, timeoutMs, cancellation);
+
         // 添加API返回结果的日志
-        INFOLOG("Bocha API response: {}", readBuffer);
-        
-        return nlohmann::json::parse(readBuffer);
+        DEBUGLOG("Bocha API response: {}", readBuffer);
+
+        return readBuffer;
         
+    } catch (const RequestCancelled&) {
+        throw;
     } catch (const std::exception& e) {
-        if (headers) curl_slist_free_all(headers);
-        if (curl) curl_easy_cleanup(curl);
         ERRORLOG("Search request failed: {}", e.what());
         throw;
     }
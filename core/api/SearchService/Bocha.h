@@ -28,11 +28,27 @@ public:
 
     SearchResults processSearchResults(const nlohmann::json& response) override;
 
+    // 直接将响应体解码为 SearchResults，不经过 JSON 文档
+    SearchResults fetchResults(const std::string& query,
+                               const std::shared_ptr<CancellationToken>& cancellation = nullptr) override;
+    std::future<SearchResults> fetchResultsAsync(const std::string& query,
+                                                 const std::shared_ptr<CancellationToken>& cancellation = nullptr) override;
+
+    std::string getFreshness() const override { return freshness; }
+
 private:
+    // 发送搜索请求并返回原始响应体
+    std::string requestSearch(const std::string& query, const std::string& freshness, bool summary, int count,
+                              const std::shared_ptr<CancellationToken>& cancellation = nullptr);
+
+    // 序列化搜索请求体
+    std::string buildRequestBody(const std::string& query, const std::string& freshness, bool summary, int count) const;
+
     std::string apiKey; // API 密钥
     std::string baseUrl; // 基础 URL
     int maxResults; // 最大结果数
     int timeoutMs; // 超时时间
+    std::string freshness; // 搜索时间范围
 };
 
 } // namespace IntelliSearch
@@ -3,6 +3,7 @@
 //
 
 #include "Exa.h"
+#include "SearchResultDecoder.h"
 #include "../../log/Logger.h"
 #include "../../config/ConfigManager.h"
 #include <curl/curl.h>
@@ -11,6 +12,30 @@
 
 namespace IntelliSearch {
 
+    namespace {
+
+    // Exa 的 /search 不返回摘要，以截断的正文作为 snippet，长度与博查的摘要相当
+    constexpr int SNIPPET_MAX_CHARACTERS = 400;
+
+    const SearchResultSchema& exaSchema() {
+        static const SearchResultSchema schema = {
+            {"results", "*"},
+            {
+                {"title", &WebPageResult::title},
+                {"url", &WebPageResult::url},
+                {"text", &WebPageResult::snippet},
+                {"publishedDate", &WebPageResult::date}
+            },
+            {},
+            {},
+            {},
+            ""
+        };
+        return schema;
+    }
+
+    } // namespace
+
     Exa::Exa()  {
         // 从配置文件获取API密钥
         auto* config = ConfigManager::getInstance();
@@ -21,23 +46,16 @@ namespace IntelliSearch {
         
 
         if (apiKey.empty()) {
-            WARNLOG("Bocha API key not found in configuration");
+            WARNLOG("Exa API key not found in configuration");
         }
 
         if (baseUrl.empty()) {
-            WARNLOG("Bocha base URL not found in configuration");
+            WARNLOG("Exa base URL not found in configuration");
         }
     }
 
     Exa::~Exa() = default;
 
-    // 静态回调函数用于接收响应数据
-    static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
-        userp->append((char*)contents, size * nmemb);
-        return size * nmemb;
-    }
-
-
     nlohmann::json Exa::performSearch(const std::string& intentResult) {
         try {
             // 从 intentResult 中正确提取 query 字段
@@ -65,70 +83,81 @@ namespace IntelliSearch {
                 std::string category,
                 bool text,
                 int count) {
-
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        throw std::runtime_error("Failed to initialize CURL");
+        return nlohmann::json::parse(requestSearch(query, type, text, count));
     }
 
-    std::string readBuffer;
-    struct curl_slist* headers = NULL;
+    /*
+     * Summary: 执行搜索并直接解码为结构化结果
+     * Parameters:
+     *   const std::string& query - 搜索查询字符串
+     *   const std::shared_ptr<CancellationToken>& cancellation - 可选，取消时中止请求
+     * Return: SearchResults - 网页结果（Exa 不返回图片）
+     */
+    SearchResults Exa::fetchResults(const std::string& query, const std::shared_ptr<CancellationToken>& cancellation) {
+        try {
+            return fetchResultsAsync(query, cancellation).get();
+        } catch (const RequestCancelled&) {
+            throw;
+        } catch (const std::exception& e) {
+            ERRORLOG("Search failed: {}", e.what());
+            throw;
+        }
+    }
 
-    try {
-        // 准备请求体
+    /*
+     * Summary: 发起搜索后立即返回
+     * Parameters:
+     *   const std::string& query - 搜索查询字符串
+     *   const std::shared_ptr<CancellationToken>& cancellation - 可选，取消时中止请求
+     * Return: std::future<SearchResults> - 响应在 I/O 线程中直接解码为网页结果
+     */
+    std::future<SearchResults> Exa::fetchResultsAsync(const std::string& query,
+                                                      const std::shared_ptr<CancellationToken>& cancellation) {
         INFOLOG("Performing Exa search for query: {}", query);
+        return performRequestAsync(baseUrl + "/search", "Authorization: Bearer " + apiKey,
+                                   buildRequestBody(query, "auto", false, 10), timeoutMs, cancellation,
+                                   [](const std::string& body) { return SearchResultDecoder::decode(body, exaSchema()); });
+    }
+
+    /*
+     * Summary: 序列化搜索请求体
+     * Parameters:
+     *   bool text - true 时返回完整正文，false 时只返回截断到 SNIPPET_MAX_CHARACTERS 的正文作为摘要
+     */
+    std::string Exa::buildRequestBody(const std::string& query, const std::string& type, bool text, int count) const {
+        nlohmann::json contents = text ? nlohmann::json(true)
+                                       : nlohmann::json{{"maxCharacters", SNIPPET_MAX_CHARACTERS}};
         nlohmann::json requestBody = {
             {"query", query},
             {"type", type},
             {"numResults", count},
             {"contents", {
-                    {"text", text}
+                    {"text", contents}
             }}
         };
-        std::string jsonBody = requestBody.dump();
+        return requestBody.dump();
+    }
 
-        // 设置请求头
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        std::string authHeader = "Authorization: Bearer " + apiKey;
-        headers = curl_slist_append(headers, authHeader.c_str());
-
-        // 配置 CURL
-        std::string url = baseUrl + "/search";
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, jsonBody.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeoutMs);
-
-        // 执行请求
-        CURLcode res = curl_easy_perform(curl);
-
-        // 检查响应状态
-        long httpCode = 0;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
-
-        // 清理
-        curl_easy_cleanup(curl);
-
-        if (res != CURLE_OK) {
-            ERRORLOG("Curl request failed: {}", curl_easy_strerror(res));
-            throw std::runtime_error("Search API request failed");
-        }
+    std::string Exa::requestSearch(const std::string& query, const std::string& type, bool text, int count,
+                                   const std::shared_ptr<CancellationToken>& cancellation) {
 
-        if (httpCode != 200) {
-            ERRORLOG("Exa API request failed with status code: {} - {}", httpCode, readBuffer);
-            throw std::runtime_error("Search API request failed");
-        }
+    try {
+        // 准备请求体
+        INFOLOG("Performing Exa search for query: {}", query);
+        std::string jsonBody = buildRequestBody(query, type, text, count);
+
+        // 使用连接池中的长连接句柄发送请求
+        std::string authHeader = "Authorization: Bearer " + apiKey;
+        std::string readBuffer = performRequest(baseUrl + "/search", authHeader, jsonBody, timeoutMs, cancellation);
 
         // 添加API返回结果的日志
-        INFOLOG("Exa API response: {}", readBuffer);
+        DEBUGLOG("Exa API response: {}", readBuffer);
 
-        return nlohmann::json::parse(readBuffer);
+        return readBuffer;
 
+    } catch (const RequestCancelled&) {
+        throw;
     } catch (const std::exception& e) {
-        if (headers) curl_slist_free_all(headers);
-        if (curl) curl_easy_cleanup(curl);
         ERRORLOG("Search request failed: {}", e.what());
         throw;
     }
@@ -137,7 +166,7 @@ namespace IntelliSearch {
 
     bool Exa::validateApiKey() const {
         if (apiKey.empty()) {
-            WARNLOG("Bocha API key is empty");
+            WARNLOG("Exa API key is empty");
             return false;
         }
         // TODO: 实现实际的API密钥验证逻辑
@@ -164,19 +193,14 @@ namespace IntelliSearch {
                         webResult.url = item["url"].get<std::string>();
                     }
                     
-                    // 提取摘要
-                    if (item.contains("snippet")) {
-                        webResult.snippet = item["snippet"].get<std::string>();
-                    }
-
-                    // 提取网站名称（如果有）
-                    if (item.contains("siteName")) {
-                        webResult.siteName = item["siteName"].get<std::string>();
+                    // 提取摘要（截断的正文）
+                    if (item.contains("text") && item["text"].is_string()) {
+                        webResult.snippet = item["text"].get<std::string>();
                     }
 
-                    // 提取日期（如果有）
-                    if (item.contains("date")) {
-                        webResult.date = item["date"].get<std::string>();
+                    // 提取发布日期（如果有）
+                    if (item.contains("publishedDate") && item["publishedDate"].is_string()) {
+                        webResult.date = item["publishedDate"].get<std::string>();
                     }
                     
                     results.webPages.push_back(webResult);
@@ -17,10 +17,10 @@ namespace IntelliSearch
             ~Exa() override;
 
             // 实现 APIService 的纯虚函数
-            std::string getServiceName() const override { return "Bocha"; }
+            std::string getServiceName() const override { return "Exa"; }
             bool isAvailable() const override { return !apiKey.empty() && validateApiKey(); }
             int getPriority() const override { return 1; }
-            void handleError(const std::string& error) override { ERRORLOG("Bocha service error: {}", error); };
+            void handleError(const std::string& error) override { ERRORLOG("Exa service error: {}", error); };
             bool validateApiKey() const override;
 
             // 实现 SearchService 的纯虚函数
@@ -33,7 +33,20 @@ namespace IntelliSearch
 
             SearchResults processSearchResults(const nlohmann::json& response) override;
 
+            // 直接将响应体解码为 SearchResults，不经过 JSON 文档
+            SearchResults fetchResults(const std::string& query,
+                                       const std::shared_ptr<CancellationToken>& cancellation = nullptr) override;
+            std::future<SearchResults> fetchResultsAsync(const std::string& query,
+                                                         const std::shared_ptr<CancellationToken>& cancellation = nullptr) override;
+
         private:
+            // 发送搜索请求并返回原始响应体
+            std::string requestSearch(const std::string& query, const std::string& type, bool text, int count,
+                                      const std::shared_ptr<CancellationToken>& cancellation = nullptr);
+
+            // 序列化搜索请求体
+            std::string buildRequestBody(const std::string& query, const std::string& type, bool text, int count) const;
+
             std::string apiKey; // API 密钥
             std::string baseUrl; // 基础 URL
             int maxResults; // 最大结果数
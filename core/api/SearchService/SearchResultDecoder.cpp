@@ -0,0 +1,129 @@
+#include "SearchResultDecoder.h"
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+
+namespace IntelliSearch {
+
+namespace {
+
+/*
+ * SAX 事件处理器。location 记录下一个值所在的路径：对象内为当前键，数组内为 "*"。
+ * 进入与 schema 路径相同位置的对象时开始一条结果，离开该对象时写入 SearchResults；
+ * 结果对象的直接字符串字段按字段表移动写入，嵌套值与未知字段直接丢弃
+ */
+class SaxHandler : public nlohmann::json_sax<nlohmann::json> {
+public:
+    SaxHandler(const SearchResultSchema& schema, SearchResults& results) : schema(schema), results(results) {}
+
+    bool null() override { return true; }
+
+    bool boolean(bool val) override {
+        if (location == schema.filteredFlagPath) {
+            results.hasFilteredResults = val;
+        }
+        return true;
+    }
+
+    bool number_integer(number_integer_t) override { return true; }
+    bool number_unsigned(number_unsigned_t) override { return true; }
+    bool number_float(number_float_t, const string_t&) override { return true; }
+    bool binary(binary_t&) override { return true; }
+
+    bool string(string_t& val) override {
+        if (inWebPage && location.size() == schema.webPagesPath.size() + 1) {
+            for (const auto& [name, field] : schema.webPageFields) {
+                if (location.back() == name) {
+                    currentPage.*field = std::move(val);
+                    break;
+                }
+            }
+        } else if (inImage && location.size() == schema.imagesPath.size() + 1) {
+            for (const auto& [name, field] : schema.imageFields) {
+                if (location.back() == name) {
+                    currentImage.*field = std::move(val);
+                    break;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        if (!inWebPage && location == schema.webPagesPath) {
+            inWebPage = true;
+            currentPage = WebPageResult();
+        } else if (!inImage && !schema.imagesPath.empty() && location == schema.imagesPath) {
+            inImage = true;
+            currentImage = ImageResult();
+        } else if (location.size() == 1 && location.front() == schema.requiredRootObject) {
+            sawRequiredRoot = true;
+        }
+        location.emplace_back();
+        return true;
+    }
+
+    bool key(string_t& val) override {
+        location.back() = val;
+        return true;
+    }
+
+    bool end_object() override {
+        location.pop_back();
+        if (inWebPage && location == schema.webPagesPath) {
+            results.webPages.push_back(std::move(currentPage));
+            inWebPage = false;
+        } else if (inImage && location == schema.imagesPath) {
+            results.images.push_back(std::move(currentImage));
+            inImage = false;
+        }
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        location.emplace_back("*");
+        return true;
+    }
+
+    bool end_array() override {
+        location.pop_back();
+        return true;
+    }
+
+    bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception& ex) override {
+        throw std::runtime_error("Invalid search response at byte " + std::to_string(position) + ": " + ex.what());
+    }
+
+    bool sawRequiredRoot = false;
+
+private:
+    const SearchResultSchema& schema;
+    SearchResults& results;
+    std::vector<std::string> location;
+    bool inWebPage = false;
+    bool inImage = false;
+    WebPageResult currentPage;
+    ImageResult currentImage;
+};
+
+} // namespace
+
+/*
+ * Summary: 将服务商响应体解码为 SearchResults
+ * Parameters:
+ *   const std::string& body - 原始响应体
+ *   const SearchResultSchema& schema - 服务商的字段布局
+ * Return: SearchResults - 按响应中出现顺序排列的结果
+ * Description: 单次扫描响应体，字段值从解析缓冲区直接移动进结果结构，
+ *              替代 parse -> JSON DOM -> processSearchResults 的两次遍历与整份文档的内存分配
+ */
+SearchResults SearchResultDecoder::decode(const std::string& body, const SearchResultSchema& schema) {
+    SearchResults results;
+    SaxHandler handler(schema, results);
+    nlohmann::json::sax_parse(body, &handler);
+    if (!schema.requiredRootObject.empty() && !handler.sawRequiredRoot) {
+        throw std::runtime_error("Invalid API response structure: missing \"" + schema.requiredRootObject + "\" object");
+    }
+    return results;
+}
+
+} // namespace IntelliSearch
@@ -0,0 +1,37 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 基于 SAX 的搜索响应解码器，按服务商的字段路径把响应体直接解码为
+ *              WebPageResult/ImageResult，不构建中间的 JSON 文档树
+ */
+
+#ifndef INTELLISEARCH_SEARCHRESULTDECODER_H
+#define INTELLISEARCH_SEARCHRESULTDECODER_H
+
+#include "SearchService.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace IntelliSearch {
+
+// 服务商响应的字段布局。路径为从根对象开始的键序列，数组元素用 "*" 表示
+struct SearchResultSchema {
+    std::vector<std::string> webPagesPath;     // 网页结果对象所在路径，如 {"data", "webPages", "value", "*"}
+    std::vector<std::pair<std::string, std::string WebPageResult::*>> webPageFields;
+    std::vector<std::string> imagesPath;       // 为空表示不解析图片
+    std::vector<std::pair<std::string, std::string ImageResult::*>> imageFields;
+    std::vector<std::string> filteredFlagPath; // 布尔值，对应 SearchResults::hasFilteredResults
+    std::string requiredRootObject;            // 非空时要求根对象包含该键且其值为对象，否则视为无效响应
+};
+
+class SearchResultDecoder {
+public:
+    // 解码响应体；JSON 语法错误或缺少 requiredRootObject 时抛出 std::runtime_error
+    static SearchResults decode(const std::string& body, const SearchResultSchema& schema);
+};
+
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_SEARCHRESULTDECODER_H
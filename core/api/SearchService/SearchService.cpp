@@ -1,7 +1,8 @@
 #include "SearchService.h"
+#include "../AsyncHttpClient.h"
+#include "../CircuitBreaker.h"
 #include "../../../log/Logger.h"
 #include "../../../config/ConfigManager.h"
-#include <curl/curl.h>
 #include <nlohmann/json.hpp>
 #include <string>
 #include <vector>
@@ -11,54 +12,158 @@
 
 namespace IntelliSearch {
 
-// 静态回调函数用于接收响应数据
-static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
-    userp->append((char*)contents, size * nmemb);
-    return size * nmemb;
-}
-
 /*
  * Summary: SearchService构造函数
  * Parameters:
  *   QObject* parent - 父对象指针
- * Description: 初始化SearchService，设置CURL句柄，并检查初始化是否成功
+ * Description: 初始化SearchService；HTTP 请求统一由 AsyncHttpClient 发送
  */
 SearchService::SearchService() {
-    curl = curl_easy_init();
-    if (!curl) {
-        ERRORLOG("Failed to initialize CURL");
-        throw std::runtime_error("Failed to initialize CURL");
-    }
     requestCount = 0;
     lastResetTime = getCurrentTimeMs();
 }
 
+SearchService::~SearchService() = default;
+
+SearchResults SearchService::fetchResults(const std::string& query,
+                                          const std::shared_ptr<CancellationToken>& cancellation) {
+    if (cancellation) {
+        cancellation->throwIfCancelled("Search");
+    }
+    return processSearchResults(performSearch(query));
+}
+
+std::future<SearchResults> SearchService::fetchResultsAsync(const std::string& query,
+                                                           const std::shared_ptr<CancellationToken>& cancellation) {
+    std::promise<SearchResults> promise;
+    try {
+        promise.set_value(fetchResults(query, cancellation));
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+    }
+    return promise.get_future();
+}
+
 /*
- * Summary: SearchService析构函数
- * Description: 释放CURL句柄
+ * Summary: 发送POST请求并返回响应体
+ * Parameters:
+ *   const std::string& url - 请求地址
+ *   const std::string& authHeader - 认证请求头
+ *   const std::string& requestBody - 序列化后的请求体
+ *   long timeoutMs - 请求超时时间（毫秒）
+ * Return: std::string - 响应体
+ * Description: 阻塞等待 sendRequest 的结果，失败时抛出异常
  */
-SearchService::~SearchService() {
-    // 释放搜索服务资源
-    if (curl) {
-        curl_easy_cleanup(curl);
-        curl = nullptr;
-    }
+std::string SearchService::performRequest(const std::string& url, const std::string& authHeader,
+                                          const std::string& requestBody, long timeoutMs,
+                                          const std::shared_ptr<CancellationToken>& cancellation) {
+    auto promise = std::make_shared<std::promise<std::string>>();
+    auto pendingBody = promise->get_future();
+    sendRequest(url, authHeader, requestBody, timeoutMs, cancellation,
+                [promise](std::string body, std::exception_ptr error) {
+                    if (error) {
+                        promise->set_exception(error);
+                    } else {
+                        promise->set_value(std::move(body));
+                    }
+                });
+    return pendingBody.get();
 }
 
-void SearchService::setupBasicCurlOptions(const std::string& url, std::string* response) {
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, response);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+std::future<SearchResults> SearchService::performRequestAsync(const std::string& url, const std::string& authHeader,
+                                                              const std::string& requestBody, long timeoutMs,
+                                                              const std::shared_ptr<CancellationToken>& cancellation,
+                                                              std::function<SearchResults(const std::string&)> decode) {
+    auto promise = std::make_shared<std::promise<SearchResults>>();
+    auto pendingResults = promise->get_future();
+    sendRequest(url, authHeader, requestBody, timeoutMs, cancellation,
+                [promise, decode = std::move(decode)](std::string body, std::exception_ptr error) {
+                    if (error) {
+                        promise->set_exception(error);
+                        return;
+                    }
+                    try {
+                        promise->set_value(decode(body));
+                    } catch (...) {
+                        promise->set_exception(std::current_exception());
+                    }
+                });
+    return pendingResults;
 }
 
-struct curl_slist* SearchService::setupRequestHeaders(const std::string& contentType, const std::string& authHeader) {
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, contentType.c_str());
-    headers = curl_slist_append(headers, authHeader.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    return headers;
+/*
+ * Summary: 提交POST请求，完成后回调响应体或异常
+ * Parameters:
+ *   const std::string& url - 请求地址
+ *   const std::string& authHeader - 认证请求头
+ *   const std::string& requestBody - 序列化后的请求体
+ *   long timeoutMs - 请求超时时间（毫秒）
+ *   const std::shared_ptr<CancellationToken>& cancellation - 可选，取消时立即中止传输
+ *   ResponseHandler onResponse - 完成回调，通常在 I/O 线程中执行；提交前失败时在调用线程中执行
+ * Description: 请求由 AsyncHttpClient 的 I/O 线程执行，使用连接池中的长连接句柄，调用线程不等待；
+ *              传输失败、超时与 5xx/429 响应计入该服务的熔断器
+ */
+void SearchService::sendRequest(const std::string& url, const std::string& authHeader,
+                                const std::string& requestBody, long timeoutMs,
+                                const std::shared_ptr<CancellationToken>& cancellation,
+                                ResponseHandler onResponse) {
+    HttpRequest request;
+    request.url = url;
+    request.headers = {"Content-Type: application/json", authHeader};
+    request.body = requestBody;
+    request.timeoutMs = timeoutMs;
+
+    // 熔断器断开时立即失败，不再等待超时
+    CircuitBreaker* breaker = CircuitBreakerRegistry::getInstance()->get("search/" + getServiceName());
+    try {
+        if (cancellation) {
+            cancellation->throwIfCancelled("Search request");
+            request.cancelled = cancellation->flag();
+        }
+        if (!breaker->tryAcquire()) {
+            throw CircuitOpenError("Circuit open for " + getServiceName());
+        }
+    } catch (...) {
+        onResponse(std::string(), std::current_exception());
+        return;
+    }
+
+    // 取消时唤醒 I/O 线程立即中止传输，传输结束后注销
+    uint64_t subscription = 0;
+    if (cancellation) {
+        subscription = cancellation->subscribe([]() { AsyncHttpClient::getInstance()->wakeup(); });
+    }
+
+    std::string serviceName = getServiceName();
+    AsyncHttpClient::getInstance()->send(std::move(request),
+        [breaker, cancellation, subscription, serviceName, url, onResponse = std::move(onResponse)](HttpResponse response) {
+            if (cancellation) {
+                cancellation->unsubscribe(subscription);
+            }
+
+            std::exception_ptr error;
+            if (cancellation && cancellation->isCancelled()) {
+                breaker->onAbandon();
+                DEBUGLOG("Search request cancelled: {}", url);
+                error = std::make_exception_ptr(RequestCancelled("Search request cancelled"));
+            } else if (!response.ok()) {
+                breaker->onFailure(response.curlCode == CURLE_OPERATION_TIMEDOUT);
+                ERRORLOG("Curl request failed: {}", response.error);
+                error = std::make_exception_ptr(std::runtime_error("Search API request failed"));
+            } else {
+                if (response.statusCode >= 500 || response.statusCode == 429) {
+                    breaker->onFailure(false);
+                } else {
+                    breaker->onSuccess();
+                }
+                if (response.statusCode != 200) {
+                    ERRORLOG("{} API request failed with status code: {} - {}", serviceName, response.statusCode,
+                             response.body);
+                    error = std::make_exception_ptr(std::runtime_error("Search API request failed"));
+                }
+            }
+            onResponse(error ? std::string() : std::move(response.body), error);
+        });
 }
 
-} // namespace IntelliSearch
\ No newline at end of file
+} // namespace IntelliSearch
@@ -2,9 +2,12 @@
 #define INTELLISEARCH_SEARCHSERVICE_H
 
 #include "../APIService.h"
-#include <curl/curl.h>
+#include "../CancellationToken.h"
 #include <string>
 #include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
 
 namespace IntelliSearch {
 
@@ -27,7 +30,7 @@ namespace IntelliSearch {
     {
         std::vector<WebPageResult> webPages;
         std::vector<ImageResult> images;
-        bool hasFilteredResults;
+        bool hasFilteredResults = false;
     };
 
 class SearchService : public APIService {
@@ -42,8 +45,20 @@ public:
     virtual nlohmann::json performSearch(const std::string& intentResult) = 0;
     virtual SearchResults processSearchResults(const nlohmann::json&) = 0;
 
+    // 执行搜索并返回结构化结果；默认实现为 processSearchResults(performSearch(query))，
+    // 服务商可覆盖为直接解码响应体，省去中间的 JSON 文档。cancellation 被取消时抛出 RequestCancelled
+    virtual SearchResults fetchResults(const std::string& query,
+                                       const std::shared_ptr<CancellationToken>& cancellation = nullptr);
+
+    // 发起搜索后立即返回，请求由 AsyncHttpClient 的 I/O 线程执行，响应解码后 future 就绪；
+    // 失败与取消以异常形式存入 future。默认实现在调用线程同步执行 fetchResults
+    virtual std::future<SearchResults> fetchResultsAsync(const std::string& query,
+                                                         const std::shared_ptr<CancellationToken>& cancellation = nullptr);
+
+    // 搜索的时间范围参数，不支持时返回空字符串（用于结果缓存的键）
+    virtual std::string getFreshness() const { return ""; }
+
 protected:
-    CURL* curl;  // CURL句柄
     int requestCount;  // 请求计数
     int64_t lastResetTime;  // 上次重置时间
 
@@ -54,9 +69,26 @@ protected:
         ).count();
     }
 
-    // CURL相关的辅助函数
-    void setupBasicCurlOptions(const std::string& url, std::string* response);
-    struct curl_slist* setupRequestHeaders(const std::string& contentType, const std::string& authHeader);
+    // 通过 AsyncHttpClient 发送POST请求并等待响应体；失败或非200状态码时抛出异常，
+    // cancellation 被取消时立即中止传输并抛出 RequestCancelled
+    std::string performRequest(const std::string& url, const std::string& authHeader,
+                               const std::string& requestBody, long timeoutMs,
+                               const std::shared_ptr<CancellationToken>& cancellation = nullptr);
+
+    // performRequest 的异步版本：不阻塞调用线程，响应体在 I/O 线程中由 decode 解码后存入 future
+    std::future<SearchResults> performRequestAsync(const std::string& url, const std::string& authHeader,
+                                                   const std::string& requestBody, long timeoutMs,
+                                                   const std::shared_ptr<CancellationToken>& cancellation,
+                                                   std::function<SearchResults(const std::string&)> decode);
+
+private:
+    // 响应回调：成功时 error 为空
+    using ResponseHandler = std::function<void(std::string body, std::exception_ptr error)>;
+
+    // 提交请求并在完成时回调，熔断器计数、取消与状态码检查在此统一处理
+    void sendRequest(const std::string& url, const std::string& authHeader, const std::string& requestBody,
+                     long timeoutMs, const std::shared_ptr<CancellationToken>& cancellation,
+                     ResponseHandler onResponse);
 };
 
 } // namespace IntelliSearch
@@ -1,8 +1,14 @@
 #include "SearchServiceManager.h"
 #include "SearchService/Bocha.h"
 #include "SearchService/Exa.h"
+#include "CircuitBreaker.h"
 #include "../log/Logger.h"
 #include "../config/ConfigManager.h"
+#include "../utils/TextUtils.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <future>
 
 namespace IntelliSearch {
 
@@ -10,6 +16,11 @@ SearchServiceManager* SearchServiceManager::instance = nullptr;
 std::mutex SearchServiceManager::instanceMutex;
 
 SearchServiceManager* SearchServiceManager::getInstance() {
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    if (instance != nullptr) {
+        return instance;
+    }
+
     auto* config = ConfigManager::getInstance();
     auto apiProvider = config->getStringValue("search_service", "Bocha");
 
@@ -20,12 +31,25 @@ SearchServiceManager* SearchServiceManager::getInstance() {
 
     auto it = serviceMap.find(apiProvider);
     if (it != serviceMap.end()) {
-        std::lock_guard<std::mutex> lock(instanceMutex);
-        if (instance == nullptr) {
-            instance = new SearchServiceManager();
-            instance->registerService(it->second());
-            INFOLOG("SearchServiceManager initialized with {}", apiProvider);
+        instance = new SearchServiceManager();
+        instance->registerService(it->second());
+        instance->loadFanOutConfig();
+
+        // 并发搜索模式下额外注册其余服务，search_service 指定的服务仍作为主服务
+        if (instance->fanOutEnabled) {
+            for (const auto& provider : instance->fanOutProviders) {
+                auto extra = serviceMap.find(provider);
+                if (provider == apiProvider || extra == serviceMap.end()) {
+                    continue;
+                }
+                try {
+                    instance->registerService(extra->second());
+                } catch (const std::exception& e) {
+                    WARNLOG("Skipping search provider {} for fan-out: {}", provider, e.what());
+                }
+            }
         }
+        INFOLOG("SearchServiceManager initialized with {}", apiProvider);
         return instance;
     } else {
         ERRORLOG("Invalid API provider: {}", apiProvider);
@@ -36,6 +60,11 @@ SearchServiceManager* SearchServiceManager::getInstance() {
 void SearchServiceManager::registerService(std::unique_ptr<SearchService> service) {
     std::lock_guard<std::mutex> lock(servicesMutex);
     INFOLOG("Registering Search service: {}", service->getServiceName());
+    std::string healthCheckUrl = service->getHealthCheckUrl();
+    if (!healthCheckUrl.empty()) {
+        CircuitBreakerRegistry::getInstance()->registerHttpProbe("search/" + service->getServiceName(), healthCheckUrl,
+                                                                 service->getHealthCheckHeaders());
+    }
     services.push_back(std::move(service));
 }
 
@@ -67,23 +96,154 @@ SearchService* SearchServiceManager::selectNextAvailableService() {
     return nullptr;
 }
 
-nlohmann::json SearchServiceManager::performSearch(const std::string& intentResult) {
+SearchService* SearchServiceManager::getActiveService() {
     std::lock_guard<std::mutex> lock(servicesMutex);
+    if (services.empty()) {
+        return nullptr;
+    }
+    return services[currentServiceIndex].get();
+}
 
-    // 直接实例化具体的搜索对象
-    auto* config = ConfigManager::getInstance();
-    auto apiProvider = config->getStringValue("search_service", "Bocha");
+/*
+ * Summary: 使用已注册的搜索服务执行搜索
+ * Parameters:
+ *   const std::string& intentResult - 搜索查询字符串
+ * Return: nlohmann::json - 搜索服务返回的原始结果
+ * Description: 复用 getInstance 时注册的服务实例，不再每次查询重新构造服务和读取配置；
+ *              搜索请求在锁外执行，多个查询可并发访问同一服务
+ */
+nlohmann::json SearchServiceManager::performSearch(const std::string& intentResult) {
+    SearchService* service = getActiveService();
+    if (!service) {
+        ERRORLOG("No search service registered");
+        return nlohmann::json{{"error", "No search service registered"}};
+    }
+    return service->performSearch(intentResult);
+}
 
-    if (apiProvider == "bocha") {
-        Bocha bocha;
-        return bocha.performSearch(intentResult);
-    } else if (apiProvider == "exa") {
-        Exa exa;
-        return exa.performSearch(intentResult);
-    } else {
-        ERRORLOG("Invalid API provider: {}", apiProvider);
-        return nlohmann::json{{"error", "Invalid API provider"}};
+SearchResults SearchServiceManager::fetchResults(const std::string& query,
+                                                 const std::shared_ptr<CancellationToken>& cancellation) {
+    SearchService* service = getActiveService();
+    if (!service) {
+        throw std::runtime_error("No available search service");
+    }
+    return service->fetchResults(query, cancellation);
+}
+
+std::future<SearchResults> SearchServiceManager::fetchResultsAsync(const std::string& query,
+                                                                   const std::shared_ptr<CancellationToken>& cancellation) {
+    if (!fanOutEnabled) {
+        SearchService* service = getActiveService();
+        if (!service) {
+            throw std::runtime_error("No available search service");
+        }
+        return service->fetchResultsAsync(query, cancellation);
+    }
+
+    // 请求此时已全部发出，延迟执行的只有等待与合并
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(fanOutTimeoutMs);
+    auto requests = startFanOutRequests(query, cancellation);
+    return std::async(std::launch::deferred, [this, requests = std::move(requests), deadline, cancellation]() mutable {
+        return collectFanOutResults(requests, deadline, cancellation);
+    });
+}
+
+void SearchServiceManager::loadFanOutConfig() {
+    auto searchSettings = ConfigManager::getInstance()->getSectionConfig("search_settings");
+    auto fanOutConfig = searchSettings.value("fan_out", nlohmann::json::object());
+
+    fanOutEnabled = fanOutConfig.value("enabled", false);
+    fanOutProviders = fanOutConfig.value("providers", std::vector<std::string>{"bocha", "exa"});
+    providerWeights = fanOutConfig.value("weights", std::map<std::string, double>{});
+    fanOutTimeoutMs = searchSettings.value("timeout_ms", 5000);
+
+    mergeOptions.strategy = searchSettings.value("result_merge_strategy", std::string("weighted_score"));
+    mergeOptions.maxResultsPerProvider = searchSettings.value("max_results_per_provider", 10);
+    mergeOptions.maxResults = fanOutConfig.value("max_results", 10);
+    mergeOptions.snippetSimilarityThreshold = fanOutConfig.value("snippet_similarity_threshold", 0.8);
+}
+
+/*
+ * Summary: 并发查询所有已注册的搜索服务并合并结果
+ * Parameters:
+ *   const std::string& query - 搜索查询字符串
+ *   const std::shared_ptr<CancellationToken>& cancellation - 可选，取消时各服务的请求随之中止
+ * Return: SearchResults - 去重并按加权得分排序后的结果
+ * Description: 各服务的请求同时交给 AsyncHttpClient，调用线程最多等待 timeout_ms，
+ *              总耗时由截止时间而非最慢的服务决定。全部失败或超时时抛出异常
+ */
+SearchResults SearchServiceManager::performFanOutSearch(const std::string& query,
+                                                        const std::shared_ptr<CancellationToken>& cancellation) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(fanOutTimeoutMs);
+    auto requests = startFanOutRequests(query, cancellation);
+    return collectFanOutResults(requests, deadline, cancellation);
+}
+
+std::vector<SearchServiceManager::ProviderRequest> SearchServiceManager::startFanOutRequests(
+    const std::string& query, const std::shared_ptr<CancellationToken>& cancellation) {
+    std::vector<SearchService*> targets;
+    {
+        std::lock_guard<std::mutex> lock(servicesMutex);
+        // 熔断器断开的服务不参与本次搜索，避免拖到截止时间
+        auto* breakers = CircuitBreakerRegistry::getInstance();
+        for (const auto& service : services) {
+            if (service->isAvailable() && breakers->get("search/" + service->getServiceName())->isCallPermitted()) {
+                targets.push_back(service.get());
+            }
+        }
+    }
+    if (targets.empty()) {
+        throw std::runtime_error("No available search service");
+    }
+
+    // 每个服务一个子令牌：整个搜索取消时全部中止，错过截止时间的服务单独中止
+    std::vector<ProviderRequest> requests;
+    for (SearchService* service : targets) {
+        auto token = CancellationToken::linkedTo(cancellation);
+        requests.push_back({service, token, service->fetchResultsAsync(query, token)});
+    }
+    return requests;
+}
+
+/*
+ * Summary: 收集各服务的结果并合并
+ * Parameters:
+ *   std::vector<ProviderRequest>& requests - startFanOutRequests 发出的请求
+ *   std::chrono::steady_clock::time_point deadline - 截止时间
+ *   const std::shared_ptr<CancellationToken>& cancellation - 整个搜索的令牌
+ * Return: SearchResults - 合并后的结果
+ * Description: 截止时间后仍未完成的请求立即取消，传输被中止，不再占用连接与搜索配额
+ */
+SearchResults SearchServiceManager::collectFanOutResults(std::vector<ProviderRequest>& requests,
+                                                         std::chrono::steady_clock::time_point deadline,
+                                                         const std::shared_ptr<CancellationToken>& cancellation) {
+    std::vector<ProviderSearchResults> collected;
+    for (auto& request : requests) {
+        std::string name = request.service->getServiceName();
+        if (request.results.wait_until(deadline) != std::future_status::ready) {
+            WARNLOG("Search provider {} missed the {} ms fan-out deadline, cancelling", name, fanOutTimeoutMs);
+            request.token->cancel();
+            continue;
+        }
+        try {
+            std::string key = name;
+            std::transform(key.begin(), key.end(), key.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            auto weight = providerWeights.find(key);
+            collected.push_back({name, weight != providerWeights.end() ? weight->second : 1.0,
+                                 request.results.get()});
+        } catch (const std::exception& e) {
+            WARNLOG("Search provider {} failed during fan-out: {}", name, e.what());
+        }
+    }
+
+    if (cancellation) {
+        cancellation->throwIfCancelled("Fan-out search");
+    }
+    if (collected.empty()) {
+        throw std::runtime_error("All search providers failed or timed out");
     }
+    return SearchResultMerger::merge(collected, mergeOptions);
 }
 
 } // namespace IntelliSearch
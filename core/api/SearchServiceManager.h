@@ -2,9 +2,13 @@
 #define INTELLISEARCH_SEARCHSERVICEMANAGER_H
 
 #include "SearchService/SearchService.h"
+#include "SearchResultMerger.h"
+#include <chrono>
+#include <future>
 #include <memory>
 #include <vector>
 #include <mutex>
+#include <map>
 
 namespace IntelliSearch {
 
@@ -18,11 +22,28 @@ public:
     // 根据服务名称获取服务
     SearchService* getService(const std::string& serviceName);
 
-    // 获取当前可用的最高优先级服务
+    // 获取当前使用的搜索服务（按 search_service 配置注册的实例）
+    SearchService* getActiveService();
 
-    // 执行搜索
+    // 执行搜索，返回服务商的原始 JSON 响应
     nlohmann::json performSearch(const std::string& intentResult);
 
+    // 使用当前搜索服务执行搜索，响应直接解码为结构化结果；失败时抛出异常
+    SearchResults fetchResults(const std::string& query,
+                               const std::shared_ptr<CancellationToken>& cancellation = nullptr);
+
+    // 是否开启多服务并发搜索（search_settings.fan_out.enabled）
+    bool isFanOutEnabled() const { return fanOutEnabled; }
+
+    // 并发查询所有已注册的搜索服务，在 search_settings.timeout_ms 内收集结果并合并
+    SearchResults performFanOutSearch(const std::string& query,
+                                      const std::shared_ptr<CancellationToken>& cancellation = nullptr);
+
+    // 发起搜索后立即返回，请求由 AsyncHttpClient 执行，不占用调用线程；
+    // 并发搜索模式下各服务的请求同时发出，get() 时最多等到截止时间再合并
+    std::future<SearchResults> fetchResultsAsync(const std::string& query,
+                                                 const std::shared_ptr<CancellationToken>& cancellation = nullptr);
+
 private:
     SearchServiceManager() = default;
     ~SearchServiceManager() = default;
@@ -33,12 +54,38 @@ private:
     // 选择下一个可用服务（用于故障转移）
     SearchService* selectNextAvailableService();
 
+    // 读取并发搜索与结果合并配置
+    void loadFanOutConfig();
+
+    // 单个服务的进行中请求，token 为其独立的子令牌，超过截止时间时单独取消
+    struct ProviderRequest {
+        SearchService* service;
+        std::shared_ptr<CancellationToken> token;
+        std::future<SearchResults> results;
+    };
+
+    // 向所有可用服务发出请求，不等待结果
+    std::vector<ProviderRequest> startFanOutRequests(const std::string& query,
+                                                     const std::shared_ptr<CancellationToken>& cancellation);
+
+    // 在截止时间前收集结果并合并，未完成的请求被取消
+    SearchResults collectFanOutResults(std::vector<ProviderRequest>& requests,
+                                       std::chrono::steady_clock::time_point deadline,
+                                       const std::shared_ptr<CancellationToken>& cancellation);
+
     static SearchServiceManager* instance;
     static std::mutex instanceMutex;
 
     std::vector<std::unique_ptr<SearchService>> services;
     std::mutex servicesMutex;
     size_t currentServiceIndex{0};
+
+    // 并发搜索配置
+    bool fanOutEnabled{false};
+    std::vector<std::string> fanOutProviders;
+    std::map<std::string, double> providerWeights;  // 键为小写的服务名
+    int fanOutTimeoutMs{5000};
+    MergeOptions mergeOptions;
 };
 
 } // namespace IntelliSearch
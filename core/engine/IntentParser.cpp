@@ -1,6 +1,11 @@
 #include "IntentParser.h"
 #include "../../log/Logger.h"
 #include "../api/AIServiceManager.h"
+#include "../../config/ConfigManager.h"
+#include "../utils/TextUtils.h"
+#include "../utils/AhoCorasick.h"
+#include <algorithm>
+#include <filesystem>
 #include <stdexcept>
 #include <fstream>
 #include <sstream>
@@ -8,7 +13,28 @@
 
 namespace IntelliSearch {
 
-IntentParser::IntentParser() {
+namespace {
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool isAsciiWordChar(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+// 以字母数字开头或结尾的关键词必须作为完整单词出现，避免 "define" 命中 "undefined"；中文关键词不受限制
+bool isWholeWordMatch(const std::string& text, size_t begin, size_t end) {
+    bool startOk = !isAsciiWordChar(text[begin]) || begin == 0 || !isAsciiWordChar(text[begin - 1]);
+    bool endOk = !isAsciiWordChar(text[end - 1]) || end == text.size() || !isAsciiWordChar(text[end]);
+    return startOk && endOk;
+}
+
+} // namespace
+
+IntentParser::IntentParser() : localIntentEnabled(false), localConfidenceThreshold(0.8), localMaxInputLength(24),
+                               speculativeSearchEnabled(false), speculativeSimilarityThreshold(0.6),
+                               streamAnswerEnabled(false) {
     INFOLOG("Starting to initialize IntentParser");
     // 获取APIServiceManager实例
     aiServiceManager = AIServiceManager::getInstance();
@@ -16,6 +42,24 @@ IntentParser::IntentParser() {
         CRITICALLOG("Failed to get AIServiceManager instance");
         throw std::runtime_error("Failed to initialize AIServiceManager");
     }
+
+    // 读取推测搜索与流式答案配置
+    auto searchSettings = ConfigManager::getInstance()->getSectionConfig("search_settings");
+    streamAnswerEnabled = searchSettings.value("stream_answer", false);
+    auto speculativeConfig = searchSettings.value("speculative_search", nlohmann::json::object());
+    speculativeSearchEnabled = speculativeConfig.value("enabled", false);
+    speculativeSimilarityThreshold = speculativeConfig.value("similarity_threshold", 0.6);
+
+    // 规则文件缺失或格式错误时仅关闭本地快速路径，不影响 API 意图解析
+    try {
+        loadIntentConfig();
+    } catch (const std::exception& e) {
+        WARNLOG("Failed to load local intent rules, local fast path disabled: {}", e.what());
+        localIntentEnabled = false;
+        keywordMatcher.reset();
+        intentRules.clear();
+        keywordRuleIndex.clear();
+    }
 }
 
 IntentParser::~IntentParser() = default;
@@ -25,32 +69,348 @@ IntentParser::~IntentParser() = default;
  * @param userInput 用户输入
  * @return nlohmann::json 意图解析结果
  */
-nlohmann::json IntentParser::parseSearchIntent(const std::string& userInput) {
+nlohmann::json IntentParser::parseSearchIntent(const std::string& userInput,
+                                               const std::shared_ptr<CancellationToken>& cancellation) {
     DEBUGLOG("Received Intent parser request: {}", userInput);
-    
-    // 直接使用API进行意图解析
-    auto result = aiServiceManager->parseIntent(userInput);
-    
-    // 使用搜索引擎执行搜索
-    // auto searchResults = SearchEngine::getInstance()->performSearch(result);
 
-    // 将搜索结果添加到意图解析结果中
-    // result["search_results"] = searchResults;
-    
-    return result;
+    // 本地规则高置信度命中时跳过 LLM 调用
+    auto localResult = localIntentParsing(userInput);
+    if (!localResult.empty() && localResult.value("confidence", 0.0) >= localConfidenceThreshold) {
+        INFOLOG("Local intent fast path hit: {} (confidence {:.2f})",
+                localResult.value("intent", ""), localResult.value("confidence", 0.0));
+        return localResult;
+    }
+
+    // 低置信度或未命中时使用API进行意图解析，本地结果仅作兜底
+    if (localResult.empty()) {
+        return aiServiceManager->parseIntent(userInput, cancellation);
+    }
+    nlohmann::json apiResult;
+    try {
+        apiResult = aiServiceManager->parseIntent(userInput, cancellation);
+    } catch (const RequestCancelled&) {
+        throw;
+    } catch (const std::exception& e) {
+        WARNLOG("API intent parsing failed: {}", e.what());
+        apiResult = {{"error", e.what()}};
+    }
+    return mergeIntentResults(localResult, apiResult);
 }
 
 /*
  * Summary: 调用API进行搜索
  * @param query 搜索查询字符串
+ * @param onPartial 可选，流式接收答案的增量文本
  * @return nlohmann::json 搜索结果
  */
-nlohmann::json IntentParser::search(const std::string &query) {
+nlohmann::json IntentParser::search(const std::string &query, const StreamCallback& onPartial,
+                                    const std::shared_ptr<CancellationToken>& cancellation, SearchTrace* trace) {
     DEBUGLOG("Received search request: {}", query);
 
-    auto searchResults = SearchEngine::getInstance()->performSearch(query);
+    auto searchResults = SearchEngine::getInstance()->performSearch(query, onPartial, cancellation, trace);
 
     return searchResults;
 }
 
-} // namespace IntelliSearch
\ No newline at end of file
+/*
+ * Summary: 意图解析与搜索的组合执行
+ * Parameters:
+ *   const std::string& userInput - 用户原始输入
+ *   const StreamCallback& onPartial - 可选，流式接收答案的增量文本
+ *   const std::shared_ptr<CancellationToken>& cancellation - 可选，取消时中止所有阶段并抛出 RequestCancelled
+ *   SearchTrace* trace - 可选，记录各阶段耗时；skipAnalysis 时 search_result 为空对象
+ * Return: nlohmann::json - {"intent_parser": 意图解析结果, "search_result": 搜索分析结果}
+ * Description: 未开启推测搜索时串行执行 意图解析 -> 搜索；开启后在意图解析的同时以原始输入
+ *              发起网页搜索，若改写后的查询与原始输入足够相似则直接复用，否则用改写后的查询重新搜索。
+ *              推测搜索使用子令牌，结果不再需要时立即取消，不再占用搜索配额
+ */
+nlohmann::json IntentParser::parseAndSearch(const std::string& userInput, const StreamCallback& onPartial,
+                                            const std::shared_ptr<CancellationToken>& cancellation,
+                                            SearchTrace* trace) {
+    nlohmann::json combinedResult;
+    auto start = std::chrono::steady_clock::now();
+
+    if (!speculativeSearchEnabled) {
+        auto intentParserResult = parseSearchIntent(userInput, cancellation);
+        if (trace) {
+            trace->intentMs = elapsedMs(start);
+        }
+        combinedResult["intent_parser"] = intentParserResult;
+        if (cancellation) {
+            cancellation->throwIfCancelled("Search");
+        }
+        combinedResult["search_result"] = search(intentParserResult["query"], onPartial, cancellation, trace);
+        return combinedResult;
+    }
+
+    // 意图解析与推测搜索并行执行
+    auto speculationToken = CancellationToken::linkedTo(cancellation);
+    auto speculativeSearch = startSpeculativeSearch(userInput, speculationToken);
+    nlohmann::json intentParserResult;
+    try {
+        intentParserResult = parseSearchIntent(userInput, cancellation);
+    } catch (...) {
+        speculationToken->cancel();
+        throw;
+    }
+    if (trace) {
+        trace->intentMs = elapsedMs(start);
+    }
+    combinedResult["intent_parser"] = intentParserResult;
+
+    std::string rewrittenQuery = userInput;
+    if (intentParserResult.contains("query") && intentParserResult["query"].is_string()) {
+        rewrittenQuery = intentParserResult["query"].get<std::string>();
+    }
+
+    // 结果缓存命中时直接返回，推测搜索结果被丢弃
+    bool skipAnalysis = trace && trace->skipAnalysis;
+    nlohmann::json cachedAnswer;
+    if (!skipAnalysis && SearchEngine::getInstance()->lookupCachedAnswer(rewrittenQuery, cachedAnswer)) {
+        speculationToken->cancel();
+        if (trace) {
+            trace->cacheHit = true;
+        }
+        combinedResult["search_result"] = cachedAnswer;
+        return combinedResult;
+    }
+
+    if (isSpeculationUsable(userInput, rewrittenQuery)) {
+        SearchResults searchResults;
+        bool reused = false;
+        auto searchStart = std::chrono::steady_clock::now();
+        try {
+            searchResults = speculativeSearch.get();
+            reused = true;
+        } catch (const RequestCancelled&) {
+            throw;
+        } catch (const std::exception& e) {
+            WARNLOG("Speculative search failed, re-issuing with rewritten query: {}", e.what());
+        }
+        if (reused) {
+            INFOLOG("Speculative search reused for query: {}", userInput);
+            if (trace) {
+                trace->searchMs = elapsedMs(searchStart);
+                trace->speculativeHit = true;
+            }
+            if (skipAnalysis) {
+                combinedResult["search_result"] = nlohmann::json::object();
+                return combinedResult;
+            }
+            auto analysisStart = std::chrono::steady_clock::now();
+            combinedResult["search_result"] = SearchEngine::getInstance()->summarizeSearchResults(
+                searchResults, rewrittenQuery, onPartial, cancellation);
+            if (trace) {
+                trace->analysisMs = elapsedMs(analysisStart);
+            }
+            return combinedResult;
+        }
+    } else {
+        INFOLOG("Rewritten query differs from input, re-issuing search: {}", rewrittenQuery);
+        speculationToken->cancel();
+    }
+
+    // 推测搜索结果不可用时已被取消或失败，用改写后的查询重新搜索
+    if (cancellation) {
+        cancellation->throwIfCancelled("Search");
+    }
+    combinedResult["search_result"] = search(rewrittenQuery, onPartial, cancellation, trace);
+    return combinedResult;
+}
+
+/*
+ * Summary: 以原始输入启动推测搜索
+ * Parameters:
+ *   const std::string& userInput - 用户原始输入
+ *   const std::shared_ptr<CancellationToken>& cancellation - 可选，取消时请求立即中止
+ * Return: std::future<SearchResults> - 未经 AI 分析的搜索结果，失败时 get() 抛出异常
+ * Description: 请求交给 AsyncHttpClient 后立即返回，意图解析期间不额外占用线程；
+ *              不再需要结果时取消令牌即可中止传输，丢弃 future 不会阻塞调用方
+ */
+std::future<SearchResults> IntentParser::startSpeculativeSearch(const std::string& userInput,
+                                                                const std::shared_ptr<CancellationToken>& cancellation) {
+    DEBUGLOG("Starting speculative search for: {}", userInput);
+    return SearchEngine::getInstance()->fetchSearchResultsAsync(userInput, cancellation);
+}
+
+/*
+ * Summary: 判断改写后的查询能否复用推测搜索结果
+ * Parameters:
+ *   const std::string& userInput - 用户原始输入
+ *   const std::string& rewrittenQuery - 意图解析改写后的查询
+ * Return: bool - 归一化后相同或字符二元组相似度不低于阈值时返回 true
+ */
+bool IntentParser::isSpeculationUsable(const std::string& userInput, const std::string& rewrittenQuery) const {
+    if (TextUtils::normalizeQuery(userInput) == TextUtils::normalizeQuery(rewrittenQuery)) {
+        return true;
+    }
+    double similarity = TextUtils::bigramSimilarity(userInput, rewrittenQuery);
+    DEBUGLOG("Speculative query similarity: {:.3f} (threshold {:.3f})", similarity, speculativeSimilarityThreshold);
+    return similarity >= speculativeSimilarityThreshold;
+}
+
+/*
+ * Summary: 加载本地意图规则
+ * Parameters: 无
+ * Return: void
+ * Description: 读取 config.json 的 intent_rules 节与其指向的规则文件，将所有关键词归一化后
+ *              加入 Aho-Corasick 自动机，正则表达式预先编译。规则文件无法读取或解析时抛出异常
+ */
+void IntentParser::loadIntentConfig() {
+    intentConfig = ConfigManager::getInstance()->getSectionConfig("intent_rules");
+    localIntentEnabled = intentConfig.value("enabled", false);
+    localConfidenceThreshold = intentConfig.value("confidence_threshold", 0.8);
+    localMaxInputLength = intentConfig.value("max_input_length", static_cast<size_t>(24));
+    if (!localIntentEnabled) {
+        INFOLOG("Local intent fast path disabled");
+        return;
+    }
+
+    std::string rulesPath = resolveRulesPath(intentConfig.value("path", std::string("config/IntentRules.json")));
+    std::ifstream rulesFile(rulesPath);
+    if (!rulesFile.is_open()) {
+        throw std::runtime_error("Failed to open intent rules file: " + rulesPath);
+    }
+    auto rulesJson = nlohmann::json::parse(rulesFile);
+    if (!rulesJson.contains("rules") || !rulesJson["rules"].is_array()) {
+        throw std::runtime_error("Intent rules file has no rules array: " + rulesPath);
+    }
+
+    auto matcher = std::make_unique<AhoCorasick>();
+    for (const auto& ruleJson : rulesJson["rules"]) {
+        IntentRule rule;
+        rule.intent = ruleJson.at("intent").get<std::string>();
+        rule.weight = ruleJson.value("weight", 0.8);
+        for (const auto& pattern : ruleJson.value("patterns", nlohmann::json::array())) {
+            rule.patterns.emplace_back(pattern.get<std::string>(), std::regex::ECMAScript | std::regex::icase);
+        }
+        for (const auto& keyword : ruleJson.value("keywords", nlohmann::json::array())) {
+            std::string normalized = TextUtils::normalizeQuery(keyword.get<std::string>());
+            if (normalized.empty()) {
+                continue;
+            }
+            matcher->addPattern(normalized);
+            keywordRuleIndex.push_back(intentRules.size());
+        }
+        intentRules.push_back(std::move(rule));
+    }
+    matcher->build();
+    keywordMatcher = std::move(matcher);
+
+    INFOLOG("Loaded {} local intent rules ({} keywords) from {}",
+            intentRules.size(), keywordRuleIndex.size(), rulesPath);
+}
+
+/*
+ * Summary: 定位规则文件
+ * Parameters:
+ *   const std::string& rulesPath - 配置中的规则文件路径
+ * Return: std::string - 存在的文件路径；均不存在时返回原始路径
+ */
+std::string IntentParser::resolveRulesPath(const std::string& rulesPath) const {
+    if (std::filesystem::exists(rulesPath)) {
+        return rulesPath;
+    }
+    std::filesystem::path configDir =
+        std::filesystem::path(ConfigManager::getInstance()->getConfigPath()).parent_path();
+    auto candidate = configDir / std::filesystem::path(rulesPath).filename();
+    if (std::filesystem::exists(candidate)) {
+        return candidate.string();
+    }
+    return rulesPath;
+}
+
+/*
+ * Summary: 基于关键词与正则规则的本地意图解析
+ * Parameters:
+ *   const std::string& input - 用户原始输入
+ * Return: nlohmann::json - 与 API 意图解析结果同结构，附加 source 与 confidence 字段；
+ *                          未命中任何规则时返回空对象
+ * Description: 归一化输入只扫描一遍自动机即可得到所有命中的关键词，拉丁关键词只在单词边界处计入。
+ *              命中多个意图时说明输入存在歧义，长输入通常需要 LLM 改写查询，两种情况都会降低置信度，使其回退到 API
+ */
+nlohmann::json IntentParser::localIntentParsing(const std::string& input) {
+    if (!localIntentEnabled || !keywordMatcher) {
+        return nlohmann::json::object();
+    }
+
+    std::vector<double> scores(intentRules.size(), 0.0);
+    std::string normalized = TextUtils::normalizeQuery(input);
+    for (const auto& match : keywordMatcher->findAll(normalized)) {
+        if (!isWholeWordMatch(normalized, match.end - keywordMatcher->patternLength(match.patternId), match.end)) {
+            continue;
+        }
+        size_t ruleIndex = keywordRuleIndex[match.patternId];
+        scores[ruleIndex] = intentRules[ruleIndex].weight;
+    }
+
+    // 正则作用于保留标点的原始输入（如 URL），只对尚未命中的规则求值
+    std::string trimmed = input;
+    trimmed.erase(0, trimmed.find_first_not_of(" \t\r\n"));
+    trimmed.erase(trimmed.find_last_not_of(" \t\r\n") + 1);
+    for (size_t i = 0; i < intentRules.size(); ++i) {
+        if (scores[i] > 0.0) {
+            continue;
+        }
+        for (const auto& pattern : intentRules[i].patterns) {
+            if (std::regex_search(trimmed, pattern)) {
+                scores[i] = intentRules[i].weight;
+                break;
+            }
+        }
+    }
+
+    auto best = std::max_element(scores.begin(), scores.end());
+    if (best == scores.end() || *best <= 0.0) {
+        return nlohmann::json::object();
+    }
+
+    double confidence = *best;
+    size_t matchedIntents = std::count_if(scores.begin(), scores.end(), [](double s) { return s > 0.0; });
+    if (matchedIntents > 1) {
+        confidence *= 0.5;
+    }
+    size_t inputLength = std::count_if(normalized.begin(), normalized.end(),
+                                       [](char c) { return (static_cast<unsigned char>(c) & 0xC0) != 0x80; });
+    if (inputLength > localMaxInputLength) {
+        confidence *= 0.5;
+    }
+
+    const auto& rule = intentRules[std::distance(scores.begin(), best)];
+    DEBUGLOG("Local intent: {} (confidence {:.2f}, {} intents matched)", rule.intent, confidence, matchedIntents);
+    return {
+        {"intent", rule.intent},
+        {"entities", nlohmann::json::array()},
+        {"filters", nlohmann::json::array()},
+        {"query", input},
+        {"source", "local"},
+        {"confidence", confidence}
+    };
+}
+
+/*
+ * Summary: 合并本地与 API 意图解析结果
+ * Parameters:
+ *   const nlohmann::json& localResult - 本地规则解析结果
+ *   const nlohmann::json& apiResult - API 解析结果
+ * Return: nlohmann::json - 合并后的意图解析结果
+ * Description: API 结果优先；API 调用失败或缺少 intent/query 字段时由本地结果补齐
+ */
+nlohmann::json IntentParser::mergeIntentResults(const nlohmann::json& localResult, const nlohmann::json& apiResult) {
+    if (!apiResult.is_object() || apiResult.contains("error")) {
+        WARNLOG("API intent parsing unavailable, falling back to local result");
+        return localResult;
+    }
+
+    nlohmann::json merged = apiResult;
+    if (!merged.contains("intent") || !merged["intent"].is_string() || merged["intent"].get<std::string>().empty()) {
+        merged["intent"] = localResult["intent"];
+    }
+    if (!merged.contains("query") || !merged["query"].is_string() || merged["query"].get<std::string>().empty()) {
+        merged["query"] = localResult["query"];
+    }
+    merged["local_intent"] = localResult["intent"];
+    return merged;
+}
+
+} // namespace IntelliSearch
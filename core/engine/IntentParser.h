@@ -3,36 +3,93 @@
 
 #include <string>
 #include <memory>
+#include <future>
+#include <regex>
+#include <vector>
 #include <nlohmann/json.hpp>
+#include "../api/AIService/AIService.h"
+#include "../api/SearchService/SearchService.h"
 
 namespace IntelliSearch {
 
+class AhoCorasick;
+struct SearchTrace;
+
 class IntentParser {
 public:
     IntentParser();
     ~IntentParser();
 
+    // 以下方法的 cancellation 被取消时中止进行中的请求并抛出 RequestCancelled
+
     // 从搜索栏获取用户输入并解析意图
-    nlohmann::json parseSearchIntent(const std::string& userInput);
+    nlohmann::json parseSearchIntent(const std::string& userInput,
+                                     const std::shared_ptr<CancellationToken>& cancellation = nullptr);
+
+    // 调用博查API进行搜索；onPartial 非空时流式回调答案的增量文本
+    nlohmann::json search(const std::string& query, const StreamCallback& onPartial = nullptr,
+                          const std::shared_ptr<CancellationToken>& cancellation = nullptr,
+                          SearchTrace* trace = nullptr);
+
+    // 意图解析 + 搜索，返回 {"intent_parser": ..., "search_result": ...}；开启推测搜索时两者并行。
+    // trace 非空时记录各阶段耗时与推测、缓存命中情况
+    nlohmann::json parseAndSearch(const std::string& userInput, const StreamCallback& onPartial = nullptr,
+                                  const std::shared_ptr<CancellationToken>& cancellation = nullptr,
+                                  SearchTrace* trace = nullptr);
+
+    // 以原始输入启动推测搜索（请求由 AsyncHttpClient 执行），返回未经 AI 分析的搜索结果
+    std::future<SearchResults> startSpeculativeSearch(const std::string& userInput,
+                                                      const std::shared_ptr<CancellationToken>& cancellation = nullptr);
+
+    // 判断改写后的查询与原始输入是否足够相似，可以直接复用推测搜索结果
+    bool isSpeculationUsable(const std::string& userInput, const std::string& rewrittenQuery) const;
 
-    // 调用博查API进行搜索
-    nlohmann::json search(const std::string& query);
+    // 是否开启推测搜索（search_settings.speculative_search.enabled）
+    bool isSpeculativeSearchEnabled() const { return speculativeSearchEnabled; }
+
+    // 是否流式展示答案（search_settings.stream_answer）
+    bool isStreamAnswerEnabled() const { return streamAnswerEnabled; }
 
 private:
-    // 本地意图解析
+    // 本地规则意图
+    struct IntentRule {
+        std::string intent;
+        double weight;
+        std::vector<std::regex> patterns;
+    };
+
+    // 本地意图解析，未命中任何规则时返回空对象
     nlohmann::json localIntentParsing(const std::string& input);
     
     // 混合意图解析结果
     nlohmann::json mergeIntentResults(const nlohmann::json& localResult, const nlohmann::json& apiResult);
     
-    // 加载意图解析配置
+    // 加载意图解析配置（intent_rules 节与规则文件），构建关键词自动机
     void loadIntentConfig();
 
+    // 定位规则文件：先按原始路径查找，再到配置文件所在目录查找
+    std::string resolveRulesPath(const std::string& rulesPath) const;
+
     // API服务管理器
     class AIServiceManager* aiServiceManager;
     
     // 意图解析配置
     nlohmann::json intentConfig;
+
+    // 本地规则快速路径
+    bool localIntentEnabled;
+    double localConfidenceThreshold;
+    size_t localMaxInputLength;
+    std::vector<IntentRule> intentRules;
+    std::vector<size_t> keywordRuleIndex;   // 关键词编号 -> intentRules 下标
+    std::unique_ptr<AhoCorasick> keywordMatcher;
+
+    // 推测搜索配置
+    bool speculativeSearchEnabled;
+    double speculativeSimilarityThreshold;
+
+    // 流式答案配置
+    bool streamAnswerEnabled;
 };
 
 } // namespace IntelliSearch
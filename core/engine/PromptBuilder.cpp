@@ -0,0 +1,256 @@
+#include "PromptBuilder.h"
+#include "../utils/TextUtils.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <unordered_set>
+#include <vector>
+
+namespace IntelliSearch {
+
+namespace {
+
+const char* const kPromptHeader = "请根据以下搜索结果，对用户查询进行分析和总结：\n\n用户查询：";
+const char* const kResultsHeader = "\n\n搜索结果：\n";
+const char* const kTitleLabel = "- 标题：";
+const char* const kSnippetLabel = "\n  摘要：";
+const char* const kEntryEnd = "\n\n";
+const char* const kTruncationMark = "…";
+
+// 中日韩文字、全角符号等宽字符区间，分词器通常按 1~2 个字符一个 token 处理
+bool isWideCodePoint(uint32_t codePoint) {
+    return codePoint >= 0x2E80;
+}
+
+std::string lowercase(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+TokenEstimate parseEstimate(const nlohmann::json& config, const TokenEstimate& fallback) {
+    TokenEstimate estimate;
+    estimate.cjkCharsPerToken = std::max(0.1, config.value("cjk_chars_per_token", fallback.cjkCharsPerToken));
+    estimate.otherCharsPerToken = std::max(0.1, config.value("other_chars_per_token", fallback.otherCharsPerToken));
+    return estimate;
+}
+
+// 参与排序与组装的候选结果
+struct Candidate {
+    std::string title;
+    std::string snippet;
+    std::unordered_set<uint64_t> snippetBigrams;
+    double relevance;
+    size_t tokens;
+};
+
+} // namespace
+
+/*
+ * Summary: 从配置创建提示组装器
+ * Parameters:
+ *   const nlohmann::json& promptConfig - search_settings.analysis_prompt 配置节
+ * Return: PromptBuilder - 组装器实例
+ * Description: token_estimates 中的 default 作为未配置服务商的估算参数，键名不区分大小写
+ */
+PromptBuilder PromptBuilder::fromConfig(const nlohmann::json& promptConfig) {
+    Options options;
+    options.maxPromptTokens = promptConfig.value("max_prompt_tokens", options.maxPromptTokens);
+    options.maxSnippetTokens = promptConfig.value("max_snippet_tokens", options.maxSnippetTokens);
+    options.snippetSimilarityThreshold =
+        promptConfig.value("snippet_similarity_threshold", options.snippetSimilarityThreshold);
+
+    std::unordered_map<std::string, TokenEstimate> estimates;
+    auto estimateConfig = promptConfig.value("token_estimates", nlohmann::json::object());
+    TokenEstimate fallback = parseEstimate(estimateConfig.value("default", nlohmann::json::object()), TokenEstimate());
+    estimates["default"] = fallback;
+    for (const auto& [provider, config] : estimateConfig.items()) {
+        if (config.is_object()) {
+            estimates[lowercase(provider)] = parseEstimate(config, fallback);
+        }
+    }
+    return PromptBuilder(options, std::move(estimates));
+}
+
+PromptBuilder::PromptBuilder(Options options, std::unordered_map<std::string, TokenEstimate> estimates)
+    : options(options), estimates(std::move(estimates)) {
+    auto it = this->estimates.find("default");
+    if (it != this->estimates.end()) {
+        defaultEstimate = it->second;
+    }
+}
+
+const TokenEstimate& PromptBuilder::estimateFor(const std::string& provider) const {
+    auto it = estimates.find(lowercase(provider));
+    return it != estimates.end() ? it->second : defaultEstimate;
+}
+
+/*
+ * Summary: 估算文本 token 数
+ * Parameters:
+ *   const std::string& text - UTF-8 文本
+ *   const TokenEstimate& estimate - 估算参数
+ * Return: size_t - 向上取整的 token 数
+ */
+size_t PromptBuilder::estimateTokens(const std::string& text, const TokenEstimate& estimate) const {
+    size_t wideChars = 0;
+    size_t otherChars = 0;
+    for (uint32_t codePoint : TextUtils::decodeUtf8(text)) {
+        if (isWideCodePoint(codePoint)) {
+            ++wideChars;
+        } else {
+            ++otherChars;
+        }
+    }
+    return static_cast<size_t>(std::ceil(wideChars / estimate.cjkCharsPerToken +
+                                         otherChars / estimate.otherCharsPerToken));
+}
+
+/*
+ * Summary: 按 token 上限截断文本
+ * Parameters:
+ *   const std::string& text - UTF-8 文本
+ *   size_t maxTokens - token 上限
+ *   const TokenEstimate& estimate - 估算参数
+ * Return: std::string - 未超限时原样返回，否则在码点边界截断并追加省略号
+ */
+std::string PromptBuilder::truncateToTokens(const std::string& text, size_t maxTokens,
+                                            const TokenEstimate& estimate) const {
+    if (estimateTokens(text, estimate) <= maxTokens) {
+        return text;
+    }
+    std::string result;
+    result.reserve(text.size());
+    double budget = static_cast<double>(maxTokens);
+    double used = 0.0;
+    for (uint32_t codePoint : TextUtils::decodeUtf8(text)) {
+        double cost = isWideCodePoint(codePoint) ? 1.0 / estimate.cjkCharsPerToken
+                                                 : 1.0 / estimate.otherCharsPerToken;
+        if (used + cost > budget) {
+            break;
+        }
+        used += cost;
+        TextUtils::appendUtf8(result, codePoint);
+    }
+    result += kTruncationMark;
+    return result;
+}
+
+/*
+ * Summary: 组装搜索结果分析提示
+ * Parameters:
+ *   const std::string& userQuery - 用户查询
+ *   const std::vector<WebPageResult>& webPages - 搜索结果网页列表（按搜索服务返回的排名排列）
+ *   const std::string& provider - 用于分析的 AI 服务名
+ *   PromptBuildStats* stats - 可选，输出组装统计
+ * Return: std::string - 完整提示
+ * Description: 相关度 = 排名得分 1/(rank+1) + 查询二元组在标题与摘要中的覆盖率。
+ *              按相关度依次处理：URL 或摘要与已选结果重复的跳过，过长摘要截断，
+ *              放不进剩余预算的跳过（后面更短的结果仍可能放入）。输出顺序即相关度顺序
+ */
+std::string PromptBuilder::build(const std::string& userQuery, const std::vector<WebPageResult>& webPages,
+                                 const std::string& provider, PromptBuildStats* stats) const {
+    const TokenEstimate& estimate = estimateFor(provider);
+    PromptBuildStats localStats;
+
+    const size_t labelTokens = estimateTokens(std::string(kTitleLabel) + kSnippetLabel + kEntryEnd, estimate);
+    const size_t headerTokens =
+        estimateTokens(std::string(kPromptHeader) + userQuery + kResultsHeader, estimate);
+    size_t remaining = options.maxPromptTokens > headerTokens ? options.maxPromptTokens - headerTokens : 0;
+    localStats.estimatedTokens = headerTokens;
+
+    auto queryBigrams = TextUtils::charBigrams(TextUtils::normalizeQuery(userQuery));
+
+    std::vector<Candidate> candidates;
+    std::unordered_set<std::string> seenUrls;
+    candidates.reserve(webPages.size());
+    for (size_t rank = 0; rank < webPages.size(); ++rank) {
+        const auto& page = webPages[rank];
+        ++localStats.candidatePages;
+
+        if (!page.url.empty() && !seenUrls.insert(TextUtils::normalizeUrl(page.url)).second) {
+            ++localStats.duplicatePages;
+            continue;
+        }
+
+        Candidate candidate;
+        candidate.title = page.title;
+        candidate.snippet = page.snippet;
+        candidate.snippetBigrams = TextUtils::charBigrams(TextUtils::normalizeQuery(candidate.snippet));
+
+        double coverage = 0.0;
+        if (!queryBigrams.empty()) {
+            auto pageBigrams = TextUtils::charBigrams(
+                TextUtils::normalizeQuery(candidate.title + " " + candidate.snippet));
+            size_t covered = 0;
+            for (uint64_t bigram : queryBigrams) {
+                covered += pageBigrams.count(bigram);
+            }
+            coverage = static_cast<double>(covered) / queryBigrams.size();
+        }
+        candidate.relevance = 1.0 / (rank + 1) + coverage;
+        candidates.push_back(std::move(candidate));
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const Candidate& lhs, const Candidate& rhs) { return lhs.relevance > rhs.relevance; });
+
+    std::vector<const Candidate*> selected;
+    for (auto& candidate : candidates) {
+        bool duplicate = false;
+        if (!candidate.snippetBigrams.empty()) {
+            for (const auto* other : selected) {
+                if (TextUtils::jaccardSimilarity(candidate.snippetBigrams, other->snippetBigrams)
+                        >= options.snippetSimilarityThreshold) {
+                    duplicate = true;
+                    break;
+                }
+            }
+        }
+        if (duplicate) {
+            ++localStats.duplicatePages;
+            continue;
+        }
+
+        std::string snippet = truncateToTokens(candidate.snippet, options.maxSnippetTokens, estimate);
+        if (snippet.size() != candidate.snippet.size()) {
+            ++localStats.truncatedSnippets;
+            candidate.snippet = std::move(snippet);
+        }
+        candidate.tokens = labelTokens + estimateTokens(candidate.title, estimate) +
+                           estimateTokens(candidate.snippet, estimate);
+        if (candidate.tokens > remaining) {
+            continue;
+        }
+        remaining -= candidate.tokens;
+        localStats.estimatedTokens += candidate.tokens;
+        selected.push_back(&candidate);
+    }
+    localStats.includedPages = selected.size();
+
+    // 先计算总长度再一次性分配，避免逐段追加时反复扩容
+    const size_t entryOverhead = std::char_traits<char>::length(kTitleLabel) +
+                                 std::char_traits<char>::length(kSnippetLabel) +
+                                 std::char_traits<char>::length(kEntryEnd);
+    size_t totalSize = std::char_traits<char>::length(kPromptHeader) + userQuery.size() +
+                       std::char_traits<char>::length(kResultsHeader);
+    for (const auto* candidate : selected) {
+        totalSize += entryOverhead + candidate->title.size() + candidate->snippet.size();
+    }
+
+    std::string prompt;
+    prompt.reserve(totalSize);
+    prompt.append(kPromptHeader).append(userQuery).append(kResultsHeader);
+    for (const auto* candidate : selected) {
+        prompt.append(kTitleLabel).append(candidate->title)
+              .append(kSnippetLabel).append(candidate->snippet)
+              .append(kEntryEnd);
+    }
+
+    if (stats) {
+        *stats = localStats;
+    }
+    return prompt;
+}
+
+} // namespace IntelliSearch
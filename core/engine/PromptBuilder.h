@@ -0,0 +1,69 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 按 token 预算组装搜索结果分析提示。按服务商估算 token 数，去除重复摘要，
+ *              按相关度依次放入结果直到预算用完，最后一次性预分配并拼接提示字符串
+ */
+
+#ifndef INTELLISEARCH_PROMPTBUILDER_H
+#define INTELLISEARCH_PROMPTBUILDER_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "../api/SearchService/SearchService.h"
+
+namespace IntelliSearch {
+
+// token 估算参数：每个 token 平均对应的字符数，中日韩字符与其他字符分别统计
+struct TokenEstimate {
+    double cjkCharsPerToken = 1.0;
+    double otherCharsPerToken = 4.0;
+};
+
+// 单次组装的统计信息，便于调整预算
+struct PromptBuildStats {
+    size_t candidatePages = 0;
+    size_t includedPages = 0;
+    size_t duplicatePages = 0;    // 因 URL 或摘要重复被跳过
+    size_t truncatedSnippets = 0; // 超过单条上限被截断的摘要
+    size_t estimatedTokens = 0;
+};
+
+class PromptBuilder {
+public:
+    struct Options {
+        size_t maxPromptTokens = 3000;
+        size_t maxSnippetTokens = 300;
+        double snippetSimilarityThreshold = 0.8;
+    };
+
+    // 从 search_settings.analysis_prompt 读取预算与各服务商的 token 估算参数
+    static PromptBuilder fromConfig(const nlohmann::json& promptConfig);
+
+    PromptBuilder(Options options, std::unordered_map<std::string, TokenEstimate> estimates);
+
+    // 组装分析提示；provider 为 AI 服务名（不区分大小写），未配置时使用 default 估算参数
+    std::string build(const std::string& userQuery, const std::vector<WebPageResult>& webPages,
+                      const std::string& provider, PromptBuildStats* stats = nullptr) const;
+
+    // 估算文本的 token 数
+    size_t estimateTokens(const std::string& text, const TokenEstimate& estimate) const;
+
+private:
+    const TokenEstimate& estimateFor(const std::string& provider) const;
+
+    // 在码点边界处截断文本，使估算 token 数不超过 maxTokens
+    std::string truncateToTokens(const std::string& text, size_t maxTokens, const TokenEstimate& estimate) const;
+
+    Options options;
+    std::unordered_map<std::string, TokenEstimate> estimates;
+    TokenEstimate defaultEstimate;
+};
+
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_PROMPTBUILDER_H
@@ -1,110 +1,321 @@
 #include "SearchEngine.h"
 #include "../../log/Logger.h"
-#include "../api/SearchService/Bocha.h"
 #include "../api/SearchServiceManager.h"
 #include "../api/AIServiceManager.h"
+#include "../utils/JsonFieldStreamer.h"
+#include "../utils/TextUtils.h"
+#include "../../config/ConfigManager.h"
+#include <thread>
 
 namespace IntelliSearch {
 
+namespace {
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
 std::unique_ptr<SearchEngine> SearchEngine::instance = nullptr;
+std::mutex SearchEngine::instanceMutex;
 
 SearchEngine* SearchEngine::getInstance() {
+    // 批量压测工具会在多个工作线程中同时获取实例，这里需要加锁
+    std::lock_guard<std::mutex> lock(instanceMutex);
     if (!instance) {
         instance = std::unique_ptr<SearchEngine>(new SearchEngine());
     }
     return instance.get();
 }
 
-SearchEngine::SearchEngine() {
+SearchEngine::SearchEngine()
+    : promptBuilder(PromptBuilder::fromConfig(ConfigManager::getInstance()->getSectionConfig("search_settings")
+                                                  .value("analysis_prompt", nlohmann::json::object()))) {
     // 获取服务管理器实例
     searchServiceManager = SearchServiceManager::getInstance();
     aiServiceManager = AIServiceManager::getInstance();
+
+    // 读取结果缓存配置
+    auto cacheConfig = ConfigManager::getInstance()->getSectionConfig("search_settings")
+                           .value("result_cache", nlohmann::json::object());
+    if (cacheConfig.value("enabled", false)) {
+        resultCache = std::make_unique<SearchResultCache>(
+            cacheConfig.value("capacity", 1024),
+            cacheConfig.value("shards", 8),
+            std::chrono::seconds(cacheConfig.value("ttl_s", 600)),
+            std::chrono::seconds(cacheConfig.value("stale_ttl_s", 3600)));
+        maxPendingRefreshes = cacheConfig.value("max_pending_refreshes", static_cast<size_t>(64));
+        refreshCancellation = std::make_shared<CancellationToken>();
+        refreshThread = std::thread(&SearchEngine::runRefreshWorker, this);
+        INFOLOG("Search result cache enabled, capacity: {}", cacheConfig.value("capacity", 1024));
+    }
 }
 
-SearchEngine::~SearchEngine() = default;
+SearchEngine::~SearchEngine() {
+    {
+        std::lock_guard<std::mutex> lock(refreshMutex);
+        stoppingRefresh = true;
+        refreshQueue.clear();
+    }
+    // 中止进行中的搜索与分析请求，刷新线程随即退出
+    if (refreshCancellation) {
+        refreshCancellation->cancel();
+    }
+    refreshCondition.notify_all();
+    if (refreshThread.joinable()) {
+        refreshThread.join();
+    }
+}
 
-nlohmann::json SearchEngine::performSearch(const std::string& intentResult) {
+nlohmann::json SearchEngine::performSearch(const std::string& intentResult, const StreamCallback& onPartial,
+                                           const std::shared_ptr<CancellationToken>& cancellation,
+                                           SearchTrace* trace) {
     try {
-        INFOLOG("Performing search for intentResult: {}", intentResult);     
-        // 使用选定的服务执行搜索
-        nlohmann::json searchResults = searchServiceManager->performSearch(intentResult);
-        
-        // 创建 Bocha 实例并处理搜索结果
-        Bocha bochaService;
-        SearchResults processedResults = bochaService.processSearchResults(searchResults);
-        
-        // 将处理后的结果转换为 JSON 格式
-        nlohmann::json response = {
-            {"webPages", nlohmann::json::array()},
-            {"images", nlohmann::json::array()},
-            {"hasFilteredResults", processedResults.hasFilteredResults}
-        };
-
-        // 添加网页结果
-        for (const auto& page : processedResults.webPages) {
-            response["webPages"].push_back({
-                {"title", page.title},
-                {"url", page.url},
-                {"snippet", page.snippet},
-                {"siteName", page.siteName},
-                {"date", page.date}
-            });
+        INFOLOG("Performing search for intentResult: {}", intentResult);
+
+        bool skipAnalysis = trace && trace->skipAnalysis;
+        nlohmann::json cachedAnswer;
+        if (!skipAnalysis && lookupCachedAnswer(intentResult, cachedAnswer)) {
+            if (trace) {
+                trace->cacheHit = true;
+            }
+            return cachedAnswer;
         }
 
-        // 添加图片结果
-        for (const auto& img : processedResults.images) {
-            response["images"].push_back({
-                {"thumbnailUrl", img.thumbnailUrl},
-                {"contentUrl", img.contentUrl}
-            });
+        auto searchStart = std::chrono::steady_clock::now();
+        SearchResults searchResults = fetchSearchResults(intentResult, cancellation);
+        if (trace) {
+            trace->searchMs = elapsedMs(searchStart);
+        }
+        if (skipAnalysis) {
+            return nlohmann::json::object();
         }
 
+        auto analysisStart = std::chrono::steady_clock::now();
+        auto answer = summarizeSearchResults(searchResults, intentResult, onPartial, cancellation);
+        if (trace) {
+            trace->analysisMs = elapsedMs(analysisStart);
+        }
+        return answer;
+    } catch (const RequestCancelled&) {
+        throw;
+    } catch (const std::exception& e) {
+        ERRORLOG("Search failed: {}", e.what());
+        return nlohmann::json{{"error", e.what()}};
+    }
+}
+
+/*
+ * Summary: 对已获取的搜索结果进行 AI 分析并返回最终答案
+ * Parameters:
+ *   const SearchResults& searchResults - fetchSearchResults 返回的搜索结果
+ *   const std::string& query - 用于分析的查询字符串
+ *   const StreamCallback& onPartial - 可选，流式接收答案的增量文本
+ *   const std::shared_ptr<CancellationToken>& cancellation - 可选，取消时抛出 RequestCancelled
+ * Return: nlohmann::json - 分析结果中的 result 字段，失败时返回 {"error": ...}
+ * Description: 推测搜索复用已完成的搜索结果时直接调用此方法，跳过重复搜索；
+ *              分析成功时将答案写入结果缓存
+ */
+nlohmann::json SearchEngine::summarizeSearchResults(const SearchResults& searchResults, const std::string& query,
+                                                    const StreamCallback& onPartial,
+                                                    const std::shared_ptr<CancellationToken>& cancellation) {
+    try {
         // 调用AI服务进行分析总结
-        nlohmann::json analysis = analyzeSearchResults(response, intentResult);
-        response["analysis"] = analysis;
+        nlohmann::json analysis = analyzeSearchResults(searchResults, query, onPartial, cancellation);
+        if (analysis.contains("error")) {
+            return analysis;
+        }
 
-        INFOLOG("Search completed successfully, resonse : {}" , response.dump() );
+        INFOLOG("Search completed successfully: {} web pages, {} images",
+                searchResults.webPages.size(), searchResults.images.size());
 
-        return response["analysis"]["result"];
-        
+        if (resultCache && analysis.contains("result")) {
+            resultCache->put(makeCacheKey(query), analysis["result"]);
+        }
+
+        return std::move(analysis["result"]);
+
+    } catch (const RequestCancelled&) {
+        throw;
     } catch (const std::exception& e) {
         ERRORLOG("Search failed: {}", e.what());
         return nlohmann::json{{"error", e.what()}};
     }
 }
 
-nlohmann::json SearchEngine::analyzeSearchResults(const nlohmann::json& searchResults, const std::string& userQuery) {
-    try {
-        INFOLOG("Analyzing search results for query: {}", userQuery);
+/*
+ * Summary: 执行网页搜索并返回结构化结果（不包含 AI 分析）
+ * Parameters:
+ *   const std::string& query - 搜索查询字符串
+ * Return: SearchResults - 网页与图片结果
+ * Description: 供 performSearch 与批量压测工具分阶段计时使用，失败时抛出异常；
+ *              服务商响应直接解码为结构体，开启 search_settings.fan_out 时并发查询所有搜索服务并合并去重
+ */
+SearchResults SearchEngine::fetchSearchResults(const std::string& query,
+                                               const std::shared_ptr<CancellationToken>& cancellation) {
+    if (searchServiceManager->isFanOutEnabled()) {
+        // 并发查询所有搜索服务并按加权得分合并
+        return searchServiceManager->performFanOutSearch(query, cancellation);
+    }
+    return searchServiceManager->fetchResults(query, cancellation);
+}
 
-        // 构建提示信息
-        std::string prompt = "请根据以下搜索结果，对用户查询进行分析和总结：\n\n";
-        prompt += "用户查询：" + userQuery + "\n\n";
-        prompt += "搜索结果：\n";
+std::future<SearchResults> SearchEngine::fetchSearchResultsAsync(const std::string& query,
+                                                                const std::shared_ptr<CancellationToken>& cancellation) {
+    try {
+        return searchServiceManager->fetchResultsAsync(query, cancellation);
+    } catch (...) {
+        // 没有可用服务等提交前的错误同样经由 future 交给调用方
+        std::promise<SearchResults> failed;
+        failed.set_exception(std::current_exception());
+        return failed.get_future();
+    }
+}
 
-        // 添加网页结果到提示信息
-        if (searchResults.contains("webPages") && !searchResults["webPages"].empty()) {
-            for (const auto& page : searchResults["webPages"]) {
-                prompt += "- 标题：" + page["title"].get<std::string>() + "\n";
-                prompt += "  摘要：" + page["snippet"].get<std::string>() + "\n\n";
-            }
+nlohmann::json SearchEngine::analyzeSearchResults(const SearchResults& searchResults, const std::string& userQuery,
+                                                  const StreamCallback& onPartial,
+                                                  const std::shared_ptr<CancellationToken>& cancellation) {
+    try {
+        // 搜索阶段结束后已被取消时不再发起分析请求
+        if (cancellation) {
+            cancellation->throwIfCancelled("Analysis");
         }
 
+        INFOLOG("Analyzing search results for query: {}", userQuery);
+
         // 获取AI服务并进行分析
-        AIService* aiService = aiServiceManager->getPreferredService();
+        AIService* aiService = aiServiceManager->getPreferredService(LlmCallKind::Analysis);
         if (!aiService) {
             throw std::runtime_error("No available AI service");
         }
 
-        // 调用AI服务进行分析
-        nlohmann::json analysis = aiService->searchParser(prompt);
+        // 按该服务的 token 估算参数在预算内组装提示
+        PromptBuildStats promptStats;
+        std::string prompt = promptBuilder.build(userQuery, searchResults.webPages,
+                                                 aiService->getServiceName(), &promptStats);
+        DEBUGLOG("Analysis prompt: {}/{} pages, {} duplicates, {} truncated, ~{} tokens",
+                 promptStats.includedPages, promptStats.candidatePages, promptStats.duplicatePages,
+                 promptStats.truncatedSnippets, promptStats.estimatedTokens);
+
+        // 流式模式下模型逐段输出 JSON，从中提取 result 字段的增量文本回调给调用方
+        ApiCallOptions options;
+        options.cancellation = cancellation;
+        if (onPartial) {
+            auto streamer = std::make_shared<JsonFieldStreamer>("result");
+            options.onToken = [streamer, onPartial](const std::string& delta) {
+                std::string text = streamer->feed(delta);
+                if (!text.empty()) {
+                    onPartial(text);
+                }
+            };
+        }
+
+        // 调用AI服务进行分析，开启 hedging 时由 AIServiceManager 在主服务过慢时请求备用服务商
+        nlohmann::json analysis = aiServiceManager->searchParser(aiService, prompt, options);
         
         return analysis;
 
+    } catch (const RequestCancelled&) {
+        throw;
     } catch (const std::exception& e) {
         ERRORLOG("Analysis failed: {}", e.what());
         return nlohmann::json{{"error", e.what()}};
     }
 }
 
+std::string SearchEngine::makeCacheKey(const std::string& query) const {
+    std::string provider = "fan_out";
+    std::string freshness;
+    if (!searchServiceManager->isFanOutEnabled()) {
+        SearchService* searchService = searchServiceManager->getActiveService();
+        if (searchService) {
+            provider = searchService->getServiceName();
+            freshness = searchService->getFreshness();
+        }
+    }
+    return TextUtils::normalizeQuery(query) + '\x1f' + provider + '\x1f' + freshness;
+}
+
+/*
+ * Summary: 查找缓存的最终答案
+ * Parameters:
+ *   const std::string& query - 搜索查询字符串
+ *   nlohmann::json& answer - 命中时写入缓存的答案
+ * Return: bool - 是否命中（包括过期但仍可用的条目）
+ * Description: 过期条目立即返回旧值，同时交给刷新线程重新搜索并刷新缓存，同一键同时只有一个刷新任务
+ */
+bool SearchEngine::lookupCachedAnswer(const std::string& query, nlohmann::json& answer) {
+    if (!resultCache) {
+        return false;
+    }
+
+    std::string key = makeCacheKey(query);
+    auto lookup = resultCache->get(key);
+    if (lookup.freshness == SearchResultCache::Freshness::Miss) {
+        return false;
+    }
+
+    if (lookup.shouldRefresh) {
+        INFOLOG("Serving stale cached answer and refreshing in background: {}", query);
+        scheduleRefresh(query, key);
+    } else {
+        DEBUGLOG("Search result cache hit: {}", query);
+    }
+    answer = std::move(lookup.value);
+    return true;
+}
+
+bool SearchEngine::scheduleRefresh(const std::string& query, const std::string& key) {
+    {
+        std::lock_guard<std::mutex> lock(refreshMutex);
+        if (!stoppingRefresh && refreshQueue.size() < maxPendingRefreshes) {
+            refreshQueue.push_back({query, key});
+            refreshCondition.notify_one();
+            return true;
+        }
+    }
+    // 清除刷新标记，下次命中时再尝试
+    WARNLOG("Cache refresh queue is full, skipping refresh for {}", query);
+    resultCache->abandonRefresh(key);
+    return false;
+}
+
+void SearchEngine::runRefreshWorker() {
+    std::unique_lock<std::mutex> lock(refreshMutex);
+    while (true) {
+        refreshCondition.wait(lock, [this]() { return stoppingRefresh || !refreshQueue.empty(); });
+        if (stoppingRefresh) {
+            return;
+        }
+        RefreshTask task = std::move(refreshQueue.front());
+        refreshQueue.pop_front();
+        lock.unlock();
+        refreshCachedAnswer(task.query, task.key, refreshCancellation);
+        lock.lock();
+    }
+}
+
+void SearchEngine::refreshCachedAnswer(const std::string& query, const std::string& key,
+                                       const std::shared_ptr<CancellationToken>& cancellation) {
+    try {
+        // summarizeSearchResults 成功时会写回缓存并清除刷新标记
+        auto answer = summarizeSearchResults(fetchSearchResults(query, cancellation), query, nullptr, cancellation);
+        bool failed = answer.is_null() || (answer.is_object() && answer.contains("error"));
+        if (!failed) {
+            return;
+        }
+        WARNLOG("Background cache refresh failed for {}: {}", query, answer.dump());
+    } catch (const RequestCancelled&) {
+        DEBUGLOG("Background cache refresh cancelled for {}", query);
+    } catch (const std::exception& e) {
+        WARNLOG("Background cache refresh failed for {}: {}", query, e.what());
+    }
+    resultCache->abandonRefresh(key);
+}
+
+SearchCacheStats SearchEngine::getCacheStats() const {
+    return resultCache ? resultCache->getStats() : SearchCacheStats();
+}
+
 } // namespace IntelliSearch 
\ No newline at end of file
@@ -2,26 +2,100 @@
 
 #include <string>
 #include <memory>
+#include <mutex>
+#include <future>
+#include <condition_variable>
+#include <deque>
+#include <thread>
 #include <nlohmann/json.hpp>
 #include "../api/SearchServiceManager.h"
 #include "../api/AIServiceManager.h"
+#include "SearchResultCache.h"
+#include "PromptBuilder.h"
 
 namespace IntelliSearch {
 
+// 一次搜索流程的选项与分阶段记录（耗时单位：毫秒），供批量压测工具统计
+struct SearchTrace {
+    bool skipAnalysis = false;   // 只执行意图解析与网页搜索，不查结果缓存也不做 AI 分析
+    double intentMs = 0.0;       // 意图解析
+    double searchMs = 0.0;       // 意图解析完成后等待网页搜索的时间，推测搜索命中时只含剩余等待
+    double analysisMs = 0.0;     // AI 分析
+    bool speculativeHit = false; // 复用了推测搜索的结果
+    bool cacheHit = false;       // 结果缓存命中，跳过搜索与分析
+};
+
 class SearchEngine {
 public:
     static SearchEngine* getInstance();
-    nlohmann::json performSearch(const std::string& intentResult);
-    nlohmann::json analyzeSearchResults(const nlohmann::json& searchResults, const std::string& userQuery);
+    // onPartial 非空时以流式方式调用 AI 服务，并逐段回调答案（result 字段）的新增文本；
+    // cancellation 被取消时中止进行中的请求并抛出 RequestCancelled，其余错误以 {"error": ...} 返回；
+    // trace 非空时记录各阶段耗时，其 skipAnalysis 为 true 时搜索完成即返回空对象
+    nlohmann::json performSearch(const std::string& intentResult, const StreamCallback& onPartial = nullptr,
+                                 const std::shared_ptr<CancellationToken>& cancellation = nullptr,
+                                 SearchTrace* trace = nullptr);
+    SearchResults fetchSearchResults(const std::string& query,
+                                     const std::shared_ptr<CancellationToken>& cancellation = nullptr);
+    // 发起网页搜索后立即返回，请求由 AsyncHttpClient 执行，不占用调用线程；失败时 get() 抛出异常
+    std::future<SearchResults> fetchSearchResultsAsync(const std::string& query,
+                                                       const std::shared_ptr<CancellationToken>& cancellation = nullptr);
+    nlohmann::json summarizeSearchResults(const SearchResults& searchResults, const std::string& query,
+                                          const StreamCallback& onPartial = nullptr,
+                                          const std::shared_ptr<CancellationToken>& cancellation = nullptr);
+    nlohmann::json analyzeSearchResults(const SearchResults& searchResults, const std::string& userQuery,
+                                        const StreamCallback& onPartial = nullptr,
+                                        const std::shared_ptr<CancellationToken>& cancellation = nullptr);
+
+    // 查找缓存的最终答案；命中过期条目时返回旧值并在后台刷新，未命中或未开启缓存时返回 false
+    bool lookupCachedAnswer(const std::string& query, nlohmann::json& answer);
+
+    // 结果缓存统计（search_settings.result_cache）
+    SearchCacheStats getCacheStats() const;
+    bool isCacheEnabled() const { return resultCache != nullptr; }
+
     ~SearchEngine();
 
 private:
     SearchEngine();
-    
+
+    // 缓存键：归一化查询 + 搜索服务 + 时间范围
+    std::string makeCacheKey(const std::string& query) const;
+
+    // 后台重新搜索并分析，结果写回缓存
+    void refreshCachedAnswer(const std::string& query, const std::string& key,
+                             const std::shared_ptr<CancellationToken>& cancellation);
+
+    // 排队一个刷新任务，队列已满时放弃本次刷新并返回 false
+    bool scheduleRefresh(const std::string& query, const std::string& key);
+
+    // 刷新线程：依次执行排队的刷新任务，直到析构时停止
+    void runRefreshWorker();
+
+    struct RefreshTask {
+        std::string query;
+        std::string key;
+    };
+
     SearchServiceManager* searchServiceManager;
     AIServiceManager* aiServiceManager;
-    
+
+    // 结果缓存，未开启时为空
+    std::unique_ptr<SearchResultCache> resultCache;
+
+    // 分析提示组装器（search_settings.analysis_prompt）
+    PromptBuilder promptBuilder;
+
+    // 过期条目的后台刷新只在一个线程中执行，排队数有上限；析构时取消进行中的刷新并等待线程退出
+    std::mutex refreshMutex;
+    std::condition_variable refreshCondition;
+    std::deque<RefreshTask> refreshQueue;
+    size_t maxPendingRefreshes = 64;
+    bool stoppingRefresh = false;
+    std::shared_ptr<CancellationToken> refreshCancellation;   // 所有刷新任务共用，析构时取消
+    std::thread refreshThread;
+
     static std::unique_ptr<SearchEngine> instance;
+    static std::mutex instanceMutex;
 };
 
 } // namespace IntelliSearch 
\ No newline at end of file
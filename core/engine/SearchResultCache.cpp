@@ -0,0 +1,115 @@
+#include "SearchResultCache.h"
+#include <algorithm>
+#include <functional>
+
+namespace IntelliSearch {
+
+/*
+ * Summary: SearchResultCache构造函数
+ * Parameters:
+ *   size_t capacity - 总容量（条目数），平均分配到各分片
+ *   size_t shardCount - 分片数，降低并发查询之间的锁竞争
+ *   std::chrono::milliseconds ttl - 条目的新鲜期
+ *   std::chrono::milliseconds staleTtl - 新鲜期之后仍可提供旧值的时长
+ */
+SearchResultCache::SearchResultCache(size_t capacity, size_t shardCount,
+                                     std::chrono::milliseconds ttl, std::chrono::milliseconds staleTtl)
+    : ttl(ttl), staleTtl(staleTtl) {
+    shardCount = std::max<size_t>(shardCount, 1);
+    shardCapacity = std::max<size_t>((capacity + shardCount - 1) / shardCount, 1);
+    shards.reserve(shardCount);
+    for (size_t i = 0; i < shardCount; ++i) {
+        shards.push_back(std::make_unique<Shard>());
+    }
+}
+
+SearchResultCache::Shard& SearchResultCache::shardFor(const std::string& key) {
+    return *shards[std::hash<std::string>{}(key) % shards.size()];
+}
+
+SearchResultCache::Lookup SearchResultCache::get(const std::string& key) {
+    Lookup lookup;
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        ++misses;
+        return lookup;
+    }
+
+    auto entry = it->second;
+    auto age = Clock::now() - entry->storedAt;
+    if (age >= ttl + staleTtl) {
+        shard.entries.erase(entry);
+        shard.index.erase(it);
+        ++misses;
+        return lookup;
+    }
+
+    // 移到链表头部
+    shard.entries.splice(shard.entries.begin(), shard.entries, entry);
+    lookup.value = entry->value;
+    if (age < ttl) {
+        lookup.freshness = Freshness::Fresh;
+        ++hits;
+    } else {
+        lookup.freshness = Freshness::Stale;
+        ++staleHits;
+        if (!entry->refreshing) {
+            entry->refreshing = true;
+            lookup.shouldRefresh = true;
+            ++refreshes;
+        }
+    }
+    return lookup;
+}
+
+void SearchResultCache::put(const std::string& key, nlohmann::json value) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        auto entry = it->second;
+        entry->value = std::move(value);
+        entry->storedAt = Clock::now();
+        entry->refreshing = false;
+        shard.entries.splice(shard.entries.begin(), shard.entries, entry);
+        return;
+    }
+
+    shard.entries.push_front(Entry{key, std::move(value), Clock::now(), false});
+    shard.index.emplace(key, shard.entries.begin());
+
+    while (shard.entries.size() > shardCapacity) {
+        shard.index.erase(shard.entries.back().key);
+        shard.entries.pop_back();
+        ++evictions;
+    }
+}
+
+void SearchResultCache::abandonRefresh(const std::string& key) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        it->second->refreshing = false;
+    }
+}
+
+SearchCacheStats SearchResultCache::getStats() const {
+    SearchCacheStats stats;
+    stats.hits = hits.load();
+    stats.staleHits = staleHits.load();
+    stats.misses = misses.load();
+    stats.evictions = evictions.load();
+    stats.refreshes = refreshes.load();
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        stats.size += shard->entries.size();
+    }
+    return stats;
+}
+
+} // namespace IntelliSearch
@@ -0,0 +1,92 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 分片 LRU 搜索结果缓存，支持 TTL 与过期后继续提供旧值（stale-while-revalidate）
+ */
+
+#ifndef INTELLISEARCH_SEARCHRESULTCACHE_H
+#define INTELLISEARCH_SEARCHRESULTCACHE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace IntelliSearch {
+
+// 缓存命中统计，用于评估容量与 TTL 配置
+struct SearchCacheStats {
+    uint64_t hits = 0;        // 新鲜命中
+    uint64_t staleHits = 0;   // 过期但仍在可用期内的命中（同时触发后台刷新）
+    uint64_t misses = 0;
+    uint64_t evictions = 0;   // 因容量淘汰的条目数
+    uint64_t refreshes = 0;   // 触发的后台刷新次数
+    size_t size = 0;
+};
+
+class SearchResultCache {
+public:
+    enum class Freshness { Fresh, Stale, Miss };
+
+    struct Lookup {
+        Freshness freshness = Freshness::Miss;
+        nlohmann::json value;
+        bool shouldRefresh = false;  // 调用方需要发起后台刷新（同一键只会返回一次 true）
+    };
+
+    // ttl 与 staleTtl 配置以秒为单位，按毫秒保存以便测试使用较短的时长
+    SearchResultCache(size_t capacity, size_t shardCount,
+                      std::chrono::milliseconds ttl, std::chrono::milliseconds staleTtl);
+
+    // 查找缓存；条目超过 ttl + staleTtl 时视为未命中并删除
+    Lookup get(const std::string& key);
+
+    // 写入或更新条目，并清除刷新标记
+    void put(const std::string& key, nlohmann::json value);
+
+    // 后台刷新失败时清除刷新标记，允许下次命中时重试
+    void abandonRefresh(const std::string& key);
+
+    SearchCacheStats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::string key;
+        nlohmann::json value;
+        Clock::time_point storedAt;
+        bool refreshing = false;
+    };
+
+    // 每个分片独立加锁，list 头部为最近使用的条目
+    struct Shard {
+        std::mutex mutex;
+        std::list<Entry> entries;
+        std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    };
+
+    Shard& shardFor(const std::string& key);
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t shardCapacity;
+    std::chrono::milliseconds ttl;
+    std::chrono::milliseconds staleTtl;
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> staleHits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> evictions{0};
+    std::atomic<uint64_t> refreshes{0};
+};
+
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_SEARCHRESULTCACHE_H
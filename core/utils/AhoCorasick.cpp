@@ -0,0 +1,86 @@
+#include "AhoCorasick.h"
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+
+namespace IntelliSearch {
+
+size_t AhoCorasick::addPattern(const std::string& pattern) {
+    if (built) {
+        throw std::logic_error("AhoCorasick: addPattern called after build");
+    }
+
+    int32_t state = 0;
+    for (unsigned char c : pattern) {
+        if (nodes[state].next[c] < 0) {
+            nodes[state].next[c] = static_cast<int32_t>(nodes.size());
+            nodes.emplace_back();
+        }
+        state = nodes[state].next[c];
+    }
+
+    size_t id = patternLengths.size();
+    patternLengths.push_back(pattern.size());
+    if (!pattern.empty()) {
+        nodes[state].outputs.push_back(id);
+    }
+    return id;
+}
+
+/*
+ * Summary: 构建自动机
+ * Description: 按层序计算失败指针，并把缺失的转移补全为失败指针的转移，
+ *              匹配时每个字节只需一次查表
+ */
+void AhoCorasick::build() {
+    std::queue<int32_t> queue;
+    for (int c = 0; c < 256; ++c) {
+        int32_t child = nodes[0].next[c];
+        if (child < 0) {
+            nodes[0].next[c] = 0;
+        } else {
+            nodes[child].fail = 0;
+            queue.push(child);
+        }
+    }
+
+    while (!queue.empty()) {
+        int32_t state = queue.front();
+        queue.pop();
+
+        int32_t fail = nodes[state].fail;
+        nodes[state].outputLink = nodes[fail].outputs.empty() ? nodes[fail].outputLink : fail;
+
+        for (int c = 0; c < 256; ++c) {
+            int32_t child = nodes[state].next[c];
+            if (child < 0) {
+                nodes[state].next[c] = nodes[fail].next[c];
+            } else {
+                nodes[child].fail = nodes[fail].next[c];
+                queue.push(child);
+            }
+        }
+    }
+    built = true;
+}
+
+std::vector<AhoCorasick::Match> AhoCorasick::findAll(const std::string& text) const {
+    if (!built) {
+        throw std::logic_error("AhoCorasick: findAll called before build");
+    }
+
+    std::vector<Match> matches;
+    int32_t state = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        state = nodes[state].next[static_cast<unsigned char>(text[i])];
+        for (int32_t node = nodes[state].outputs.empty() ? nodes[state].outputLink : state;
+             node > 0; node = nodes[node].outputLink) {
+            for (size_t id : nodes[node].outputs) {
+                matches.push_back({id, i + 1});
+            }
+        }
+    }
+    return matches;
+}
+
+} // namespace IntelliSearch
@@ -0,0 +1,57 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 基于字节的 Aho-Corasick 多模式匹配自动机，一次扫描找出文本中出现的所有关键词。
+ *              关键词与文本均按 UTF-8 字节处理，中文关键词无需额外分词
+ */
+
+#ifndef INTELLISEARCH_AHOCORASICK_H
+#define INTELLISEARCH_AHOCORASICK_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace IntelliSearch {
+
+class AhoCorasick {
+public:
+    // 单次匹配结果：关键词编号（addPattern 的返回值）与匹配结束位置（不含）
+    struct Match {
+        size_t patternId;
+        size_t end;
+    };
+
+    // 添加关键词，返回其编号；必须在 build 之前调用
+    size_t addPattern(const std::string& pattern);
+
+    // 构建失败指针与完整的状态转移表
+    void build();
+
+    // 扫描文本并返回所有匹配（包括相互重叠的关键词）
+    std::vector<Match> findAll(const std::string& text) const;
+
+    size_t patternCount() const { return patternLengths.size(); }
+    size_t patternLength(size_t patternId) const { return patternLengths[patternId]; }
+
+private:
+    struct Node {
+        int32_t next[256];
+        int32_t fail = 0;
+        int32_t outputLink = -1;         // 失败链上最近的、有输出的节点
+        std::vector<size_t> outputs;     // 在此节点结束的关键词
+
+        Node() { std::fill(std::begin(next), std::end(next), -1); }
+    };
+
+    std::vector<Node> nodes{1};
+    std::vector<size_t> patternLengths;
+    bool built = false;
+};
+
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_AHOCORASICK_H
@@ -0,0 +1,168 @@
+#include "JsonFieldStreamer.h"
+#include "TextUtils.h"
+
+namespace IntelliSearch {
+
+namespace {
+
+constexpr uint32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+// 十六进制字符的值，非十六进制字符返回 -1
+int hexValue(unsigned char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+} // namespace
+
+JsonFieldStreamer::JsonFieldStreamer(std::string fieldName) : fieldName(std::move(fieldName)) {}
+
+void JsonFieldStreamer::appendDecoded(std::string& out, uint32_t codePoint) {
+    if (capturing) {
+        TextUtils::appendUtf8(out, codePoint);
+    } else if (stringIsKey) {
+        TextUtils::appendUtf8(keyBuffer, codePoint);
+    }
+}
+
+void JsonFieldStreamer::flushHighSurrogate(std::string& out) {
+    if (highSurrogate) {
+        appendDecoded(out, REPLACEMENT_CHARACTER);
+        highSurrogate = 0;
+    }
+}
+
+void JsonFieldStreamer::appendUnicodeEscape(std::string& out, uint32_t value) {
+    if (value >= 0xD800 && value <= 0xDBFF) {
+        flushHighSurrogate(out);
+        highSurrogate = value;
+    } else if (value >= 0xDC00 && value <= 0xDFFF) {
+        if (highSurrogate) {
+            appendDecoded(out, 0x10000 + ((highSurrogate - 0xD800) << 10) + (value - 0xDC00));
+            highSurrogate = 0;
+        } else {
+            appendDecoded(out, REPLACEMENT_CHARACTER);
+        }
+    } else {
+        flushHighSurrogate(out);
+        appendDecoded(out, value);
+    }
+}
+
+std::string JsonFieldStreamer::feed(const std::string& chunk) {
+    std::string out;
+    if (completed) {
+        return out;
+    }
+
+    for (char ch : chunk) {
+        auto c = static_cast<unsigned char>(ch);
+
+        if (inString) {
+            if (unicodeDigits > 0) {
+                // 读取 \uXXXX 的十六进制位
+                int digit = hexValue(c);
+                if (digit >= 0) {
+                    unicodeValue = (unicodeValue << 4) | static_cast<uint32_t>(digit);
+                    if (--unicodeDigits == 0) {
+                        appendUnicodeEscape(out, unicodeValue);
+                    }
+                    continue;
+                }
+                // 不完整的 \u 转义以 U+FFFD 代替，当前字符按普通字符处理（可能是结束引号）
+                unicodeDigits = 0;
+                flushHighSurrogate(out);
+                appendDecoded(out, REPLACEMENT_CHARACTER);
+            } else if (escapePending) {
+                escapePending = false;
+                if (c == 'u') {
+                    unicodeDigits = 4;
+                    unicodeValue = 0;
+                    continue;
+                }
+                flushHighSurrogate(out);
+                bool known = true;
+                switch (c) {
+                    case 'n': appendDecoded(out, '\n'); break;
+                    case 't': appendDecoded(out, '\t'); break;
+                    case 'r': appendDecoded(out, '\r'); break;
+                    case 'b': appendDecoded(out, '\b'); break;
+                    case 'f': appendDecoded(out, '\f'); break;
+                    case '"':
+                    case '\\':
+                    case '/': appendDecoded(out, c); break;
+                    default: known = false; break;
+                }
+                if (known) {
+                    continue;
+                }
+                // 未知的转义以 U+FFFD 代替反斜杠，当前字符按普通字符处理，多字节字符不被拆开
+                appendDecoded(out, REPLACEMENT_CHARACTER);
+            }
+
+            if (c == '\\') {
+                // 高代理项之后可能紧跟低代理项的转义，暂不输出
+                escapePending = true;
+                continue;
+            }
+            flushHighSurrogate(out);
+            if (c == '"') {
+                inString = false;
+                if (stringIsKey) {
+                    lastKey = keyBuffer;
+                } else if (capturing) {
+                    capturing = false;
+                    completed = true;
+                    return out;
+                }
+            } else if (capturing) {
+                out += ch;  // UTF-8 多字节按原样透传
+            } else if (stringIsKey) {
+                keyBuffer += ch;
+            }
+            continue;
+        }
+
+        switch (c) {
+            case '{':
+            case '[':
+                containers.push_back(static_cast<char>(c));
+                expectKey = (c == '{');
+                break;
+            case '}':
+            case ']':
+                if (!containers.empty()) {
+                    containers.pop_back();
+                }
+                expectKey = false;
+                break;
+            case ':':
+                expectKey = false;
+                break;
+            case ',':
+                expectKey = !containers.empty() && containers.back() == '{';
+                break;
+            case '"': {
+                bool inObject = !containers.empty() && containers.back() == '{';
+                inString = true;
+                stringIsKey = inObject && expectKey;
+                capturing = !stringIsKey && inObject && containers.size() == 1 && lastKey == fieldName;
+                keyBuffer.clear();
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return out;
+}
+
+} // namespace IntelliSearch
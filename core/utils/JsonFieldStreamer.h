@@ -0,0 +1,56 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 从流式输出的 JSON 文本中增量提取顶层字符串字段的值，
+ *              用于在模型逐段返回 JSON 时实时展示其中的答案字段
+ */
+
+#ifndef INTELLISEARCH_JSONFIELDSTREAMER_H
+#define INTELLISEARCH_JSONFIELDSTREAMER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace IntelliSearch {
+
+class JsonFieldStreamer {
+public:
+    explicit JsonFieldStreamer(std::string fieldName);
+
+    // 输入一段增量 JSON 文本，返回本段新解码出的目标字段内容（已处理转义）。
+    // 非法的转义（未知转义字符、\u 后的非十六进制字符、不成对的代理项）输出 U+FFFD
+    std::string feed(const std::string& chunk);
+
+    // 目标字段是否已经完整输出
+    bool isCompleted() const { return completed; }
+
+private:
+    // 将一个解码后的字符写入当前字符串的目标位置
+    void appendDecoded(std::string& out, uint32_t codePoint);
+
+    // 等待低代理项的高代理项后面不是 \uDC00..\uDFFF 时，以 U+FFFD 代替
+    void flushHighSurrogate(std::string& out);
+
+    // 处理一个完整的 \uXXXX
+    void appendUnicodeEscape(std::string& out, uint32_t value);
+
+    std::string fieldName;
+    std::vector<char> containers;  // 嵌套的容器类型栈（'{' 或 '['）
+    bool expectKey = false;        // 当前对象中下一个字符串是否为键
+    bool inString = false;
+    bool stringIsKey = false;
+    bool capturing = false;        // 是否正在输出目标字段的值
+    bool completed = false;
+    bool escapePending = false;
+    int unicodeDigits = 0;         // \uXXXX 尚未读取的十六进制位数
+    uint32_t unicodeValue = 0;
+    uint32_t highSurrogate = 0;
+    std::string keyBuffer;
+    std::string lastKey;
+};
+
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_JSONFIELDSTREAMER_H
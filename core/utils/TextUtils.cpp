@@ -0,0 +1,242 @@
+#include "TextUtils.h"
+#include <cctype>
+
+namespace IntelliSearch {
+namespace TextUtils {
+
+namespace {
+
+// 判断码点是否作为分隔符处理（空白与常见中英文标点）
+bool isSeparator(uint32_t cp) {
+    if (cp <= 0x20) {
+        return true;
+    }
+    if (cp < 0x80) {
+        return !((cp >= '0' && cp <= '9') || (cp >= 'a' && cp <= 'z') || (cp >= 'A' && cp <= 'Z'));
+    }
+    // 通用标点、CJK 符号和标点、全角标点
+    return (cp >= 0x2000 && cp <= 0x206F) ||
+           (cp >= 0x3000 && cp <= 0x303F) ||
+           (cp >= 0xFE30 && cp <= 0xFE4F) ||
+           (cp >= 0xFF01 && cp <= 0xFF0F) ||
+           (cp >= 0xFF1A && cp <= 0xFF20) ||
+           (cp >= 0xFF3B && cp <= 0xFF40) ||
+           (cp >= 0xFF5B && cp <= 0xFF65);
+}
+
+} // namespace
+
+std::vector<uint32_t> decodeUtf8(const std::string& text) {
+    std::vector<uint32_t> codePoints;
+    codePoints.reserve(text.size());
+
+    const auto* bytes = reinterpret_cast<const unsigned char*>(text.data());
+    size_t len = text.size();
+    size_t i = 0;
+    while (i < len) {
+        unsigned char c = bytes[i];
+        uint32_t cp = c;
+        size_t extra = 0;
+        if (c >= 0xF0 && c <= 0xF4) {
+            cp = c & 0x07;
+            extra = 3;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            cp = c & 0x0F;
+            extra = 2;
+        } else if (c >= 0xC2 && c <= 0xDF) {
+            cp = c & 0x1F;
+            extra = 1;
+        }
+
+        if (extra == 0 || i + extra >= len) {
+            codePoints.push_back(c);
+            ++i;
+            continue;
+        }
+
+        // 第二个字节的范围排除过长编码（E0、F0）、代理区（ED）与超过 U+10FFFF 的码点（F4）
+        unsigned char lower = 0x80;
+        unsigned char upper = 0xBF;
+        if (c == 0xE0) {
+            lower = 0xA0;
+        } else if (c == 0xED) {
+            upper = 0x9F;
+        } else if (c == 0xF0) {
+            lower = 0x90;
+        } else if (c == 0xF4) {
+            upper = 0x8F;
+        }
+        bool valid = bytes[i + 1] >= lower && bytes[i + 1] <= upper;
+        for (size_t k = 1; valid && k <= extra; ++k) {
+            if ((bytes[i + k] & 0xC0) != 0x80) {
+                valid = false;
+                break;
+            }
+            cp = (cp << 6) | (bytes[i + k] & 0x3F);
+        }
+
+        if (!valid) {
+            codePoints.push_back(c);
+            ++i;
+            continue;
+        }
+
+        codePoints.push_back(cp);
+        i += extra + 1;
+    }
+    return codePoints;
+}
+
+void appendUtf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+std::string normalizeQuery(const std::string& text) {
+    std::string result;
+    result.reserve(text.size());
+    bool pendingSpace = false;
+
+    for (uint32_t cp : decodeUtf8(text)) {
+        // 全角 ASCII 转半角
+        if (cp >= 0xFF01 && cp <= 0xFF5E) {
+            cp -= 0xFEE0;
+        }
+        if (isSeparator(cp)) {
+            pendingSpace = !result.empty();
+            continue;
+        }
+        if (cp >= 'A' && cp <= 'Z') {
+            cp += 'a' - 'A';
+        }
+        if (pendingSpace) {
+            result += ' ';
+            pendingSpace = false;
+        }
+        appendUtf8(result, cp);
+    }
+    return result;
+}
+
+std::unordered_set<uint64_t> charBigrams(const std::string& normalizedText) {
+    std::vector<uint32_t> codePoints;
+    for (uint32_t cp : decodeUtf8(normalizedText)) {
+        if (cp != ' ') {
+            codePoints.push_back(cp);
+        }
+    }
+
+    std::unordered_set<uint64_t> bigrams;
+    if (codePoints.size() == 1) {
+        bigrams.insert(codePoints[0]);
+        return bigrams;
+    }
+    bigrams.reserve(codePoints.size());
+    for (size_t i = 0; i + 1 < codePoints.size(); ++i) {
+        bigrams.insert((static_cast<uint64_t>(codePoints[i]) << 32) | codePoints[i + 1]);
+    }
+    return bigrams;
+}
+
+double jaccardSimilarity(const std::unordered_set<uint64_t>& lhs, const std::unordered_set<uint64_t>& rhs) {
+    if (lhs.empty() && rhs.empty()) {
+        return 1.0;
+    }
+
+    const auto& smaller = lhs.size() < rhs.size() ? lhs : rhs;
+    const auto& larger = lhs.size() < rhs.size() ? rhs : lhs;
+    size_t intersection = 0;
+    for (uint64_t bigram : smaller) {
+        if (larger.count(bigram)) {
+            ++intersection;
+        }
+    }
+    size_t unionSize = lhs.size() + rhs.size() - intersection;
+    return static_cast<double>(intersection) / static_cast<double>(unionSize);
+}
+
+double bigramSimilarity(const std::string& lhs, const std::string& rhs) {
+    return jaccardSimilarity(charBigrams(normalizeQuery(lhs)), charBigrams(normalizeQuery(rhs)));
+}
+
+uint64_t simHash(const std::string& normalizedText) {
+    auto bigrams = charBigrams(normalizedText);
+    if (bigrams.empty()) {
+        return 0;
+    }
+
+    int weights[64] = {0};
+    for (uint64_t bigram : bigrams) {
+        // splitmix64 打散二元组，使各位近似独立
+        uint64_t hash = bigram + 0x9E3779B97F4A7C15ULL;
+        hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+        hash ^= hash >> 31;
+        for (int bit = 0; bit < 64; ++bit) {
+            weights[bit] += (hash >> bit) & 1 ? 1 : -1;
+        }
+    }
+
+    uint64_t fingerprint = 0;
+    for (int bit = 0; bit < 64; ++bit) {
+        if (weights[bit] > 0) {
+            fingerprint |= 1ULL << bit;
+        }
+    }
+    return fingerprint;
+}
+
+int hammingDistance(uint64_t lhs, uint64_t rhs) {
+    uint64_t diff = lhs ^ rhs;
+    int count = 0;
+    while (diff) {
+        diff &= diff - 1;
+        ++count;
+    }
+    return count;
+}
+
+std::string normalizeUrl(const std::string& url) {
+    std::string result = url;
+
+    size_t fragment = result.find('#');
+    if (fragment != std::string::npos) {
+        result.erase(fragment);
+    }
+
+    size_t scheme = result.find("://");
+    if (scheme != std::string::npos) {
+        result.erase(0, scheme + 3);
+    }
+
+    // 主机名大小写不敏感，路径保持原样
+    size_t pathStart = result.find_first_of("/?");
+    size_t hostEnd = pathStart == std::string::npos ? result.size() : pathStart;
+    for (size_t i = 0; i < hostEnd; ++i) {
+        result[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(result[i])));
+    }
+    if (result.compare(0, 4, "www.") == 0) {
+        result.erase(0, 4);
+    }
+
+    while (!result.empty() && result.back() == '/') {
+        result.pop_back();
+    }
+    return result;
+}
+
+} // namespace TextUtils
+} // namespace IntelliSearch
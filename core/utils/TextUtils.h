@@ -0,0 +1,51 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 文本处理工具函数，提供查询归一化和基于字符二元组的相似度计算，
+ *              供意图解析、搜索缓存等模块判断查询是否等价，以及结果合并时的 URL 归一化
+ */
+
+#ifndef INTELLISEARCH_TEXTUTILS_H
+#define INTELLISEARCH_TEXTUTILS_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace IntelliSearch {
+namespace TextUtils {
+
+// 将 UTF-8 字符串解码为 Unicode 码点序列；截断、过长编码、代理区与超出范围的序列不解码，
+// 其前导字节按原值（Latin-1 字符）保留，结果再经 appendUtf8 编码总是合法的 UTF-8
+std::vector<uint32_t> decodeUtf8(const std::string& text);
+
+// 将 Unicode 码点追加编码为 UTF-8
+void appendUtf8(std::string& out, uint32_t codePoint);
+
+// 归一化查询：ASCII 转小写、全角转半角、标点视为空白、合并连续空白并去除首尾空白
+std::string normalizeQuery(const std::string& text);
+
+// 提取归一化文本的字符二元组集合（忽略空白，单字符文本返回该字符本身）
+std::unordered_set<uint64_t> charBigrams(const std::string& normalizedText);
+
+// 计算两个二元组集合的 Jaccard 相似度，取值 [0, 1]；两者都为空时返回 1
+double jaccardSimilarity(const std::unordered_set<uint64_t>& lhs, const std::unordered_set<uint64_t>& rhs);
+
+// 计算两个字符串归一化后字符二元组的 Jaccard 相似度，取值 [0, 1]
+double bigramSimilarity(const std::string& lhs, const std::string& rhs);
+
+// 计算归一化文本的 64 位 SimHash 指纹（特征为字符二元组），相近文本的指纹汉明距离较小
+uint64_t simHash(const std::string& normalizedText);
+
+// 两个指纹的汉明距离
+int hammingDistance(uint64_t lhs, uint64_t rhs);
+
+// 归一化 URL 用于去重：去除协议、www. 前缀、片段和末尾斜杠，主机名转小写
+std::string normalizeUrl(const std::string& url);
+
+} // namespace TextUtils
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_TEXTUTILS_H
@@ -0,0 +1,397 @@
+#include "Utf8.h"
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define INTELLISEARCH_UTF8_X86 1
+#include <immintrin.h>
+#endif
+
+namespace IntelliSearch {
+namespace Utf8 {
+
+namespace {
+
+constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+
+// 把单个 Latin-1 字节写入 out，返回写入后的位置
+inline char* appendLatin1(char* out, unsigned char c) {
+    if (c < 0x80) {
+        *out++ = static_cast<char>(c);
+    } else {
+        *out++ = static_cast<char>(0xC0 | (c >> 6));
+        *out++ = static_cast<char>(0x80 | (c & 0x3F));
+    }
+    return out;
+}
+
+#ifdef INTELLISEARCH_UTF8_X86
+
+/*
+ * 向量化校验采用查表法（Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte"）：
+ * 用前一字节的高/低 4 位与当前字节的高 4 位各查一张 16 项表，三者按位与后非零即为非法的相邻字节组合；
+ * 再用前 2、3 个字节判断当前字节是否必须是三/四字节序列的后续字节。纯 ASCII 块只需检查上一块是否以未完成的序列结尾
+ */
+constexpr uint8_t kTooShort = 1 << 0;      // 前导字节后跟 ASCII 或另一个前导字节
+constexpr uint8_t kTooLong = 1 << 1;       // ASCII 后跟后续字节
+constexpr uint8_t kOverlong3 = 1 << 2;     // 11100000 100_____
+constexpr uint8_t kTooLarge = 1 << 3;      // 11110100 1001____ 及更大
+constexpr uint8_t kSurrogate = 1 << 4;     // 11101101 101_____
+constexpr uint8_t kOverlong2 = 1 << 5;     // 1100000_ 10______
+constexpr uint8_t kTooLarge1000 = 1 << 6;  // 11110101 1000____ 及更大
+constexpr uint8_t kOverlong4 = 1 << 6;     // 11110000 1000____
+constexpr uint8_t kTwoConts = 1 << 7;      // 两个连续的后续字节（三/四字节序列中是合法的）
+constexpr uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+#define UTF8_BYTE1_HIGH_TABLE \
+    kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, \
+    kTwoConts, kTwoConts, kTwoConts, kTwoConts, \
+    kTooShort | kOverlong2, \
+    kTooShort, \
+    kTooShort | kOverlong3 | kSurrogate, \
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4
+
+#define UTF8_BYTE1_LOW_TABLE \
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4, \
+    kCarry | kOverlong2, \
+    kCarry, \
+    kCarry, \
+    kCarry | kTooLarge, \
+    kCarry | kTooLarge | kTooLarge1000, \
+    kCarry | kTooLarge | kTooLarge1000, \
+    kCarry | kTooLarge | kTooLarge1000, \
+    kCarry | kTooLarge | kTooLarge1000, \
+    kCarry | kTooLarge | kTooLarge1000, \
+    kCarry | kTooLarge | kTooLarge1000, \
+    kCarry | kTooLarge | kTooLarge1000, \
+    kCarry | kTooLarge | kTooLarge1000, \
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate, \
+    kCarry | kTooLarge | kTooLarge1000, \
+    kCarry | kTooLarge | kTooLarge1000
+
+#define UTF8_BYTE2_HIGH_TABLE \
+    kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, \
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4, \
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge, \
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge, \
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge, \
+    kTooShort, kTooShort, kTooShort, kTooShort
+
+// 块末尾可能未完成的前导字节阈值：倒数第 3/2/1 个字节分别不能 >= 0xF0/0xE0/0xC0
+#define UTF8_INCOMPLETE_TAIL 0xEF, 0xDF, 0xBF
+
+// ---------------------------------------------------------------- SSSE3（16 字节）
+
+#define SSSE3_TARGET __attribute__((target("ssse3")))
+
+template <int N>
+SSSE3_TARGET inline __m128i prev16(__m128i input, __m128i prevInput) {
+    return _mm_alignr_epi8(input, prevInput, 16 - N);
+}
+
+SSSE3_TARGET inline __m128i lookup16(__m128i table, __m128i nibbles) {
+    return _mm_shuffle_epi8(table, nibbles);
+}
+
+SSSE3_TARGET inline __m128i checkBlock16(__m128i input, __m128i prevInput) {
+    const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+    const __m128i byte1HighTable = _mm_setr_epi8(UTF8_BYTE1_HIGH_TABLE);
+    const __m128i byte1LowTable = _mm_setr_epi8(UTF8_BYTE1_LOW_TABLE);
+    const __m128i byte2HighTable = _mm_setr_epi8(UTF8_BYTE2_HIGH_TABLE);
+
+    __m128i prev1 = prev16<1>(input, prevInput);
+    __m128i byte1High = lookup16(byte1HighTable, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibbleMask));
+    __m128i byte1Low = lookup16(byte1LowTable, _mm_and_si128(prev1, nibbleMask));
+    __m128i byte2High = lookup16(byte2HighTable, _mm_and_si128(_mm_srli_epi16(input, 4), nibbleMask));
+    __m128i specialCases = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+
+    __m128i isThirdByte = _mm_subs_epu8(prev16<2>(input, prevInput), _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+    __m128i isFourthByte = _mm_subs_epu8(prev16<3>(input, prevInput), _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+    __m128i mustBeContinuation = _mm_and_si128(_mm_or_si128(isThirdByte, isFourthByte),
+                                               _mm_set1_epi8(static_cast<char>(0x80)));
+    return _mm_xor_si128(mustBeContinuation, specialCases);
+}
+
+SSSE3_TARGET inline __m128i incompleteTail16(__m128i input) {
+    const __m128i maxValue = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                           static_cast<char>(0xEF), static_cast<char>(0xDF), static_cast<char>(0xBF));
+    return _mm_subs_epu8(input, maxValue);
+}
+
+SSSE3_TARGET bool isValidSsse3(const char* data, size_t length) {
+    __m128i error = _mm_setzero_si128();
+    __m128i prevInput = _mm_setzero_si128();
+    __m128i prevIncomplete = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        if (_mm_movemask_epi8(input) == 0) {
+            error = _mm_or_si128(error, prevIncomplete);
+        } else {
+            error = _mm_or_si128(error, checkBlock16(input, prevInput));
+            prevIncomplete = incompleteTail16(input);
+        }
+        prevInput = input;
+    }
+    if (i < length) {
+        // 尾部补零（按 ASCII 处理），截断的多字节序列会被识别为 TOO_SHORT
+        alignas(16) char tail[16] = {};
+        std::memcpy(tail, data + i, length - i);
+        __m128i input = _mm_load_si128(reinterpret_cast<const __m128i*>(tail));
+        error = _mm_or_si128(error, checkBlock16(input, prevInput));
+        prevIncomplete = incompleteTail16(input);
+    }
+    error = _mm_or_si128(error, prevIncomplete);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+}
+
+SSSE3_TARGET std::string latin1ToUtf8Ssse3(const std::string& text) {
+    std::string result(text.size() * 2, '\0');
+    const char* in = text.data();
+    char* out = &result[0];
+    size_t length = text.size();
+
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        int mask = _mm_movemask_epi8(input);
+        if (mask == 0) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), input);
+            out += 16;
+            continue;
+        }
+        for (size_t k = 0; k < 16; ++k) {
+            out = appendLatin1(out, static_cast<unsigned char>(in[i + k]));
+        }
+    }
+    for (; i < length; ++i) {
+        out = appendLatin1(out, static_cast<unsigned char>(in[i]));
+    }
+    result.resize(out - result.data());
+    return result;
+}
+
+// ---------------------------------------------------------------- AVX2（32 字节）
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+template <int N>
+AVX2_TARGET inline __m256i prev32(__m256i input, __m256i prevInput) {
+    // 拼出 [prevInput 高 128 位, input 低 128 位]，再在每个 128 位通道内错位
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prevInput, input, 0x21), 16 - N);
+}
+
+AVX2_TARGET inline __m256i checkBlock32(__m256i input, __m256i prevInput) {
+    const __m256i nibbleMask = _mm256_set1_epi8(0x0F);
+    const __m256i byte1HighTable = _mm256_setr_epi8(UTF8_BYTE1_HIGH_TABLE, UTF8_BYTE1_HIGH_TABLE);
+    const __m256i byte1LowTable = _mm256_setr_epi8(UTF8_BYTE1_LOW_TABLE, UTF8_BYTE1_LOW_TABLE);
+    const __m256i byte2HighTable = _mm256_setr_epi8(UTF8_BYTE2_HIGH_TABLE, UTF8_BYTE2_HIGH_TABLE);
+
+    __m256i prev1 = prev32<1>(input, prevInput);
+    __m256i byte1High = _mm256_shuffle_epi8(byte1HighTable,
+                                            _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibbleMask));
+    __m256i byte1Low = _mm256_shuffle_epi8(byte1LowTable, _mm256_and_si256(prev1, nibbleMask));
+    __m256i byte2High = _mm256_shuffle_epi8(byte2HighTable,
+                                            _mm256_and_si256(_mm256_srli_epi16(input, 4), nibbleMask));
+    __m256i specialCases = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+    __m256i isThirdByte = _mm256_subs_epu8(prev32<2>(input, prevInput),
+                                           _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+    __m256i isFourthByte = _mm256_subs_epu8(prev32<3>(input, prevInput),
+                                            _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+    __m256i mustBeContinuation = _mm256_and_si256(_mm256_or_si256(isThirdByte, isFourthByte),
+                                                  _mm256_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_xor_si256(mustBeContinuation, specialCases);
+}
+
+AVX2_TARGET inline __m256i incompleteTail32(__m256i input) {
+    const __m256i maxValue = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                              -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                              static_cast<char>(0xEF), static_cast<char>(0xDF),
+                                              static_cast<char>(0xBF));
+    return _mm256_subs_epu8(input, maxValue);
+}
+
+AVX2_TARGET bool isValidAvx2(const char* data, size_t length) {
+    __m256i error = _mm256_setzero_si256();
+    __m256i prevInput = _mm256_setzero_si256();
+    __m256i prevIncomplete = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        if (_mm256_movemask_epi8(input) == 0) {
+            error = _mm256_or_si256(error, prevIncomplete);
+        } else {
+            error = _mm256_or_si256(error, checkBlock32(input, prevInput));
+            prevIncomplete = incompleteTail32(input);
+        }
+        prevInput = input;
+    }
+    if (i < length) {
+        alignas(32) char tail[32] = {};
+        std::memcpy(tail, data + i, length - i);
+        __m256i input = _mm256_load_si256(reinterpret_cast<const __m256i*>(tail));
+        error = _mm256_or_si256(error, checkBlock32(input, prevInput));
+        prevIncomplete = incompleteTail32(input);
+    }
+    error = _mm256_or_si256(error, prevIncomplete);
+    return _mm256_testz_si256(error, error) != 0;
+}
+
+AVX2_TARGET std::string latin1ToUtf8Avx2(const std::string& text) {
+    std::string result(text.size() * 2, '\0');
+    const char* in = text.data();
+    char* out = &result[0];
+    size_t length = text.size();
+
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        if (_mm256_movemask_epi8(input) == 0) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), input);
+            out += 32;
+            continue;
+        }
+        for (size_t k = 0; k < 32; ++k) {
+            out = appendLatin1(out, static_cast<unsigned char>(in[i + k]));
+        }
+    }
+    for (; i < length; ++i) {
+        out = appendLatin1(out, static_cast<unsigned char>(in[i]));
+    }
+    result.resize(out - result.data());
+    return result;
+}
+
+#endif // INTELLISEARCH_UTF8_X86
+
+// 运行时选定的实现，首次调用时按 CPU 特性确定
+struct Implementation {
+    bool (*isValid)(const char*, size_t);
+    std::string (*latin1ToUtf8)(const std::string&);
+    const char* name;
+};
+
+Implementation selectImplementation() {
+#ifdef INTELLISEARCH_UTF8_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {isValidAvx2, latin1ToUtf8Avx2, "avx2"};
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        return {isValidSsse3, latin1ToUtf8Ssse3, "ssse3"};
+    }
+#endif
+    return {isValidScalar, latin1ToUtf8Scalar, "scalar"};
+}
+
+const Implementation& implementation() {
+    static const Implementation selected = selectImplementation();
+    return selected;
+}
+
+// 短于一个向量宽度的输入直接走标量实现，省去尾部补齐的开销
+constexpr size_t kSimdMinLength = 32;
+
+} // namespace
+
+/*
+ * Summary: 标量 UTF-8 严格校验
+ * Parameters:
+ *   const char* data - 数据起始地址
+ *   size_t length - 字节数
+ * Return: bool - 是否为合法 UTF-8
+ * Description: 每次先以 8 字节为单位跳过 ASCII，遇到多字节序列时按 RFC 3629 的首字节范围
+ *              限定第二字节取值，排除过长编码、代理区与超过 U+10FFFF 的码点
+ */
+bool isValidScalar(const char* data, size_t length) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+    size_t i = 0;
+    while (i < length) {
+        if (i + 8 <= length) {
+            uint64_t word;
+            std::memcpy(&word, bytes + i, sizeof(word));
+            if ((word & kHighBits) == 0) {
+                i += 8;
+                continue;
+            }
+        }
+
+        unsigned char lead = bytes[i];
+        if (lead < 0x80) {
+            ++i;
+            continue;
+        }
+
+        size_t continuationCount;
+        unsigned char secondMin = 0x80;
+        unsigned char secondMax = 0xBF;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            continuationCount = 1;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            continuationCount = 2;
+            if (lead == 0xE0) secondMin = 0xA0;        // 过长编码
+            else if (lead == 0xED) secondMax = 0x9F;   // 代理区 U+D800..U+DFFF
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            continuationCount = 3;
+            if (lead == 0xF0) secondMin = 0x90;        // 过长编码
+            else if (lead == 0xF4) secondMax = 0x8F;   // 超过 U+10FFFF
+        } else {
+            return false;
+        }
+
+        if (length - i <= continuationCount) {
+            return false;
+        }
+        if (bytes[i + 1] < secondMin || bytes[i + 1] > secondMax) {
+            return false;
+        }
+        for (size_t k = 2; k <= continuationCount; ++k) {
+            if ((bytes[i + k] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        i += continuationCount + 1;
+    }
+    return true;
+}
+
+/*
+ * Summary: 标量 Latin-1 -> UTF-8 转码
+ * Parameters:
+ *   const std::string& text - Latin-1 字节串
+ * Return: std::string - UTF-8 字符串
+ * Description: 按最坏情况（每字节两字节）一次性分配输出，写完后截断到实际长度
+ */
+std::string latin1ToUtf8Scalar(const std::string& text) {
+    std::string result(text.size() * 2, '\0');
+    char* out = &result[0];
+    for (unsigned char c : text) {
+        out = appendLatin1(out, c);
+    }
+    result.resize(out - result.data());
+    return result;
+}
+
+bool isValid(const char* data, size_t length) {
+    if (length < kSimdMinLength) {
+        return isValidScalar(data, length);
+    }
+    return implementation().isValid(data, length);
+}
+
+std::string latin1ToUtf8(const std::string& text) {
+    if (text.size() < kSimdMinLength) {
+        return latin1ToUtf8Scalar(text);
+    }
+    return implementation().latin1ToUtf8(text);
+}
+
+const char* activeImplementation() {
+    return implementation().name;
+}
+
+} // namespace Utf8
+} // namespace IntelliSearch
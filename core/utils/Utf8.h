@@ -0,0 +1,36 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: UTF-8 校验与 Latin-1 -> UTF-8 转码。x86 平台运行时按 CPU 支持选择 AVX2 / SSSE3 实现，
+ *              其他平台使用标量实现；各实现结果完全一致，均按 RFC 3629 严格校验
+ *              （拒绝过长编码、代理区码点与超过 U+10FFFF 的码点）
+ */
+
+#ifndef INTELLISEARCH_UTF8_H
+#define INTELLISEARCH_UTF8_H
+
+#include <cstddef>
+#include <string>
+
+namespace IntelliSearch {
+namespace Utf8 {
+
+// 判断数据是否为合法 UTF-8
+bool isValid(const char* data, size_t length);
+inline bool isValid(const std::string& text) { return isValid(text.data(), text.size()); }
+
+// 将 Latin-1 字节串转码为 UTF-8（0x80 及以上的字节编码为两个字节）
+std::string latin1ToUtf8(const std::string& text);
+
+// 标量实现，供不支持 SIMD 的平台使用，也用于基准测试对比
+bool isValidScalar(const char* data, size_t length);
+std::string latin1ToUtf8Scalar(const std::string& text);
+
+// 当前使用的实现名称："avx2"、"ssse3" 或 "scalar"
+const char* activeImplementation();
+
+} // namespace Utf8
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_UTF8_H
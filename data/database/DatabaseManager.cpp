@@ -2,7 +2,17 @@
 #include <QDir>
 #include <QStandardPaths>
 #include "../../log/Logger.h"
+#include "../../config/ConfigManager.h"
+#include "HistoryTokenizer.h"
+#include "PayloadCodec.h"
 #include <QUuid>
+#include <QStringList>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <set>
+#include <vector>
+#include <nlohmann/json.hpp>
 
 namespace IntelliSearch {
 
@@ -43,6 +53,7 @@ SQLiteDatabaseManager::SQLiteDatabaseManager(QObject* parent) : QObject(parent)
 
 SQLiteDatabaseManager::~SQLiteDatabaseManager() {
     QString connectionName = db.connectionName();
+    statementCache.clear(); // 预编译语句需先于连接释放
     if (db.isOpen()) {
         db.close();
     }
@@ -51,6 +62,42 @@ SQLiteDatabaseManager::~SQLiteDatabaseManager() {
     DEBUGLOG("Database connection {} closed and removed", connectionName.toStdString());
 }
 
+namespace {
+
+// 单个版本的结构迁移，按顺序执行其中的语句，再执行 populate 填充数据
+struct SchemaMigration {
+    int version;
+    const char* description;
+    QStringList statements;
+    std::function<bool()> populate = nullptr;
+    // 可选迁移失败时不影响使用，仍记录版本号以继续后续迁移；present 返回 false 时每次启动重试
+    bool optional = false;
+    std::function<bool()> present = nullptr;
+};
+
+// 搜索结果中不参与全文检索的字段
+const std::set<std::string> UNINDEXED_RESULT_KEYS = {"url", "link", "icon", "siteIcon", "favicon", "image", "thumbnail", "id"};
+
+// 收集 JSON 中的全部字符串值，跳过链接、图标等字段
+void collectText(const nlohmann::json& value, std::string& out) {
+    if (value.is_string()) {
+        out += value.get<std::string>();
+        out.push_back('\n');
+    } else if (value.is_object()) {
+        for (const auto& [key, child] : value.items()) {
+            if (!UNINDEXED_RESULT_KEYS.count(key)) {
+                collectText(child, out);
+            }
+        }
+    } else if (value.is_array()) {
+        for (const auto& child : value) {
+            collectText(child, out);
+        }
+    }
+}
+
+} // namespace
+
 bool SQLiteDatabaseManager::initialize() {
     // 1. 首先确保数据库连接是打开的
     if (!db.isOpen() && !db.open()) {
@@ -58,33 +105,85 @@ bool SQLiteDatabaseManager::initialize() {
         return false;
     }
 
-    // 2. 开始事务
-    if (!db.transaction()) {
-        ERRORLOG("Failed to start transaction: {}", db.lastError().text().toStdString());
+    // 2. 连接级参数需在事务外设置
+    applyPragmas();
+    rankHistoryByRelevance = ConfigManager::getInstance()->getSectionConfig("database")
+                                 .value("history_search", nlohmann::json::object())
+                                 .value("rank_by_relevance", false);
+
+    // 3. 压缩配置需在迁移前就绪，迁移 4 据此压缩已有记录
+    auto compressionConfig = ConfigManager::getInstance()->getSectionConfig("database")
+                                 .value("payload_compression", nlohmann::json::object());
+    compressPayloads = compressionConfig.value("enabled", true);
+    minCompressedSize = compressionConfig.value("min_size_bytes", static_cast<size_t>(128));
+    dictionaryCapacity = compressionConfig.value("dictionary_size_kb", static_cast<size_t>(64)) * 1024;
+    nextDictionaryTraining = compressionConfig.value("train_after_records", 200);
+    payloadCodec = std::make_unique<PayloadCodec>(compressionConfig.value("level", 3));
+
+    // 4. 执行结构迁移
+    if (!migrate()) {
         return false;
     }
+    loadDictionaries();
 
-    try {
-        // 3. 创建会话表
-        QSqlQuery query(db);  // 使用当前数据库连接
-        bool success = query.exec(
+    INFOLOG("Database tables initialized successfully");
+    return true;
+}
+
+/*
+ * Summary: 设置连接参数
+ * Description: WAL 模式下读不阻塞写，synchronous=NORMAL 时提交只写 WAL 不再每次 fsync 主库；
+ *              mmap 与页缓存让历史查询直接命中内存。设置失败只记录警告，不影响使用
+ */
+void SQLiteDatabaseManager::applyPragmas() {
+    auto dbConfig = ConfigManager::getInstance()->getSectionConfig("database");
+    QString journalMode = QString::fromStdString(dbConfig.value("journal_mode", std::string("WAL")));
+    QString synchronous = QString::fromStdString(dbConfig.value("synchronous", std::string("NORMAL")));
+    qint64 mmapBytes = dbConfig.value("mmap_size_mb", 256LL) * 1024 * 1024;
+    qint64 cacheKb = dbConfig.value("cache_size_mb", 16LL) * 1024;
+    int busyTimeoutMs = dbConfig.value("busy_timeout_ms", 5000);
+
+    const QStringList pragmas = {
+        "PRAGMA journal_mode = " + journalMode,
+        "PRAGMA synchronous = " + synchronous,
+        "PRAGMA mmap_size = " + QString::number(mmapBytes),
+        "PRAGMA cache_size = -" + QString::number(cacheKb),  // 负值单位为 KiB
+        "PRAGMA temp_store = MEMORY",
+        "PRAGMA busy_timeout = " + QString::number(busyTimeoutMs)
+    };
+
+    QSqlQuery query(db);
+    for (const QString& pragma : pragmas) {
+        if (!query.exec(pragma)) {
+            WARNLOG("Failed to apply {}: {}", pragma.toStdString(), query.lastError().text().toStdString());
+        }
+    }
+
+    if (query.exec("PRAGMA journal_mode") && query.next()) {
+        INFOLOG("Database journal mode: {}", query.value(0).toString().toStdString());
+    }
+}
+
+/*
+ * Summary: 执行结构迁移
+ * Return: bool - 全部迁移成功时返回 true
+ * Description: 版本 1 为原有的会话表与对话记录表（IF NOT EXISTS，兼容未记录版本号的旧库）；
+ *              版本 2 为对话记录的 (session_id, turn_number) 索引与会话的 last_updated 索引，
+ *              使单个会话的历史与会话列表不再全表扫描；
+ *              版本 3 为对话历史的 FTS5 全文索引并索引已有记录，SQLite 不支持 FTS5 时跳过；
+ *              版本 4 为压缩词典表，并以训练出的词典压缩已有记录的 search_result 与 intent_result；
+ *              版本 5 在会话表上维护对话数与最后一条查询，供会话列表分页读取
+ */
+bool SQLiteDatabaseManager::migrate() {
+    const std::vector<SchemaMigration> migrations = {
+        {1, "create sessions and dialogue records", {
             "CREATE TABLE IF NOT EXISTS " + SESSIONS_TABLE + " ("
             "session_id TEXT PRIMARY KEY,"
             "created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
             "last_updated DATETIME DEFAULT CURRENT_TIMESTAMP,"
             "title TEXT,"
             "status TEXT DEFAULT 'active'"
-            ")"
-        );
-
-        if (!success) {
-            ERRORLOG("Failed to create sessions table: {}", query.lastError().text().toStdString());
-            db.rollback();
-            return false;
-        }
-
-        // 4. 创建对话记录表
-        success = query.exec(
+            ")",
             "CREATE TABLE IF NOT EXISTS " + DIALOGUES_TABLE + " ("
             "id INTEGER PRIMARY KEY AUTOINCREMENT,"
             "session_id TEXT NOT NULL,"
@@ -96,29 +195,385 @@ bool SQLiteDatabaseManager::initialize() {
             "timestamp DATETIME DEFAULT CURRENT_TIMESTAMP,"
             "FOREIGN KEY(session_id) REFERENCES " + SESSIONS_TABLE + "(session_id)"
             ")"
-        );
+        }},
+        {2, "index dialogue records by session and sessions by last update", {
+            "CREATE INDEX IF NOT EXISTS idx_" + DIALOGUES_TABLE + "_session_turn ON "
+                + DIALOGUES_TABLE + " (session_id, turn_number)",
+            "CREATE INDEX IF NOT EXISTS idx_" + SESSIONS_TABLE + "_last_updated ON "
+                + SESSIONS_TABLE + " (last_updated)",
+            "ANALYZE"
+        }},
+        {3, "full-text index over dialogue history", {
+            // 由 HistoryTokenizer 预先切分，unicode61 只按空格拆分；无内容表，原文从记录表读取
+            "CREATE VIRTUAL TABLE IF NOT EXISTS " + HISTORY_FTS_TABLE + " USING fts5("
+            "terms, grams, content='', prefix='1', tokenize='unicode61 remove_diacritics 2')"
+        }, [this]() { return rebuildHistoryIndex(); }, true, [this]() { return tableExists(HISTORY_FTS_TABLE); }},
+        {4, "compress search and intent results", {
+            "CREATE TABLE IF NOT EXISTS " + DICTIONARIES_TABLE + " ("
+            "id INTEGER PRIMARY KEY,"   // zstd 词典编号，与压缩帧头中的编号一致
+            "dictionary BLOB NOT NULL,"
+            "sample_count INTEGER NOT NULL,"
+            "created_at DATETIME DEFAULT CURRENT_TIMESTAMP"
+            ")"
+        }, [this]() { return compressExistingPayloads(); }},
+        {5, "denormalise session summaries for keyset pagination", {
+            // 会话列表直接读取会话表，不再对记录表分组聚合
+            "ALTER TABLE " + SESSIONS_TABLE + " ADD COLUMN message_count INTEGER NOT NULL DEFAULT 0",
+            "ALTER TABLE " + SESSIONS_TABLE + " ADD COLUMN last_turn INTEGER NOT NULL DEFAULT 0",
+            "ALTER TABLE " + SESSIONS_TABLE + " ADD COLUMN last_query TEXT",
+            "UPDATE " + SESSIONS_TABLE + " SET "
+            "message_count = (SELECT COUNT(*) FROM " + DIALOGUES_TABLE + " d WHERE d.session_id = " + SESSIONS_TABLE + ".session_id), "
+            "last_turn = COALESCE((SELECT MAX(d.turn_number) FROM " + DIALOGUES_TABLE + " d WHERE d.session_id = " + SESSIONS_TABLE + ".session_id), 0), "
+            "last_query = (SELECT d.user_query FROM " + DIALOGUES_TABLE + " d WHERE d.session_id = " + SESSIONS_TABLE + ".session_id "
+            "ORDER BY d.turn_number DESC, d.id DESC LIMIT 1)",
+            // 只索引有对话记录的会话，分页按 (last_updated, session_id) 倒序定位
+            "CREATE INDEX IF NOT EXISTS idx_" + SESSIONS_TABLE + "_listing ON " + SESSIONS_TABLE +
+                " (last_updated, session_id) WHERE message_count > 0",
+            "ANALYZE"
+        }}
+    };
+
+    QSqlQuery query(db);
+    int currentVersion = 0;
+    if (query.exec("PRAGMA user_version") && query.next()) {
+        currentVersion = query.value(0).toInt();
+    }
+    query.finish();
+
+    for (const auto& migration : migrations) {
+        bool pending = migration.version > currentVersion;
+        bool retry = !pending && migration.optional && migration.present && !migration.present();
+        if (!pending && !retry) {
+            continue;
+        }
 
+        if (!db.transaction()) {
+            ERRORLOG("Failed to start transaction: {}", db.lastError().text().toStdString());
+            return false;
+        }
+        bool success = true;
+        for (const QString& statement : migration.statements) {
+            if (!query.exec(statement)) {
+                ERRORLOG("Schema migration {} failed: {}", migration.version, query.lastError().text().toStdString());
+                success = false;
+                break;
+            }
+        }
+        if (success && migration.populate) {
+            success = migration.populate();
+        }
+        // user_version 与结构变更在同一事务中提交
+        if (success && pending && !query.exec("PRAGMA user_version = " + QString::number(migration.version))) {
+            success = false;
+        }
+        if (success && !db.commit()) {
+            ERRORLOG("Failed to commit schema migration {}: {}", migration.version, db.lastError().text().toStdString());
+            success = false;
+        }
         if (!success) {
-            ERRORLOG("Failed to create dialogues table: {}", query.lastError().text().toStdString());
             db.rollback();
-            return false;
+            if (!migration.optional) {
+                return false;
+            }
+            WARNLOG("Optional schema migration {} ({}) skipped", migration.version, migration.description);
+            if (pending && !query.exec("PRAGMA user_version = " + QString::number(migration.version))) {
+                return false;
+            }
+        } else {
+            INFOLOG("Applied schema migration {}: {}", migration.version, migration.description);
         }
+        currentVersion = std::max(currentVersion, migration.version);
+    }
 
-        // 6. 提交事务
-        if (!db.commit()) {
-            ERRORLOG("Failed to commit transaction: {}", db.lastError().text().toStdString());
-            db.rollback();
+    // 改写大量记录后整理文件，释放的页归还文件系统（VACUUM 不能在事务中执行）
+    if (vacuumAfterMigration) {
+        vacuumAfterMigration = false;
+        if (!query.exec("VACUUM")) {
+            WARNLOG("VACUUM after migration failed: {}", query.lastError().text().toStdString());
+        }
+    }
+
+    // SQLite 未编译 FTS5 时历史检索不可用，其余功能照常
+    historyIndexEnabled = tableExists(HISTORY_FTS_TABLE);
+    if (!historyIndexEnabled) {
+        WARNLOG("Dialogue history full-text search is unavailable");
+    }
+    return true;
+}
+
+/*
+ * Summary: 为已有的对话记录建立全文索引
+ * Return: bool - 全部写入成功时返回 true
+ * Description: 在迁移事务中执行，此后新记录由 addDialogueRecords 随插入同步写入索引
+ */
+bool SQLiteDatabaseManager::rebuildHistoryIndex() {
+    QSqlQuery select(db);
+    select.setForwardOnly(true);
+    if (!select.exec("SELECT id, session_id, user_query, intent_result, search_result FROM " + DIALOGUES_TABLE)) {
+        ERRORLOG("Failed to read dialogue records for indexing: {}", select.lastError().text().toStdString());
+        return false;
+    }
+    int indexed = 0;
+    while (select.next()) {
+        qint64 recordId = select.value(0).toLongLong();
+        DialogueRecord record;
+        record.sessionId = select.value(1).toString();
+        record.userQuery = select.value(2).toString();
+        try {
+            record.intentResult = decodePayload(select.value(3), recordId);
+            record.searchResult = decodePayload(select.value(4), recordId);
+        } catch (const PayloadDecodeError&) {
             return false;
         }
+        if (!indexDialogueRecord(recordId, record)) {
+            return false;
+        }
+        ++indexed;
+    }
+    INFOLOG("Indexed {} existing dialogue records for full-text search", indexed);
+    return true;
+}
 
-        INFOLOG("Database tables initialized successfully");
-        return true;
+bool SQLiteDatabaseManager::indexDialogueRecord(qint64 recordId, const DialogueRecord& record) {
+    std::string text = record.userQuery.toStdString() + "\n" + record.intentResult.toStdString() + "\n";
+    std::string searchResult = record.searchResult.toStdString();
+    auto parsed = nlohmann::json::parse(searchResult, nullptr, false);
+    if (parsed.is_discarded()) {
+        text += searchResult;
+    } else {
+        collectText(parsed, text);
+    }
+
+    HistoryTokens tokens = HistoryTokenizer::getInstance()->tokenize(text);
+    QSqlQuery* insert = cachedQuery("INSERT INTO " + HISTORY_FTS_TABLE + " (rowid, terms, grams) VALUES (?, ?, ?)");
+    if (!insert) {
+        return false;
+    }
+    insert->bindValue(0, recordId);
+    insert->bindValue(1, QString::fromStdString(HistoryTokenizer::join(tokens.terms)));
+    insert->bindValue(2, QString::fromStdString(HistoryTokenizer::join(tokens.grams)));
+    if (!insert->exec()) {
+        ERRORLOG("Failed to index dialogue record {}: {}", recordId, insert->lastError().text().toStdString());
+        return false;
+    }
+    return true;
+}
 
+/*
+ * Summary: 编码待写入的 search_result / intent_result
+ * Parameters:
+ *   const QString& text - 原文
+ * Return: QVariant - 压缩后更小时为 zstd 帧（BLOB），否则为原文（TEXT）
+ * Description: 短文本压缩收益有限，低于 min_size_bytes 时直接保存原文
+ */
+QVariant SQLiteDatabaseManager::encodePayload(const QString& text) {
+    std::string utf8 = text.toStdString();
+    if (!compressPayloads || utf8.size() < minCompressedSize) {
+        return text;
+    }
+    try {
+        std::string frame = payloadCodec->compress(utf8);
+        if (frame.size() < utf8.size()) {
+            return QByteArray(frame.data(), static_cast<int>(frame.size()));
+        }
     } catch (const std::exception& e) {
-        ERRORLOG("Exception during database initialization: {}", e.what());
-        db.rollback();
+        WARNLOG("Failed to compress payload, storing plain text: {}", e.what());
+    }
+    return text;
+}
+
+/*
+ * Summary: 还原读取到的 search_result / intent_result
+ * Parameters:
+ *   const QVariant& value - 列值，BLOB 为压缩帧，TEXT 为原文
+ *   qint64 recordId - 所属对话记录的 id，用于定位损坏的记录
+ * Return: QString - 原文
+ * Description: 词典可能由另一个连接训练，遇到未加载的词典编号时从词典表重新加载。
+ *              重新加载后仍缺少词典或帧已损坏时抛出 PayloadDecodeError，不把损坏的记录当作空结果返回
+ */
+QString SQLiteDatabaseManager::decodePayload(const QVariant& value, qint64 recordId) {
+    if (value.typeId() != QMetaType::QByteArray) {
+        return value.toString();
+    }
+    QByteArray bytes = value.toByteArray();
+    std::string frame(bytes.constData(), static_cast<size_t>(bytes.size()));
+    uint32_t dictionaryId = PayloadCodec::frameDictionaryId(frame);
+    if (dictionaryId != 0 && !payloadCodec->hasDictionary(dictionaryId)) {
+        loadDictionaries();
+    }
+    try {
+        return QString::fromStdString(payloadCodec->decompress(frame));
+    } catch (const std::exception& e) {
+        ERRORLOG("Failed to decompress payload of dialogue record {} ({} bytes, dictionary {}): {}",
+                 recordId, frame.size(), dictionaryId, e.what());
+        throw PayloadDecodeError(recordId, e.what());
+    }
+}
+
+void SQLiteDatabaseManager::loadDictionaries() {
+    QSqlQuery query(db);
+    if (!query.exec("SELECT dictionary FROM " + DICTIONARIES_TABLE + " ORDER BY created_at, rowid")) {
+        return;  // 迁移 4 尚未执行
+    }
+    uint32_t latest = 0;
+    while (query.next()) {
+        QByteArray dictionary = query.value(0).toByteArray();
+        uint32_t id = payloadCodec->addDictionary(std::string(dictionary.constData(), static_cast<size_t>(dictionary.size())));
+        latest = id != 0 ? id : latest;
+    }
+    if (latest != 0 && latest != payloadCodec->activeDictionary()) {
+        payloadCodec->setActiveDictionary(latest);
+        DEBUGLOG("Using payload compression dictionary {}", latest);
+    }
+}
+
+/*
+ * Summary: 从最近的记录训练压缩词典并保存
+ * Return: bool - 训练并保存成功时返回 true
+ * Description: 样本取最近 1000 条记录的 search_result 与 intent_result；保存后立即启用
+ */
+bool SQLiteDatabaseManager::trainDictionary() {
+    QSqlQuery select(db);
+    select.setForwardOnly(true);
+    if (!select.exec("SELECT id, intent_result, search_result FROM " + DIALOGUES_TABLE + " ORDER BY id DESC LIMIT 1000")) {
+        ERRORLOG("Failed to read dictionary samples: {}", select.lastError().text().toStdString());
+        return false;
+    }
+    std::vector<std::string> samples;
+    while (select.next()) {
+        qint64 recordId = select.value(0).toLongLong();
+        for (int column = 1; column <= 2; ++column) {
+            std::string sample;
+            try {
+                sample = decodePayload(select.value(column), recordId).toStdString();
+            } catch (const PayloadDecodeError&) {
+                continue;  // 损坏的记录不作为样本，已记录错误
+            }
+            if (sample.size() >= minCompressedSize) {
+                samples.push_back(std::move(sample));
+            }
+        }
+    }
+    select.finish();
+
+    std::string dictionary = PayloadCodec::trainDictionary(samples, dictionaryCapacity);
+    uint32_t id = dictionary.empty() ? 0 : payloadCodec->addDictionary(dictionary);
+    if (id == 0) {
+        return false;
+    }
+
+    QSqlQuery insert(db);
+    insert.prepare("INSERT OR IGNORE INTO " + DICTIONARIES_TABLE + " (id, dictionary, sample_count) VALUES (?, ?, ?)");
+    insert.addBindValue(static_cast<qint64>(id));
+    insert.addBindValue(QByteArray(dictionary.data(), static_cast<int>(dictionary.size())));
+    insert.addBindValue(static_cast<int>(samples.size()));
+    if (!insert.exec()) {
+        ERRORLOG("Failed to save compression dictionary: {}", insert.lastError().text().toStdString());
         return false;
     }
+    payloadCodec->setActiveDictionary(id);
+    INFOLOG("Trained payload compression dictionary {} ({} bytes) from {} samples", id, dictionary.size(), samples.size());
+    return true;
+}
+
+void SQLiteDatabaseManager::trainDictionaryIfReady() {
+    // 另一个连接可能已经训练过
+    loadDictionaries();
+    if (payloadCodec->activeDictionary() != 0) {
+        return;
+    }
+    QSqlQuery* count = cachedQuery("SELECT COUNT(*) FROM " + DIALOGUES_TABLE);
+    if (!count || !count->exec() || !count->next()) {
+        return;
+    }
+    int records = count->value(0).toInt();
+    count->finish();
+    if (records < nextDictionaryTraining) {
+        return;
+    }
+    if (!trainDictionary()) {
+        // 样本不足以训练出有效词典，记录数翻倍后再试
+        nextDictionaryTraining = records * 2;
+    }
+}
+
+/*
+ * Summary: 压缩已有记录（迁移 4）
+ * Return: bool - 全部改写成功时返回 true
+ * Description: 记录数达到 train_after_records 时先训练词典；随后按 id 分块改写每条记录，
+ *              已是压缩格式的值原样保留。在迁移事务中执行，完成后整理数据库文件
+ */
+bool SQLiteDatabaseManager::compressExistingPayloads() {
+    if (!compressPayloads) {
+        return true;
+    }
+    trainDictionaryIfReady();
+
+    QSqlQuery select(db);
+    QSqlQuery update(db);
+    update.prepare("UPDATE " + DIALOGUES_TABLE + " SET intent_result = ?, search_result = ? WHERE id = ?");
+    qint64 lastId = 0;
+    int rewritten = 0;
+    while (true) {
+        select.prepare("SELECT id, intent_result, search_result FROM " + DIALOGUES_TABLE +
+                       " WHERE id > ? ORDER BY id LIMIT 500");
+        select.addBindValue(lastId);
+        if (!select.exec()) {
+            ERRORLOG("Failed to read dialogue records for compression: {}", select.lastError().text().toStdString());
+            return false;
+        }
+        QVector<QVariantList> rows;
+        while (select.next()) {
+            rows.append({select.value(0), select.value(1), select.value(2)});
+        }
+        select.finish();
+        if (rows.isEmpty()) {
+            break;
+        }
+
+        for (const QVariantList& row : rows) {
+            lastId = row[0].toLongLong();
+            try {
+                update.bindValue(0, encodePayload(decodePayload(row[1], lastId)));
+                update.bindValue(1, encodePayload(decodePayload(row[2], lastId)));
+            } catch (const PayloadDecodeError&) {
+                // 无法还原的记录不能改写为空值，整个迁移回滚
+                return false;
+            }
+            update.bindValue(2, lastId);
+            if (!update.exec()) {
+                ERRORLOG("Failed to compress dialogue record {}: {}", lastId, update.lastError().text().toStdString());
+                return false;
+            }
+            ++rewritten;
+        }
+    }
+
+    if (rewritten > 0) {
+        vacuumAfterMigration = true;
+        INFOLOG("Compressed {} existing dialogue records", rewritten);
+    }
+    return true;
+}
+
+bool SQLiteDatabaseManager::tableExists(const QString& name) {
+    QSqlQuery query(db);
+    query.prepare("SELECT 1 FROM sqlite_master WHERE name = ?");
+    query.addBindValue(name);
+    return query.exec() && query.next();
+}
+
+QSqlQuery* SQLiteDatabaseManager::cachedQuery(const QString& sql) {
+    auto it = statementCache.find(sql);
+    if (it == statementCache.end()) {
+        QSqlQuery query(db);
+        if (!query.prepare(sql)) {
+            ERRORLOG("Failed to prepare statement: {} - {}", sql.toStdString(), query.lastError().text().toStdString());
+            return nullptr;
+        }
+        it = statementCache.insert(sql, query);
+    }
+    return &it.value();
 }
 
 QString SQLiteDatabaseManager::createSession() {
@@ -130,13 +585,15 @@ QString SQLiteDatabaseManager::createSession() {
 
     QString sessionId = QUuid::createUuid().toString(QUuid::WithoutBraces);
     
-    // 2. 使用正确的数据库连接创建查询
-    QSqlQuery query(db);  // 显式指定数据库连接
-    query.prepare("INSERT INTO " + SESSIONS_TABLE + " (session_id) VALUES (?)");
-    query.addBindValue(sessionId);
+    // 2. 使用预编译语句创建会话
+    QSqlQuery* query = cachedQuery("INSERT INTO " + SESSIONS_TABLE + " (session_id) VALUES (?)");
+    if (!query) {
+        return QString();
+    }
+    query->bindValue(0, sessionId);
     
-    if (!query.exec()) {
-        ERRORLOG("Failed to create session: {}", query.lastError().text().toStdString());
+    if (!query->exec()) {
+        ERRORLOG("Failed to create session: {}", query->lastError().text().toStdString());
         return QString();
     }
     
@@ -151,107 +608,370 @@ bool SQLiteDatabaseManager::addDialogueRecord(
     const QString& search_result,
     int turn_number = 0)
 {
+    DialogueRecord record;
+    record.sessionId = sessionId;
+    record.userQuery = user_query;
+    record.intentType = QString::fromStdString(intent_type);
+    record.intentResult = intent_result;
+    record.searchResult = search_result;
+    record.turnNumber = turn_number;
+    return addDialogueRecords({record});
+}
+
+/*
+ * Summary: 批量写入对话记录
+ * Parameters:
+ *   const QVector<DialogueRecord>& records - 按提交顺序排列的记录
+ * Return: bool - 整批提交成功时返回 true
+ * Description: 所有记录、全文索引与会话更新在一个事务中提交，只写一次 WAL；
+ *              同一会话在批内只更新一次：标题取批内第一条查询，对话数累加，最后查询取轮次最大的一条
+ */
+bool SQLiteDatabaseManager::addDialogueRecords(const QVector<DialogueRecord>& records)
+{
+    if (records.isEmpty()) {
+        return true;
+    }
     if (!db.isOpen() && !db.open()) {
         ERRORLOG("Database connection is not open");
         return false;
     }
 
-    QSqlQuery query(db);  // 显式指定数据库连接
-    query.prepare("INSERT INTO " + DIALOGUES_TABLE + 
-                 " (session_id, turn_number, user_query, intent_type, intent_result, search_result) "
-                 "VALUES (?, ?, ?, ?, ?, ?)");
-    query.addBindValue(sessionId);
-    query.addBindValue(turn_number);
-    query.addBindValue(user_query);
-    query.addBindValue(QString::fromStdString(intent_type));
-    query.addBindValue(intent_result);
-    query.addBindValue(search_result);
-    
-    bool success = query.exec();
-    
-    if (success) {
-        // 更新会话的最后更新时间
-        query.prepare("UPDATE " + SESSIONS_TABLE + 
-                     " SET last_updated = CURRENT_TIMESTAMP, title = COALESCE(title, ?) "
-                     "WHERE session_id = ?");
-        query.addBindValue(user_query);  // 如果标题为空，使用第一条用户查询作为标题
-        query.addBindValue(sessionId);
-        success = query.exec();
-    }
-
-    if (!success) {
-        ERRORLOG("Failed to add dialogue record: {}", query.lastError().text().toStdString());
-    } else {
-        DEBUGLOG("Added dialogue record - Session: {}, Turn: {}", sessionId.toStdString(), turn_number);
+    QSqlQuery* insert = cachedQuery("INSERT INTO " + DIALOGUES_TABLE +
+                                    " (session_id, turn_number, user_query, intent_type, intent_result, search_result) "
+                                    "VALUES (?, ?, ?, ?, ?, ?)");
+    // 如果标题为空，使用第一条用户查询作为标题；结果可能乱序完成，last_query 只随更大的轮次更新
+    QSqlQuery* touch = cachedQuery("UPDATE " + SESSIONS_TABLE +
+                                   " SET last_updated = CURRENT_TIMESTAMP, title = COALESCE(title, ?), "
+                                   "message_count = message_count + ?, "
+                                   "last_query = CASE WHEN ? >= last_turn THEN ? ELSE last_query END, "
+                                   "last_turn = MAX(last_turn, ?) "
+                                   "WHERE session_id = ?");
+    if (!insert || !touch) {
+        return false;
+    }
+
+    if (!db.transaction()) {
+        ERRORLOG("Failed to start transaction: {}", db.lastError().text().toStdString());
+        return false;
+    }
+
+    // 批内每个会话的汇总：首条记录（标题）、轮次最大的记录与条数
+    struct SessionTouch {
+        const DialogueRecord* first;
+        const DialogueRecord* latest;
+        int count;
+    };
+    QVector<SessionTouch> touches;
+    for (const DialogueRecord& record : records) {
+        insert->bindValue(0, record.sessionId);
+        insert->bindValue(1, record.turnNumber);
+        insert->bindValue(2, record.userQuery);
+        insert->bindValue(3, record.intentType);
+        insert->bindValue(4, encodePayload(record.intentResult));
+        insert->bindValue(5, encodePayload(record.searchResult));
+        if (!insert->exec()) {
+            ERRORLOG("Failed to add dialogue record: {}", insert->lastError().text().toStdString());
+            db.rollback();
+            return false;
+        }
+        // 全文索引与记录在同一事务中写入
+        if (historyIndexEnabled && !indexDialogueRecord(insert->lastInsertId().toLongLong(), record)) {
+            db.rollback();
+            return false;
+        }
+        auto existing = std::find_if(touches.begin(), touches.end(),
+                                     [&record](const SessionTouch& summary) { return summary.first->sessionId == record.sessionId; });
+        if (existing == touches.end()) {
+            touches.append({&record, &record, 1});
+        } else {
+            ++existing->count;
+            if (record.turnNumber >= existing->latest->turnNumber) {
+                existing->latest = &record;
+            }
+        }
+    }
+
+    // 更新会话的最后更新时间与对话摘要
+    for (const SessionTouch& summary : touches) {
+        touch->bindValue(0, summary.first->userQuery);
+        touch->bindValue(1, summary.count);
+        touch->bindValue(2, summary.latest->turnNumber);
+        touch->bindValue(3, summary.latest->userQuery);
+        touch->bindValue(4, summary.latest->turnNumber);
+        touch->bindValue(5, summary.first->sessionId);
+        if (!touch->exec()) {
+            ERRORLOG("Failed to update session {}: {}", summary.first->sessionId.toStdString(), touch->lastError().text().toStdString());
+            db.rollback();
+            return false;
+        }
     }
 
-    return success;
+    if (!db.commit()) {
+        ERRORLOG("Failed to commit dialogue records: {}", db.lastError().text().toStdString());
+        db.rollback();
+        return false;
+    }
+    DEBUGLOG("Added {} dialogue records across {} sessions", records.size(), touches.size());
+
+    // 记录足够多后训练压缩词典，此后的记录使用词典压缩
+    if (compressPayloads && payloadCodec->activeDictionary() == 0) {
+        trainDictionaryIfReady();
+    }
+    return true;
 }
 
 QVector<QPair<QString, QVariantMap>> SQLiteDatabaseManager::getSessionHistory(int limit) {
     QVector<QPair<QString, QVariantMap>> sessions;
-    QSqlQuery query(db);
-    
-    // 修改查询以只获取有对话记录的会话
-    query.prepare(
-        "SELECT s.session_id, s.title, s.created_at, s.last_updated, "
-        "COUNT(d.id) as message_count, "
-        "MAX(d.user_query) as last_query "
-        "FROM " + SESSIONS_TABLE + " s "
-        "INNER JOIN " + DIALOGUES_TABLE + " d ON s.session_id = d.session_id "  // 改为 INNER JOIN
-        "GROUP BY s.session_id "
-        "HAVING COUNT(d.id) > 0 "  // 确保只返回有对话记录的会话
-        "ORDER BY s.last_updated DESC LIMIT ?"
-    );
-    
-    query.addBindValue(limit);
-    
-    if (query.exec()) {
-        while (query.next()) {
+    for (const QVariantMap& sessionInfo : getSessionPage(QString(), limit).items) {
+        sessions.append(qMakePair(sessionInfo.value("id").toString(), sessionInfo));
+    }
+    return sessions;
+}
+
+/*
+ * Summary: 按游标分页获取会话列表
+ * Parameters:
+ *   const QString& cursor - 上一页返回的 nextCursor，为空时取第一页
+ *   int limit - 每页会话数
+ * Return: HistoryPage - 按最后更新时间倒序的会话，以及下一页的游标
+ * Description: 对话数与最后查询在写入时维护在会话行上，列表只读会话表；
+ *              以 (last_updated, session_id) 为键向后翻页，经部分索引定位，任意深度的页代价相同。
+ *              游标为 "last_updated|session_id"，会话 ID 不含 '|'
+ */
+HistoryPage SQLiteDatabaseManager::getSessionPage(const QString& cursor, int limit) {
+    HistoryPage page;
+    limit = std::max(limit, 1);
+
+    const QString columns = "SELECT session_id, title, created_at, last_updated, message_count, last_query FROM "
+                            + SESSIONS_TABLE + " WHERE message_count > 0 ";
+    const QString order = "ORDER BY last_updated DESC, session_id DESC LIMIT ?";
+    int separator = cursor.lastIndexOf('|');
+    QSqlQuery* query = cursor.isEmpty()
+        ? cachedQuery(columns + order)
+        : cachedQuery(columns + "AND (last_updated, session_id) < (?, ?) " + order);
+    if (!query) {
+        return page;
+    }
+    if (cursor.isEmpty()) {
+        query->bindValue(0, limit + 1);
+    } else {
+        query->bindValue(0, cursor.left(separator));
+        query->bindValue(1, cursor.mid(separator + 1));
+        query->bindValue(2, limit + 1);
+    }
+
+    // 多取一条用于判断是否还有下一页
+    if (query->exec()) {
+        while (query->next()) {
+            if (page.items.size() == limit) {
+                const QVariantMap& last = page.items.last();
+                page.nextCursor = last.value("last_updated").toString() + "|" + last.value("id").toString();
+                break;
+            }
             QVariantMap sessionInfo;
-            QString sessionId = query.value("session_id").toString();
-            
-            sessionInfo["id"] = sessionId;
-            sessionInfo["title"] = query.value("title").toString();
-            sessionInfo["created_at"] = query.value("created_at").toString();
-            sessionInfo["last_updated"] = query.value("last_updated").toString();
-            sessionInfo["message_count"] = query.value("message_count").toInt();
-            sessionInfo["last_query"] = query.value("last_query").toString();
-            
-            sessions.append(qMakePair(sessionId, sessionInfo));
+            sessionInfo["id"] = query->value(0).toString();
+            sessionInfo["title"] = query->value(1).toString();
+            sessionInfo["created_at"] = query->value(2).toString();
+            sessionInfo["last_updated"] = query->value(3).toString();
+            sessionInfo["message_count"] = query->value(4).toInt();
+            sessionInfo["last_query"] = query->value(5).toString();
+            page.items.append(sessionInfo);
         }
     } else {
-        ERRORLOG("Failed to fetch session history: {}", query.lastError().text().toStdString());
+        ERRORLOG("Failed to fetch session history: {}", query->lastError().text().toStdString());
     }
-    
-    return sessions;
+    query->finish();
+
+    return page;
 }
 
 QVector<QVariantMap> SQLiteDatabaseManager::getDialogueHistory(const QString& sessionId) {
     QVector<QVariantMap> dialogues;
-    QSqlQuery query(db);  // 使用正确的数据库连接
-    
-    query.prepare("SELECT * FROM " + DIALOGUES_TABLE + 
-                 " WHERE session_id = ? ORDER BY turn_number ASC");
-    query.addBindValue(sessionId);
+
+    // 经 (session_id, turn_number) 索引按轮次顺序读取，无需排序
+    QSqlQuery* query = cachedQuery(
+        "SELECT id, turn_number, user_query, intent_type, intent_result, search_result, timestamp FROM "
+        + DIALOGUES_TABLE + " WHERE session_id = ? ORDER BY turn_number ASC");
+    if (!query) {
+        return dialogues;
+    }
+    query->bindValue(0, sessionId);
     
-    if (query.exec()) {
-        while (query.next()) {
+    if (query->exec()) {
+        while (query->next()) {
+            qint64 recordId = query->value(0).toLongLong();
             QVariantMap dialogue;
-            dialogue["turn_number"] = query.value("turn_number").toInt();
-            dialogue["user_query"] = query.value("user_query").toString();
-            dialogue["intent_type"] = query.value("intent_type").toString();
-            dialogue["intent_result"] = query.value("intent_result").toString();
-            dialogue["search_result"] = query.value("search_result").toString();
-            dialogue["timestamp"] = query.value("timestamp").toString();
+            dialogue["turn_number"] = query->value(1).toInt();
+            dialogue["user_query"] = query->value(2).toString();
+            dialogue["intent_type"] = query->value(3).toString();
+            try {
+                dialogue["intent_result"] = decodePayload(query->value(4), recordId);
+                dialogue["search_result"] = decodePayload(query->value(5), recordId);
+            } catch (const PayloadDecodeError&) {
+                query->finish();  // 释放读快照后再抛出
+                throw;
+            }
+            dialogue["timestamp"] = query->value(6).toString();
             
             dialogues.append(dialogue);
         }
     } else {
-        ERRORLOG("Failed to fetch dialogue history: {}", query.lastError().text().toStdString());
+        ERRORLOG("Failed to fetch dialogue history: {}", query->lastError().text().toStdString());
     }
+    query->finish();
     
     return dialogues;
 }
 
+int SQLiteDatabaseManager::getLastTurnNumber(const QString& sessionId) {
+    // 经 (session_id, turn_number) 索引直接取最大值，不读取记录内容
+    QSqlQuery* query = cachedQuery("SELECT MAX(turn_number) FROM " + DIALOGUES_TABLE + " WHERE session_id = ?");
+    if (!query) {
+        return 0;
+    }
+    query->bindValue(0, sessionId);
+
+    int lastTurn = 0;
+    if (query->exec() && query->next()) {
+        lastTurn = query->value(0).toInt();
+    } else {
+        ERRORLOG("Failed to read last turn of session {}: {}", sessionId.toStdString(),
+                 query->lastError().text().toStdString());
+    }
+    query->finish();
+    return lastTurn;
+}
+
+/*
+ * Summary: 按游标分页获取会话的对话记录
+ * Parameters:
+ *   const QString& sessionId - 会话ID
+ *   const QString& cursor - 上一页返回的 nextCursor，为空时取最新一页
+ *   int limit - 每页记录数
+ * Return: HistoryPage - 按轮次正序排列的一页记录，nextCursor 指向更早的记录
+ * Description: 经 (session_id, turn_number) 索引从游标处倒序读取 limit 条，只解压本页的结果。
+ *              游标为本页最早一条的 "turn_number|id"，id 区分同一轮次的多条记录
+ */
+HistoryPage SQLiteDatabaseManager::getDialoguePage(const QString& sessionId, const QString& cursor, int limit) {
+    HistoryPage page;
+    limit = std::max(limit, 1);
+
+    int beforeTurn = std::numeric_limits<int>::max();
+    qint64 beforeId = std::numeric_limits<qint64>::max();
+    if (!cursor.isEmpty()) {
+        int separator = cursor.indexOf('|');
+        beforeTurn = cursor.left(separator).toInt();
+        beforeId = cursor.mid(separator + 1).toLongLong();
+    }
+
+    QSqlQuery* query = cachedQuery(
+        "SELECT id, turn_number, user_query, intent_type, intent_result, search_result, timestamp FROM "
+        + DIALOGUES_TABLE + " WHERE session_id = ? AND (turn_number, id) < (?, ?) "
+        "ORDER BY turn_number DESC, id DESC LIMIT ?");
+    if (!query) {
+        return page;
+    }
+    query->bindValue(0, sessionId);
+    query->bindValue(1, beforeTurn);
+    query->bindValue(2, beforeId);
+    query->bindValue(3, limit + 1);
+
+    if (query->exec()) {
+        qint64 oldestId = 0;
+        while (query->next()) {
+            if (page.items.size() == limit) {
+                page.nextCursor = page.items.last().value("turn_number").toString() + "|" + QString::number(oldestId);
+                break;
+            }
+            QVariantMap dialogue;
+            oldestId = query->value(0).toLongLong();
+            dialogue["turn_number"] = query->value(1).toInt();
+            dialogue["user_query"] = query->value(2).toString();
+            dialogue["intent_type"] = query->value(3).toString();
+            try {
+                dialogue["intent_result"] = decodePayload(query->value(4), oldestId);
+                dialogue["search_result"] = decodePayload(query->value(5), oldestId);
+            } catch (const PayloadDecodeError&) {
+                query->finish();
+                throw;
+            }
+            dialogue["timestamp"] = query->value(6).toString();
+            page.items.append(dialogue);
+        }
+    } else {
+        ERRORLOG("Failed to fetch dialogue page: {}", query->lastError().text().toStdString());
+    }
+    query->finish();
+
+    std::reverse(page.items.begin(), page.items.end());
+    return page;
+}
+
+/*
+ * Summary: 全文检索对话历史
+ * Parameters:
+ *   const QString& query - 检索词，可混合中英文
+ *   int limit - 返回的最大条数
+ * Return: QVector<QVariantMap> - 命中的对话记录，附带所属会话的标题
+ * Description: 汉字按二元组短语匹配（即子串匹配），拉丁词按前缀匹配。默认按时间由新到旧返回，
+ *              FTS5 按 rowid 倒序读取到 limit 条即停止；开启 rank_by_relevance 时按 bm25 排序
+ *              （词典切分一致的 terms 列权重更高），需为全部命中打分，命中很多时明显变慢
+ */
+QVector<QVariantMap> SQLiteDatabaseManager::searchHistory(const QString& query, int limit) {
+    QVector<QVariantMap> matches;
+    if (!historyIndexEnabled) {
+        return matches;
+    }
+    std::string matchQuery = HistoryTokenizer::getInstance()->buildMatchQuery(query.toStdString());
+    if (matchQuery.empty()) {
+        return matches;
+    }
+
+    // 先在全文索引中取出命中的 rowid，再回表读取原文
+    QString candidates = rankHistoryByRelevance
+        ? "SELECT rowid, bm25(" + HISTORY_FTS_TABLE + ", 2.0, 1.0) AS score FROM " + HISTORY_FTS_TABLE +
+              " WHERE " + HISTORY_FTS_TABLE + " MATCH ? ORDER BY score LIMIT ?"
+        : "SELECT rowid, 0 AS score FROM " + HISTORY_FTS_TABLE +
+              " WHERE " + HISTORY_FTS_TABLE + " MATCH ? ORDER BY rowid DESC LIMIT ?";
+    QSqlQuery* select = cachedQuery(
+        "SELECT d.session_id, s.title, d.turn_number, d.user_query, d.intent_type, d.intent_result, "
+        "d.search_result, d.timestamp, m.score, d.id FROM (" + candidates + ") m "
+        "JOIN " + DIALOGUES_TABLE + " d ON d.id = m.rowid "
+        "LEFT JOIN " + SESSIONS_TABLE + " s ON s.session_id = d.session_id "
+        "ORDER BY m.score, m.rowid DESC"
+    );
+    if (!select) {
+        return matches;
+    }
+    select->bindValue(0, QString::fromStdString(matchQuery));
+    select->bindValue(1, limit);
+
+    if (select->exec()) {
+        while (select->next()) {
+            QVariantMap match;
+            match["session_id"] = select->value(0).toString();
+            match["session_title"] = select->value(1).toString();
+            match["turn_number"] = select->value(2).toInt();
+            match["user_query"] = select->value(3).toString();
+            match["intent_type"] = select->value(4).toString();
+            qint64 recordId = select->value(9).toLongLong();
+            try {
+                match["intent_result"] = decodePayload(select->value(5), recordId);
+                match["search_result"] = decodePayload(select->value(6), recordId);
+            } catch (const PayloadDecodeError&) {
+                select->finish();
+                throw;
+            }
+            match["timestamp"] = select->value(7).toString();
+            match["score"] = select->value(8).toDouble();
+            matches.append(match);
+        }
+    } else {
+        ERRORLOG("Failed to search dialogue history: {}", select->lastError().text().toStdString());
+    }
+    select->finish();
+
+    return matches;
+}
+
 } // namespace IntelliSearch
\ No newline at end of file
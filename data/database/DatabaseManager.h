@@ -8,10 +8,44 @@
 #include <QSqlError>
 #include <QDateTime>
 #include <QVariantMap>
+#include <QHash>
+#include <QVector>
 #include <memory>
+#include <stdexcept>
+#include <string>
 
 namespace IntelliSearch {
 
+class PayloadCodec;
+
+// 已保存的 search_result / intent_result 无法还原（压缩帧损坏或所需词典不存在）
+class PayloadDecodeError : public std::runtime_error {
+public:
+    PayloadDecodeError(qint64 recordId, const std::string& reason)
+        : std::runtime_error("dialogue record " + std::to_string(recordId) + ": " + reason), recordId(recordId) {}
+
+    qint64 getRecordId() const { return recordId; }
+
+private:
+    qint64 recordId;
+};
+
+// 一条待写入的对话记录
+struct DialogueRecord {
+    QString sessionId;
+    QString userQuery;
+    QString intentType;
+    QString intentResult;
+    QString searchResult;
+    int turnNumber = 0;
+};
+
+// 一页历史：nextCursor 传给下一次调用以取得后续一页，为空表示没有更多
+struct HistoryPage {
+    QVector<QVariantMap> items;
+    QString nextCursor;
+};
+
 // 抽象数据库管理接口
 class IDatabaseManager {
 public:
@@ -29,9 +63,23 @@ public:
         const QString& intent_result,
         const QString& search_result,
         int turn_number) = 0;  // 添加对话记录
+
+    // 在同一事务中写入多条对话记录并更新所属会话，任一条失败时整批回滚
+    virtual bool addDialogueRecords(const QVector<DialogueRecord>& records) = 0;
         
     virtual QVector<QPair<QString, QVariantMap>> getSessionHistory(int limit = 10) = 0;  // 获取会话历史
     virtual QVector<QVariantMap> getDialogueHistory(const QString& sessionId) = 0;  // 获取特定会话的对话历史
+
+    // 会话已保存的最大轮次，没有记录时为 0；只读索引，不解压记录
+    virtual int getLastTurnNumber(const QString& sessionId) = 0;
+
+    // 按游标分页：会话按最后更新时间倒序；对话从最新一轮往前翻，每页内按轮次正序。cursor 为空取第一页
+    virtual HistoryPage getSessionPage(const QString& cursor, int limit = 20) = 0;
+    virtual HistoryPage getDialoguePage(const QString& sessionId, const QString& cursor, int limit = 20) = 0;
+
+    // 按关键词全文检索历史查询与答案，默认最新的记录在前。
+    // 读取对话记录的方法遇到无法还原的记录时抛出 PayloadDecodeError，不返回空的结果
+    virtual QVector<QVariantMap> searchHistory(const QString& query, int limit = 20) = 0;
 };
 
 // SQLite实现类
@@ -51,14 +99,57 @@ public:
         const QString& intent_result,
         const QString& search_result,
         int turn_number) override;
+    bool addDialogueRecords(const QVector<DialogueRecord>& records) override;
     QVector<QPair<QString, QVariantMap>> getSessionHistory(int limit = 10) override;
     QVector<QVariantMap> getDialogueHistory(const QString& sessionId) override;
+    int getLastTurnNumber(const QString& sessionId) override;
+    HistoryPage getSessionPage(const QString& cursor, int limit = 20) override;
+    HistoryPage getDialoguePage(const QString& sessionId, const QString& cursor, int limit = 20) override;
+    QVector<QVariantMap> searchHistory(const QString& query, int limit = 20) override;
 
 private:
+    // 按 database 配置节设置 WAL、同步级别、mmap 与页缓存
+    void applyPragmas();
+
+    // 按 PRAGMA user_version 依次执行尚未应用的迁移，每个版本一个事务
+    bool migrate();
+
+    // 取得预编译的语句，同一 SQL 在本连接上只 prepare 一次；失败时返回 nullptr。
+    // 使用方以 bindValue 按位置绑定参数，读取完毕后调用 finish() 释放读快照
+    QSqlQuery* cachedQuery(const QString& sql);
+
+    bool tableExists(const QString& name);
+
+    // 为已有记录建立全文索引（迁移时执行）与写入单条记录的索引
+    bool rebuildHistoryIndex();
+    bool indexDialogueRecord(qint64 recordId, const DialogueRecord& record);
+
+    // search_result 与 intent_result 的压缩存储：写入时编码，读取时还原，兼容未压缩的旧值；
+    // 还原失败时记录行号并抛出 PayloadDecodeError
+    QVariant encodePayload(const QString& text);
+    QString decodePayload(const QVariant& value, qint64 recordId);
+
+    // 加载词典表中的全部词典并启用最新的一个
+    void loadDictionaries();
+    bool trainDictionary();
+    void trainDictionaryIfReady();
+    bool compressExistingPayloads();
+
     QSqlDatabase db;
+    QHash<QString, QSqlQuery> statementCache;  // SQL -> 预编译语句，随连接一同释放
+    bool historyIndexEnabled = false;          // 全文索引已建立（需要 SQLite 支持 FTS5）
+    bool rankHistoryByRelevance = false;       // 历史检索按 bm25 排序，默认按时间倒序
+    std::unique_ptr<PayloadCodec> payloadCodec;  // 本连接的压缩上下文与已加载的词典
+    bool compressPayloads = true;              // 关闭后新记录以原文保存，已压缩的记录仍可读取
+    size_t minCompressedSize = 128;            // 短于此长度的值不压缩
+    size_t dictionaryCapacity = 64 * 1024;     // 训练词典的最大字节数
+    int nextDictionaryTraining = 200;          // 记录数达到此值时训练词典
+    bool vacuumAfterMigration = false;         // 迁移改写了大量记录，完成后执行 VACUUM
     const QString DATABASE_NAME = "intellisearch.db";
     const QString SESSIONS_TABLE = "dialogue_sessions";
     const QString DIALOGUES_TABLE = "dialogue_records";
+    const QString HISTORY_FTS_TABLE = "dialogue_records_fts";
+    const QString DICTIONARIES_TABLE = "payload_dictionaries";
 };
 
 // 数据库管理器工厂
@@ -0,0 +1,215 @@
+#include "HistoryTokenizer.h"
+#include "../../log/Logger.h"
+#include "../../config/ConfigManager.h"
+#include "../../core/utils/TextUtils.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+namespace IntelliSearch {
+
+namespace {
+
+// 词典中超过此长度的词不参与匹配，限制最大匹配的回退次数
+constexpr size_t MAX_WORD_LENGTH = 16;
+
+bool isCjk(char32_t c) {
+    return (c >= 0x3040 && c <= 0x30FF)      // 平假名、片假名
+        || (c >= 0x3400 && c <= 0x4DBF)      // 扩展 A
+        || (c >= 0x4E00 && c <= 0x9FFF)      // 基本汉字
+        || (c >= 0xAC00 && c <= 0xD7AF)      // 韩文音节
+        || (c >= 0xF900 && c <= 0xFAFF)      // 兼容汉字
+        || (c >= 0x20000 && c <= 0x2FA1F);   // 扩展 B 及以后
+}
+
+bool isWordChar(char32_t c) {
+    if (c < 0x80) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+    return (c >= 0xC0 && c <= 0x24F && c != 0xD7 && c != 0xF7)   // 拉丁字母扩展
+        || (c >= 0x370 && c <= 0x52F);                           // 希腊、西里尔字母
+}
+
+// TextUtils 以码点数组表示文本，这里转为 u32string 以便作为词典的键；非法字节按 Latin-1 字符保留
+std::u32string decodeUtf8(const std::string& text) {
+    std::vector<uint32_t> codePoints = TextUtils::decodeUtf8(text);
+    return std::u32string(codePoints.begin(), codePoints.end());
+}
+
+std::string encodeUtf8(const std::u32string& text) {
+    std::string result;
+    result.reserve(text.size() * 3);
+    for (char32_t c : text) {
+        TextUtils::appendUtf8(result, c);
+    }
+    return result;
+}
+
+// 单字输出自身，两字及以上输出相邻二元组
+void appendGrams(const std::u32string& text, size_t begin, size_t end, std::vector<std::string>& out) {
+    if (end - begin == 1) {
+        out.push_back(encodeUtf8(text.substr(begin, 1)));
+        return;
+    }
+    for (size_t i = begin; i + 1 < end; ++i) {
+        out.push_back(encodeUtf8(text.substr(i, 2)));
+    }
+}
+
+std::string phrase(const std::vector<std::string>& tokens) {
+    return "\"" + HistoryTokenizer::join(tokens) + "\"";
+}
+
+} // namespace
+
+std::unique_ptr<HistoryTokenizer> HistoryTokenizer::instance = nullptr;
+std::mutex HistoryTokenizer::instanceMutex;
+
+HistoryTokenizer* HistoryTokenizer::getInstance() {
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    if (!instance) {
+        auto searchConfig = ConfigManager::getInstance()->getSectionConfig("database").value("history_search", nlohmann::json::object());
+        instance = std::make_unique<HistoryTokenizer>(searchConfig.value("dictionary_path", std::string()));
+    }
+    return instance.get();
+}
+
+/*
+ * Summary: 加载分词词典
+ * Parameters:
+ *   const std::string& dictionaryPath - 词典文件，每行取第一个空白分隔的字段（兼容 jieba 的 dict.txt）
+ * Description: 只保留两字及以上、且全部由汉字组成的词
+ */
+HistoryTokenizer::HistoryTokenizer(const std::string& dictionaryPath) {
+    if (dictionaryPath.empty()) {
+        return;
+    }
+    std::ifstream file(dictionaryPath);
+    if (!file) {
+        WARNLOG("Failed to open history search dictionary {}, falling back to bigrams", dictionaryPath);
+        return;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string word;
+        if (!(fields >> word)) {
+            continue;
+        }
+        std::u32string decoded = decodeUtf8(word);
+        if (decoded.size() < 2 || decoded.size() > MAX_WORD_LENGTH ||
+            !std::all_of(decoded.begin(), decoded.end(), isCjk)) {
+            continue;
+        }
+        maxWordLength = std::max(maxWordLength, decoded.size());
+        dictionary.insert(std::move(decoded));
+    }
+    INFOLOG("Loaded {} words from history search dictionary {}", dictionary.size(), dictionaryPath);
+}
+
+std::vector<HistoryTokenizer::Segment> HistoryTokenizer::split(const std::string& text) {
+    std::vector<Segment> segments;
+    for (char32_t c : decodeUtf8(text)) {
+        bool cjk = isCjk(c);
+        if (!cjk && !isWordChar(c)) {
+            // 分隔符结束当前段
+            if (!segments.empty() && !segments.back().text.empty()) {
+                segments.push_back({});
+            }
+            continue;
+        }
+        if (c < 0x80) {
+            c = static_cast<char32_t>(std::tolower(static_cast<int>(c)));
+        }
+        if (segments.empty() || (!segments.back().text.empty() && segments.back().cjk != cjk)) {
+            segments.push_back({});
+        }
+        segments.back().cjk = cjk;
+        segments.back().text.push_back(c);
+    }
+    if (!segments.empty() && segments.back().text.empty()) {
+        segments.pop_back();
+    }
+    return segments;
+}
+
+void HistoryTokenizer::segmentCjk(const std::u32string& run, std::vector<std::string>& out) const {
+    size_t uncovered = 0;
+    size_t i = 0;
+    while (i < run.size()) {
+        size_t matched = 0;
+        for (size_t length = std::min(maxWordLength, run.size() - i); length >= 2; --length) {
+            if (dictionary.count(run.substr(i, length))) {
+                matched = length;
+                break;
+            }
+        }
+        if (matched == 0) {
+            ++i;
+            continue;
+        }
+        if (uncovered < i) {
+            appendGrams(run, uncovered, i, out);
+        }
+        out.push_back(encodeUtf8(run.substr(i, matched)));
+        i += matched;
+        uncovered = i;
+    }
+    if (uncovered < run.size()) {
+        appendGrams(run, uncovered, run.size(), out);
+    }
+}
+
+HistoryTokens HistoryTokenizer::tokenize(const std::string& text) const {
+    HistoryTokens tokens;
+    for (const Segment& segment : split(text)) {
+        if (!segment.cjk) {
+            tokens.terms.push_back(encodeUtf8(segment.text));
+            continue;
+        }
+        segmentCjk(segment.text, tokens.terms);
+        appendGrams(segment.text, 0, segment.text.size(), tokens.grams);
+        if (segment.text.size() > 1) {
+            // 末字单独成词，单字查询以前缀匹配时能命中位于段尾的字
+            tokens.grams.push_back(encodeUtf8(segment.text.substr(segment.text.size() - 1)));
+        }
+    }
+    return tokens;
+}
+
+std::string HistoryTokenizer::buildMatchQuery(const std::string& query) const {
+    std::vector<std::string> clauses;
+    for (const Segment& segment : split(query)) {
+        if (!segment.cjk) {
+            clauses.push_back("terms : \"" + encodeUtf8(segment.text) + "\" *");
+        } else if (segment.text.size() == 1) {
+            clauses.push_back("grams : \"" + encodeUtf8(segment.text) + "\" *");
+        } else {
+            // 二元组短语保证子串命中；与词典切分结果一致的记录额外计分
+            std::vector<std::string> grams;
+            std::vector<std::string> terms;
+            appendGrams(segment.text, 0, segment.text.size(), grams);
+            segmentCjk(segment.text, terms);
+            clauses.push_back("(grams : " + phrase(grams) + " OR terms : " + phrase(terms) + ")");
+        }
+    }
+    std::string match;
+    for (const auto& clause : clauses) {
+        match += match.empty() ? clause : " AND " + clause;
+    }
+    return match;
+}
+
+std::string HistoryTokenizer::join(const std::vector<std::string>& tokens) {
+    std::string result;
+    for (const auto& token : tokens) {
+        if (!result.empty()) {
+            result.push_back(' ');
+        }
+        result += token;
+    }
+    return result;
+}
+
+} // namespace IntelliSearch
@@ -0,0 +1,67 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 对话历史全文检索的分词器。SQLite 自带的 unicode61 分词器把连续的汉字当作一个词，
+ *              无法按词检索中文；这里在写入与查询前先行切分，FTS5 表只需按空格拆分。
+ *              每段文本产生两列：terms 为词典正向最大匹配的结果，词典未覆盖的部分退化为二元组；
+ *              grams 为每段汉字的全部二元组加末字单字，保证任意子串都能被检索到
+ */
+
+#ifndef INTELLISEARCH_HISTORYTOKENIZER_H
+#define INTELLISEARCH_HISTORYTOKENIZER_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace IntelliSearch {
+
+// 一段文本的分词结果，各词以空格连接后写入 FTS5 表的对应列
+struct HistoryTokens {
+    std::vector<std::string> terms;
+    std::vector<std::string> grams;
+};
+
+class HistoryTokenizer {
+public:
+    // 按 database.history_search.dictionary_path 加载词典，各连接共用，加载后只读
+    static HistoryTokenizer* getInstance();
+
+    // dictionaryPath 为空或无法读取时只用二元组切分
+    explicit HistoryTokenizer(const std::string& dictionaryPath = "");
+
+    HistoryTokens tokenize(const std::string& text) const;
+
+    // 生成 FTS5 MATCH 表达式：各段之间为 AND，汉字段按二元组短语匹配（即子串匹配），
+    // 拉丁词按前缀匹配；没有可检索的内容时返回空串
+    std::string buildMatchQuery(const std::string& query) const;
+
+    size_t dictionarySize() const { return dictionary.size(); }
+
+    static std::string join(const std::vector<std::string>& tokens);
+
+private:
+    // 连续的汉字（含日文假名、韩文）或字母数字，按出现顺序排列
+    struct Segment {
+        std::u32string text;
+        bool cjk = false;
+    };
+
+    static std::vector<Segment> split(const std::string& text);
+
+    // 正向最大匹配，词典未覆盖的片段输出二元组
+    void segmentCjk(const std::u32string& run, std::vector<std::string>& out) const;
+
+    std::unordered_set<std::u32string> dictionary;
+    size_t maxWordLength = 1;
+
+    static std::unique_ptr<HistoryTokenizer> instance;
+    static std::mutex instanceMutex;
+};
+
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_HISTORYTOKENIZER_H
@@ -0,0 +1,167 @@
+#include "HistoryWriter.h"
+#include "../../log/Logger.h"
+#include "../../config/ConfigManager.h"
+#include <QCoreApplication>
+#include <QThread>
+#include <algorithm>
+#include <stdexcept>
+
+namespace IntelliSearch {
+
+HistoryWriter::HistoryWriter(HistoryWriterOptions options) : options(options) {
+    this->options.maxQueueLength = std::max<size_t>(1, this->options.maxQueueLength);
+    this->options.batchSize = std::max<size_t>(1, this->options.batchSize);
+
+    // 数据库连接只能在创建它的线程中使用，因此在写入线程内创建并等待其初始化完成
+    auto ready = std::make_shared<std::promise<void>>();
+    std::future<void> initialized = ready->get_future();
+    writerThread = std::thread(&HistoryWriter::run, this, ready);
+    try {
+        initialized.get();
+    } catch (...) {
+        writerThread.join();
+        throw;
+    }
+    INFOLOG("History writer started: batch {}, flush interval {} ms, queue limit {}",
+            this->options.batchSize, this->options.flushInterval.count(), this->options.maxQueueLength);
+}
+
+HistoryWriter::~HistoryWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    progress.notify_all();
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+}
+
+HistoryWriterOptions HistoryWriter::optionsFromConfig() {
+    auto writerConfig = ConfigManager::getInstance()->getSectionConfig("database").value("history_writer", nlohmann::json::object());
+    HistoryWriterOptions options;
+    options.maxQueueLength = writerConfig.value("max_queue_length", options.maxQueueLength);
+    options.batchSize = writerConfig.value("batch_size", options.batchSize);
+    options.flushInterval = std::chrono::milliseconds(
+        writerConfig.value("flush_interval_ms", static_cast<int>(options.flushInterval.count())));
+    return options;
+}
+
+/*
+ * Summary: 提交一条对话记录
+ * Parameters:
+ *   DialogueRecord record - 待写入的记录
+ *   Completion onDone - 所在批次提交或失败后在写入线程中调用，可为空
+ * Return: void
+ * Description: 正常情况下只加锁入队；队列已满说明磁盘明显落后，此时等待写入线程腾出空间，
+ *              而不是丢弃记录。在界面线程中调用时不等待，允许队列暂时超出上限，避免界面卡在磁盘写入上
+ */
+void HistoryWriter::enqueue(DialogueRecord record, Completion onDone) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (queue.size() >= options.maxQueueLength) {
+            auto* app = QCoreApplication::instance();
+            if (app && QThread::currentThread() == app->thread()) {
+                WARNLOG("History writer queue full ({} records), queueing beyond the limit on the UI thread",
+                        queue.size());
+            } else {
+                WARNLOG("History writer queue full ({} records), waiting for the writer", queue.size());
+                progress.wait(lock, [this]() { return queue.size() < options.maxQueueLength || stopping; });
+            }
+        }
+        queue.push_back({std::move(record), std::move(onDone), std::chrono::steady_clock::now()});
+        ++enqueuedCount;
+    }
+    workAvailable.notify_one();
+}
+
+void HistoryWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    uint64_t target = enqueuedCount;
+    if (writtenCount >= target) {
+        return;
+    }
+    flushTarget = std::max(flushTarget, target);
+    workAvailable.notify_one();
+    progress.wait(lock, [this, target]() { return writtenCount >= target; });
+}
+
+/*
+ * Summary: 写入线程主循环
+ * Parameters:
+ *   std::shared_ptr<std::promise<void>> ready - 数据库初始化结果
+ * Description: 攒够 batch_size、最早一条等待满 flush_interval、有人调用 flush 或正在关闭时，
+ *              取出至多 batch_size 条记录在一个事务中写入；关闭时写完队列后退出
+ */
+void HistoryWriter::run(std::shared_ptr<std::promise<void>> ready) {
+    std::unique_ptr<IDatabaseManager> dbManager;
+    try {
+        dbManager = DatabaseManagerFactory::createDatabaseManager();
+        if (!dbManager || !dbManager->initialize()) {
+            throw std::runtime_error("History writer database initialization failed");
+        }
+    } catch (...) {
+        ready->set_exception(std::current_exception());
+        return;
+    }
+    ready->set_value();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        if (queue.empty()) {
+            if (stopping) {
+                break;
+            }
+            workAvailable.wait(lock);
+            continue;
+        }
+
+        auto deadline = queue.front().enqueuedAt + options.flushInterval;
+        bool due = stopping || queue.size() >= options.batchSize || flushTarget > writtenCount ||
+                   std::chrono::steady_clock::now() >= deadline;
+        if (!due) {
+            workAvailable.wait_until(lock, deadline);
+            continue;
+        }
+
+        size_t count = std::min(queue.size(), options.batchSize);
+        std::vector<PendingRecord> batch;
+        batch.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            batch.push_back(std::move(queue.front()));
+            queue.pop_front();
+        }
+        progress.notify_all();  // 队列腾出空间
+
+        // 写入与回调在锁外执行，期间搜索线程可以继续入队
+        lock.unlock();
+        QVector<DialogueRecord> records;
+        records.reserve(static_cast<int>(count));
+        for (const auto& pending : batch) {
+            records.append(pending.record);
+        }
+        auto start = std::chrono::steady_clock::now();
+        bool success = dbManager->addDialogueRecords(records);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (success) {
+            DEBUGLOG("History writer committed {} records in {:.2f} ms", count, ms);
+        } else {
+            ERRORLOG("History writer failed to write {} records", count);
+        }
+        for (auto& pending : batch) {
+            if (pending.onDone) {
+                pending.onDone(success);
+            }
+        }
+        lock.lock();
+
+        writtenCount += count;
+        progress.notify_all();
+    }
+
+    lock.unlock();
+    DEBUGLOG("History writer drained, {} records written", writtenCount);
+}
+
+} // namespace IntelliSearch
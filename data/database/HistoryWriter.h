@@ -0,0 +1,77 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 对话历史的后台写入器。搜索完成后只把记录放入有界队列，由专用线程攒批写入：
+ *              队列达到 batch_size 或最早一条等待超过 flush_interval_ms 时，整批在一个事务中提交。
+ *              写入线程持有自己的数据库连接，析构时写完队列中的全部记录再退出
+ */
+
+#ifndef INTELLISEARCH_HISTORYWRITER_H
+#define INTELLISEARCH_HISTORYWRITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "DatabaseManager.h"
+
+namespace IntelliSearch {
+
+struct HistoryWriterOptions {
+    size_t maxQueueLength = 1024;                           // 队列满时 enqueue 等待写入线程腾出空间（界面线程除外）
+    size_t batchSize = 64;                                  // 攒够即提交
+    std::chrono::milliseconds flushInterval{200};           // 最早一条记录的最长等待时间
+};
+
+class HistoryWriter {
+public:
+    // 写入结果回调，在写入线程中执行
+    using Completion = std::function<void(bool success)>;
+
+    // 启动写入线程并在其中初始化数据库连接，初始化失败时抛出 std::runtime_error
+    explicit HistoryWriter(HistoryWriterOptions options = {});
+    ~HistoryWriter();
+
+    HistoryWriter(const HistoryWriter&) = delete;
+    HistoryWriter& operator=(const HistoryWriter&) = delete;
+
+    // 从 database.history_writer 配置节读取参数
+    static HistoryWriterOptions optionsFromConfig();
+
+    // 放入队列后立即返回，记录所在批次提交后调用 onDone
+    void enqueue(DialogueRecord record, Completion onDone = nullptr);
+
+    // 等待此前放入的记录全部写入（含失败）；会阻塞到事务提交，不要在界面线程中调用
+    void flush();
+
+private:
+    struct PendingRecord {
+        DialogueRecord record;
+        Completion onDone;
+        std::chrono::steady_clock::time_point enqueuedAt;
+    };
+
+    void run(std::shared_ptr<std::promise<void>> ready);
+
+    HistoryWriterOptions options;
+    std::mutex mutex;
+    std::condition_variable workAvailable;   // 写入线程等待新记录或刷新请求
+    std::condition_variable progress;        // 生产者等待队列空间或写入完成
+    std::deque<PendingRecord> queue;
+    uint64_t enqueuedCount = 0;              // 已放入队列的记录数
+    uint64_t writtenCount = 0;               // 已处理（提交或失败）的记录数
+    uint64_t flushTarget = 0;                // 写入线程需立即处理到的记录数
+    bool stopping = false;
+    std::thread writerThread;
+};
+
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_HISTORYWRITER_H
@@ -0,0 +1,133 @@
+#include "PayloadCodec.h"
+#include "../../log/Logger.h"
+#include <stdexcept>
+#include <zstd.h>
+#include <zdict.h>
+
+namespace IntelliSearch {
+
+namespace {
+
+// 解压后大小的上限，防止损坏的帧头导致超大分配
+constexpr unsigned long long MAX_PAYLOAD_SIZE = 256ull * 1024 * 1024;
+
+// 样本少于此数时训练出的词典几乎没有收益
+constexpr size_t MIN_TRAINING_SAMPLES = 16;
+
+} // namespace
+
+PayloadCodec::PayloadCodec(int compressionLevel)
+    : compressionLevel(compressionLevel),
+      compressionContext(ZSTD_createCCtx()),
+      decompressionContext(ZSTD_createDCtx()) {
+    if (!compressionContext || !decompressionContext) {
+        ZSTD_freeCCtx(compressionContext);
+        ZSTD_freeDCtx(decompressionContext);
+        throw std::runtime_error("Failed to create zstd contexts");
+    }
+}
+
+PayloadCodec::~PayloadCodec() {
+    for (auto& [id, dictionary] : dictionaries) {
+        ZSTD_freeCDict(dictionary.compression);
+        ZSTD_freeDDict(dictionary.decompression);
+    }
+    ZSTD_freeCCtx(compressionContext);
+    ZSTD_freeDCtx(decompressionContext);
+}
+
+uint32_t PayloadCodec::addDictionary(const std::string& dictionary) {
+    uint32_t id = ZDICT_getDictID(dictionary.data(), dictionary.size());
+    if (id == 0) {
+        WARNLOG("Ignoring invalid zstd dictionary ({} bytes)", dictionary.size());
+        return 0;
+    }
+    if (hasDictionary(id)) {
+        return id;
+    }
+    Dictionary entry;
+    entry.compression = ZSTD_createCDict(dictionary.data(), dictionary.size(), compressionLevel);
+    entry.decompression = ZSTD_createDDict(dictionary.data(), dictionary.size());
+    if (!entry.compression || !entry.decompression) {
+        ZSTD_freeCDict(entry.compression);
+        ZSTD_freeDDict(entry.decompression);
+        WARNLOG("Failed to load zstd dictionary {}", id);
+        return 0;
+    }
+    dictionaries[id] = entry;
+    return id;
+}
+
+void PayloadCodec::setActiveDictionary(uint32_t id) {
+    if (id != 0 && !hasDictionary(id)) {
+        throw std::runtime_error("Unknown zstd dictionary " + std::to_string(id));
+    }
+    activeId = id;
+}
+
+std::string PayloadCodec::compress(const std::string& text) {
+    std::string frame(ZSTD_compressBound(text.size()), '\0');
+    size_t written = activeId != 0
+        ? ZSTD_compress_usingCDict(compressionContext, frame.data(), frame.size(), text.data(), text.size(),
+                                   dictionaries[activeId].compression)
+        : ZSTD_compressCCtx(compressionContext, frame.data(), frame.size(), text.data(), text.size(),
+                            compressionLevel);
+    if (ZSTD_isError(written)) {
+        throw std::runtime_error(std::string("zstd compression failed: ") + ZSTD_getErrorName(written));
+    }
+    frame.resize(written);
+    return frame;
+}
+
+std::string PayloadCodec::decompress(const std::string& frame) {
+    unsigned long long size = ZSTD_getFrameContentSize(frame.data(), frame.size());
+    if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN || size > MAX_PAYLOAD_SIZE) {
+        throw std::runtime_error("Invalid zstd frame header");
+    }
+
+    uint32_t id = frameDictionaryId(frame);
+    auto dictionary = dictionaries.find(id);
+    if (id != 0 && dictionary == dictionaries.end()) {
+        throw std::runtime_error("Missing zstd dictionary " + std::to_string(id));
+    }
+
+    std::string text(static_cast<size_t>(size), '\0');
+    size_t read = id != 0
+        ? ZSTD_decompress_usingDDict(decompressionContext, text.data(), text.size(), frame.data(), frame.size(),
+                                     dictionary->second.decompression)
+        : ZSTD_decompressDCtx(decompressionContext, text.data(), text.size(), frame.data(), frame.size());
+    if (ZSTD_isError(read) || read != text.size()) {
+        throw std::runtime_error(std::string("zstd decompression failed: ") +
+                                 (ZSTD_isError(read) ? ZSTD_getErrorName(read) : "size mismatch"));
+    }
+    return text;
+}
+
+uint32_t PayloadCodec::frameDictionaryId(const std::string& frame) {
+    return ZSTD_getDictID_fromFrame(frame.data(), frame.size());
+}
+
+std::string PayloadCodec::trainDictionary(const std::vector<std::string>& samples, size_t capacity) {
+    if (samples.size() < MIN_TRAINING_SAMPLES) {
+        return std::string();
+    }
+    std::string buffer;
+    std::vector<size_t> sizes;
+    sizes.reserve(samples.size());
+    for (const auto& sample : samples) {
+        buffer += sample;
+        sizes.push_back(sample.size());
+    }
+
+    std::string dictionary(capacity, '\0');
+    size_t size = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), buffer.data(), sizes.data(),
+                                        static_cast<unsigned>(sizes.size()));
+    if (ZDICT_isError(size)) {
+        WARNLOG("zstd dictionary training failed: {}", ZDICT_getErrorName(size));
+        return std::string();
+    }
+    dictionary.resize(size);
+    return dictionary;
+}
+
+} // namespace IntelliSearch
@@ -0,0 +1,69 @@
+/*
+ * Author: Montee
+ * CreateDate: 2026-10-17
+ * UpdateDate: 2026-10-17
+ * Description: 对话记录中 search_result 与 intent_result 的压缩编码。搜索结果 JSON 的键名与模板化内容高度重复，
+ *              用从历史记录训练出的 zstd 词典压缩，单条记录也能获得接近整库压缩的比例。
+ *              压缩帧头带有词典编号，旧词典压缩的记录在更换词典后仍可解压。
+ *              持有压缩与解压上下文，不是线程安全的，每个数据库连接各持有一个实例
+ */
+
+#ifndef INTELLISEARCH_PAYLOADCODEC_H
+#define INTELLISEARCH_PAYLOADCODEC_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace IntelliSearch {
+
+class PayloadCodec {
+public:
+    explicit PayloadCodec(int compressionLevel = 3);
+    ~PayloadCodec();
+
+    PayloadCodec(const PayloadCodec&) = delete;
+    PayloadCodec& operator=(const PayloadCodec&) = delete;
+
+    // 登记词典并返回其编号，词典无效时返回 0；已登记的词典直接返回编号
+    uint32_t addDictionary(const std::string& dictionary);
+    bool hasDictionary(uint32_t id) const { return dictionaries.count(id) > 0; }
+
+    // 之后的 compress 使用该词典，0 表示不使用词典
+    void setActiveDictionary(uint32_t id);
+    uint32_t activeDictionary() const { return activeId; }
+
+    // 压缩为带内容长度与词典编号的 zstd 帧，失败时抛出 std::runtime_error
+    std::string compress(const std::string& text);
+
+    // 解压 compress 的输出，所需词典未登记或数据损坏时抛出 std::runtime_error
+    std::string decompress(const std::string& frame);
+
+    // 帧头中的词典编号，未使用词典时为 0
+    static uint32_t frameDictionaryId(const std::string& frame);
+
+    // 从样本训练词典，样本不足或训练失败时返回空串
+    static std::string trainDictionary(const std::vector<std::string>& samples, size_t capacity);
+
+private:
+    struct Dictionary {
+        ZSTD_CDict_s* compression = nullptr;
+        ZSTD_DDict_s* decompression = nullptr;
+    };
+
+    int compressionLevel;
+    ZSTD_CCtx_s* compressionContext = nullptr;
+    ZSTD_DCtx_s* decompressionContext = nullptr;
+    std::map<uint32_t, Dictionary> dictionaries;
+    uint32_t activeId = 0;
+};
+
+} // namespace IntelliSearch
+
+#endif // INTELLISEARCH_PAYLOADCODEC_H